@@ -0,0 +1,182 @@
+// =========================================================
+// FILE: src/xook/adaptive_cache_sizer.hpp
+// PURPOSE: Grow / shrink TreeCache capacity from ghost hits and store-read latency
+// CRITICAL: Capacity only; MemoryGovernor's byte budget still caps the cache
+// =========================================================
+
+#pragma once
+
+#include "tree_cache.hpp"
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace glofica::xook {
+
+/// @brief Bounds and thresholds for AdaptiveCacheSizer
+struct AdaptiveSizingConfig {
+    size_t min_capacity = 25'000;
+    size_t max_capacity = 400'000;
+
+    // Growth step as a fraction of capacity; the ghost list covers the same
+    // number of entries, so ghost hits measure exactly what one step would gain
+    double step = 0.25;
+
+    std::chrono::milliseconds interval{1000};
+
+    // Fraction of wall time spent on misses one growth step would avoid
+    // (ghost hits x mean store-read latency / interval)
+    double grow_threshold = 0.01;
+    double shrink_threshold = 0.001;
+
+    // Intervals without shrinking after a grow (damps oscillation at the knee)
+    unsigned shrink_cooldown = 4;
+
+    // Miss cost until the reader has recorded a read
+    uint64_t assumed_miss_ns = 20'000;
+};
+
+enum class SizingAction : uint8_t { Hold, Grow, Shrink };
+
+/// @brief One controller decision (the interval it was based on)
+struct SizingDecision {
+    SizingAction action = SizingAction::Hold;
+    size_t from = 0;
+    size_t to = 0;
+    uint64_t misses = 0;
+    uint64_t ghost_hits = 0;
+    uint64_t miss_ns = 0;          // Mean store-read latency used
+    double avoidable = 0.0;        // Fraction of the interval one step would save
+};
+
+/// @brief Cumulative controller state for AdapterStats
+struct SizingStats {
+    bool enabled = false;
+    uint64_t grows = 0;
+    uint64_t shrinks = 0;
+    uint64_t holds = 0;
+    SizingDecision last;
+};
+
+/// @brief Feedback controller for TreeCache capacity
+///
+/// Every `interval` (checked by tick(), which the writer calls after each
+/// commit) it compares the ghost hits of the last interval, priced at the
+/// mean store-read latency, with wall time: above grow_threshold the cache
+/// grows one step, below shrink_threshold (idle, or a working set that
+/// fits) it gives back half a step. Shrinking evicts into the ghost list,
+/// so a shrink that hurts shows up as ghost hits at the next tick.
+///
+/// One writer thread calls tick() and rebind(); stats() may be read from
+/// any thread (copied under stats_mutex_).
+class AdaptiveCacheSizer {
+private:
+    TreeCache* cache_;
+    const LatencyHistogram* store_reads_;
+    AdaptiveSizingConfig config_;
+    mutable std::mutex stats_mutex_;
+    SizingStats stats_;  // Guarded by stats_mutex_
+
+    std::optional<std::chrono::steady_clock::time_point> last_tick_;
+    CacheFeedback last_feedback_;
+    uint64_t last_reads_ = 0;
+    uint64_t last_read_ns_ = 0;
+    uint64_t miss_ns_;
+    unsigned cooldown_ = 0;
+
+    [[nodiscard]] size_t step_entries(size_t capacity) const noexcept {
+        return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(capacity) * config_.step));
+    }
+
+    void apply(size_t capacity) {
+        cache_->set_capacity(capacity);
+        cache_->set_ghost_capacity(step_entries(capacity));
+    }
+
+public:
+    /// @param store_reads Latency of TreeReader reads (cache misses); may be nullptr
+    AdaptiveCacheSizer(TreeCache* cache, const LatencyHistogram* store_reads, AdaptiveSizingConfig config = {})
+        : cache_(cache), store_reads_(store_reads), config_(config), miss_ns_(config.assumed_miss_ns) {
+        config_.max_capacity = std::max(config_.max_capacity, config_.min_capacity);
+        stats_.enabled = true;
+        rebind(cache);
+    }
+
+    /// @brief Follow a replaced cache (XookAdapter::install_cache); clamps it into bounds
+    void rebind(TreeCache* cache) {
+        cache_ = cache;
+        apply(std::clamp(cache_->capacity(), config_.min_capacity, config_.max_capacity));
+        last_tick_.reset();
+    }
+
+    /// @brief Decide once per interval; returns the decision when one was made
+    std::optional<SizingDecision> tick(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) {
+        CacheFeedback feedback = cache_->feedback();
+        uint64_t reads = 0, read_ns = 0;
+        if (store_reads_) {
+            HistogramSnapshot snap = store_reads_->snapshot();
+            reads = snap.count;
+            read_ns = snap.sum_ns;
+        }
+
+        // First tick, or counters reset (reset_stats, new cache): new baseline
+        if (!last_tick_ || feedback.misses < last_feedback_.misses || reads < last_reads_) {
+            last_tick_ = now;
+            last_feedback_ = feedback;
+            last_reads_ = reads;
+            last_read_ns_ = read_ns;
+            return std::nullopt;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - *last_tick_).count();
+        if (elapsed < std::chrono::duration_cast<std::chrono::nanoseconds>(config_.interval).count()) {
+            return std::nullopt;
+        }
+
+        SizingDecision d;
+        d.from = d.to = cache_->capacity();
+        d.misses = feedback.misses - last_feedback_.misses;
+        d.ghost_hits = feedback.ghost_hits - last_feedback_.ghost_hits;
+        if (reads > last_reads_) miss_ns_ = (read_ns - last_read_ns_) / (reads - last_reads_);
+        d.miss_ns = miss_ns_;
+        d.avoidable = static_cast<double>(d.ghost_hits) * static_cast<double>(d.miss_ns) / static_cast<double>(elapsed);
+
+        if (d.avoidable >= config_.grow_threshold && d.from < config_.max_capacity) {
+            d.action = SizingAction::Grow;
+            d.to = std::min(config_.max_capacity, d.from + step_entries(d.from));
+            cooldown_ = config_.shrink_cooldown;
+        } else if (d.avoidable < config_.shrink_threshold && d.from > config_.min_capacity && cooldown_ == 0) {
+            d.action = SizingAction::Shrink;
+            d.to = std::max(config_.min_capacity, d.from - step_entries(d.from) / 2);
+        } else if (cooldown_ > 0) {
+            --cooldown_;
+        }
+
+        if (d.to != d.from) apply(d.to);
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            switch (d.action) {
+                case SizingAction::Grow:   ++stats_.grows; break;
+                case SizingAction::Shrink: ++stats_.shrinks; break;
+                case SizingAction::Hold:   ++stats_.holds; break;
+            }
+            stats_.last = d;
+        }
+
+        last_tick_ = now;
+        last_feedback_ = cache_->feedback();  // Shrink evictions are not misses
+        last_reads_ = reads;
+        last_read_ns_ = read_ns;
+        return d;
+    }
+
+    [[nodiscard]] SizingStats stats() const {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return stats_;
+    }
+    [[nodiscard]] const AdaptiveSizingConfig& config() const noexcept { return config_; }
+};
+
+} // namespace glofica::xook
@@ -0,0 +1,96 @@
+// =========================================================
+// FILE: src/xook/block_arena.hpp
+// PURPOSE: Per-block monotonic arena for transient tree structures
+// CRITICAL: Everything allocated while processing one block is released
+//           with a single pointer reset, not one free() per node
+// =========================================================
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace glofica::xook {
+
+/// @brief Reusable monotonic arena: allocate freely during a block, reset() after
+///
+/// Backed by one retained buffer; overflow spills to `upstream` and is
+/// returned on reset(). The retained buffer grows to the previous block's
+/// high-water mark, so steady-state blocks never touch upstream at all.
+///
+/// Not thread-safe (one arena per executing block / thread).
+class BlockArena {
+private:
+    std::pmr::memory_resource* upstream_;
+    size_t capacity_;
+    void* buffer_;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> resource_;
+    size_t spilled_ = 0;
+
+    /// @brief Tracks spill-over to size the next block's buffer
+    class SpillCounter : public std::pmr::memory_resource {
+    public:
+        BlockArena* owner = nullptr;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            owner->spilled_ += bytes;
+            return owner->upstream_->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            owner->upstream_->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    SpillCounter spill_;
+
+    void rebuild() {
+        resource_ = std::make_unique<std::pmr::monotonic_buffer_resource>(buffer_, capacity_, &spill_);
+    }
+
+public:
+    /// @param initial_bytes Retained buffer size (grows to the high-water mark)
+    /// @param upstream Source for the buffer and overflow (e.g. a HugePageSlabResource)
+    explicit BlockArena(size_t initial_bytes = size_t{1} << 20,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream), capacity_(initial_bytes),
+          buffer_(upstream->allocate(initial_bytes, alignof(std::max_align_t))) {
+        spill_.owner = this;
+        rebuild();
+    }
+
+    ~BlockArena() {
+        resource_.reset();
+        upstream_->deallocate(buffer_, capacity_, alignof(std::max_align_t));
+    }
+
+    BlockArena(const BlockArena&) = delete;
+    BlockArena& operator=(const BlockArena&) = delete;
+
+    /// @brief Resource to hand to pmr containers / adapter entry points
+    [[nodiscard]] std::pmr::memory_resource* resource() noexcept { return resource_.get(); }
+
+    /// @brief Release everything allocated since the last reset (O(1) without spill)
+    /// CRITICAL: No object allocated from resource() may be used afterwards
+    void reset() {
+        if (spilled_ > 0) {
+            // Grow once so the next block of this size fits the retained buffer
+            resource_.reset();  // Returns spilled chunks upstream
+            upstream_->deallocate(buffer_, capacity_, alignof(std::max_align_t));
+            capacity_ += spilled_;
+            spilled_ = 0;
+            buffer_ = upstream_->allocate(capacity_, alignof(std::max_align_t));
+            rebuild();
+            return;
+        }
+        resource_->release();
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+};
+
+} // namespace glofica::xook
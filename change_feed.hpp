@@ -0,0 +1,303 @@
+// =========================================================
+// FILE: src/xook/change_feed.hpp
+// PURPOSE: Changed-key notifications per committed version (replaces polling get())
+// CRITICAL: Delivered on the writer thread after the head is published;
+//           callbacks must hand the batch off, not process it inline
+// =========================================================
+
+#pragma once
+
+#include "ordered_update_sets.hpp"
+#include "nibble_path.hpp"
+#include "../common/hash.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief (key hash, new value hash as get() returns it; zero hash = deleted)
+using ChangeEntry = HashedUpdates::value_type;
+
+/// @brief Every key a committed version changed; immutable once published
+struct ChangeBatch {
+    uint64_t version = 0;
+    glofica::Hash root{};
+    HashedUpdates entries;  // Sorted by key hash, one entry per key
+};
+
+/// @brief What a subscriber receives: views into one shared ChangeBatch (no copies)
+struct ChangeNotification {
+    std::shared_ptr<const ChangeBatch> batch;        // Holding it keeps `runs` valid
+    std::vector<std::span<const ChangeEntry>> runs;  // Matching entries: sorted, disjoint
+
+    [[nodiscard]] uint64_t version() const noexcept { return batch->version; }
+
+    [[nodiscard]] size_t size() const noexcept {
+        size_t n = 0;
+        for (const auto& run : runs) n += run.size();
+        return n;
+    }
+
+    template <typename F>
+    void for_each(F&& f) const {
+        for (const auto& run : runs) {
+            for (const auto& [key_hash, value_hash] : run) f(key_hash, value_hash);
+        }
+    }
+};
+
+/// @brief Which changed keys a subscriber wants
+///
+/// Keys are BLAKE3-512 hashed like XookAdapter keys, so a prefix filter is a
+/// key-hash prefix (one subtree, a contiguous run of the sorted batch), not a
+/// prefix of the raw key. Key sets are tested against a Bloom filter indexed
+/// by words of the key hash itself (already uniform, no rehashing) and hits
+/// are confirmed exactly: subscribers never see keys they did not ask for.
+class ChangeFilter {
+private:
+    friend class ChangeFeed;
+
+    struct Prefix {
+        glofica::Hash bytes{};
+        size_t nibbles = 0;
+    };
+
+    static constexpr size_t BLOOM_BITS_PER_KEY = 10;
+    static constexpr size_t BLOOM_PROBES = 7;  // ~1% false positives at 10 bits/key
+
+    bool all_ = false;
+    std::vector<Prefix> prefixes_;
+    std::vector<glofica::Hash> keys_;  // Sorted and unique after build()
+    std::vector<uint64_t> bloom_;
+    uint64_t bloom_mask_ = 0;
+
+    /// @brief Three-way compare of the first `prefix.nibbles` nibbles
+    static int compare_prefix(const glofica::Hash& key_hash, const Prefix& prefix) noexcept {
+        size_t full = prefix.nibbles / 2;
+        if (int c = std::memcmp(key_hash.data(), prefix.bytes.data(), full); c != 0) return c;
+        if (prefix.nibbles % 2 == 0) return 0;
+        return int(key_hash[full] >> 4) - int(prefix.bytes[full] >> 4);
+    }
+
+    [[nodiscard]] static uint64_t probe_word(const glofica::Hash& key_hash, size_t i) noexcept {
+        uint64_t word;
+        std::memcpy(&word, key_hash.data() + i * sizeof(word), sizeof(word));
+        return word;
+    }
+
+    [[nodiscard]] bool bloom_test(const glofica::Hash& key_hash) const noexcept {
+        for (size_t i = 0; i < BLOOM_PROBES; ++i) {
+            uint64_t bit = probe_word(key_hash, i) & bloom_mask_;
+            if (!(bloom_[bit / 64] & (uint64_t{1} << (bit % 64)))) return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool contains(const glofica::Hash& key_hash) const noexcept {
+        return bloom_test(key_hash) && std::binary_search(keys_.begin(), keys_.end(), key_hash);
+    }
+
+    /// @brief Freeze: sort the key set and size its Bloom filter (power of two bits)
+    void build() {
+        std::sort(keys_.begin(), keys_.end());
+        keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+        bloom_.clear();
+        if (keys_.empty()) return;
+
+        size_t bits = 64;
+        while (bits < keys_.size() * BLOOM_BITS_PER_KEY) bits <<= 1;
+        bloom_.assign(bits / 64, 0);
+        bloom_mask_ = bits - 1;
+        for (const auto& key_hash : keys_) {
+            for (size_t i = 0; i < BLOOM_PROBES; ++i) {
+                uint64_t bit = probe_word(key_hash, i) & bloom_mask_;
+                bloom_[bit / 64] |= uint64_t{1} << (bit % 64);
+            }
+        }
+    }
+
+    /// @brief Matching index ranges of `entries`, merged into sorted disjoint runs
+    void collect(const HashedUpdates& entries, std::vector<std::span<const ChangeEntry>>& runs) const {
+        if (all_) {
+            if (!entries.empty()) runs.emplace_back(entries);
+            return;
+        }
+        std::vector<std::pair<size_t, size_t>> ranges;
+        for (const auto& prefix : prefixes_) {
+            auto first = std::partition_point(entries.begin(), entries.end(),
+                                              [&](const ChangeEntry& e) { return compare_prefix(e.first, prefix) < 0; });
+            auto last = std::partition_point(first, entries.end(),
+                                             [&](const ChangeEntry& e) { return compare_prefix(e.first, prefix) == 0; });
+            if (first != last) ranges.emplace_back(first - entries.begin(), last - entries.begin());
+        }
+        if (!keys_.empty()) {
+            for (size_t i = 0; i < entries.size(); ++i) {
+                if (!contains(entries[i].first)) continue;
+                if (!ranges.empty() && ranges.back().second == i) ++ranges.back().second;
+                else ranges.emplace_back(i, i + 1);
+            }
+        }
+
+        // Prefixes may nest or overlap each other and the key hits
+        std::sort(ranges.begin(), ranges.end());
+        size_t merged = 0;
+        for (size_t i = 1; i < ranges.size(); ++i) {
+            if (ranges[i].first <= ranges[merged].second) {
+                ranges[merged].second = std::max(ranges[merged].second, ranges[i].second);
+            } else {
+                ranges[++merged] = ranges[i];
+            }
+        }
+        if (!ranges.empty()) ranges.resize(merged + 1);
+        for (const auto& [first, last] : ranges) runs.emplace_back(entries.data() + first, last - first);
+    }
+
+public:
+    /// @brief Every changed key
+    [[nodiscard]] static ChangeFilter all() {
+        ChangeFilter filter;
+        filter.all_ = true;
+        return filter;
+    }
+
+    /// @brief Keys whose hash starts with `key_hash_prefix` (one subtree)
+    ChangeFilter& add_prefix(const NibblePath& key_hash_prefix) {
+        if (key_hash_prefix.size() > 2 * sizeof(glofica::Hash)) {
+            throw std::invalid_argument("ChangeFilter: prefix longer than a key hash");
+        }
+        Prefix prefix;
+        prefix.nibbles = key_hash_prefix.size();
+        for (size_t i = 0; i < prefix.nibbles; ++i) {
+            uint8_t nibble = key_hash_prefix.get_nibble(i);
+            prefix.bytes[i / 2] |= (i % 2 == 0) ? uint8_t(nibble << 4) : nibble;
+        }
+        prefixes_.push_back(prefix);
+        return *this;
+    }
+
+    /// @brief One raw key (hashed with BLAKE3-512, as XookAdapter::put does)
+    ChangeFilter& add_key(const glofica::Bytes& key) {
+        return add_key_hash(hash::blake3(key));
+    }
+
+    ChangeFilter& add_key_hash(const glofica::Hash& key_hash) {
+        keys_.push_back(key_hash);
+        return *this;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return !all_ && prefixes_.empty() && keys_.empty(); }
+};
+
+/// @brief Cumulative ChangeFeed counters for AdapterStats
+struct ChangeFeedStats {
+    size_t subscribers = 0;
+    uint64_t batches = 0;        // Versions published while anyone was subscribed
+    uint64_t notifications = 0;  // Callbacks invoked (subscribers with a match)
+    uint64_t callback_errors = 0;
+};
+
+/// @brief Fan-out of committed ChangeBatches to filtered subscribers
+///
+/// subscribe() / unsubscribe() may be called from any thread; publish() is
+/// called by the writer. Subscribers are held copy-on-write, so publishing
+/// takes the mutex only to load the current list, and a callback may
+/// unsubscribe (itself or others). A delivery already in progress can still
+/// reach a subscriber that has just been removed.
+class ChangeFeed {
+public:
+    using Callback = std::function<void(const ChangeNotification&)>;
+
+private:
+    struct Subscriber {
+        uint64_t id;
+        ChangeFilter filter;
+        Callback callback;
+    };
+    using SubscriberList = std::vector<std::shared_ptr<const Subscriber>>;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<const SubscriberList> subscribers_ = std::make_shared<SubscriberList>();
+    std::atomic<size_t> count_{0};
+    uint64_t next_id_ = 1;
+
+    // Written by publish(), read by stats() from any thread
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> notifications_{0};
+    std::atomic<uint64_t> callback_errors_{0};
+
+public:
+    /// @brief Register `callback` for changes matching `filter`
+    /// @return Subscription id for unsubscribe()
+    /// @throws std::invalid_argument on an empty filter or callback
+    uint64_t subscribe(ChangeFilter filter, Callback callback) {
+        if (filter.empty() || !callback) {
+            throw std::invalid_argument("ChangeFeed: empty filter or callback");
+        }
+        filter.build();
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto next = std::make_shared<SubscriberList>(*subscribers_);
+        uint64_t id = next_id_++;
+        next->push_back(std::make_shared<const Subscriber>(Subscriber{id, std::move(filter), std::move(callback)}));
+        subscribers_ = std::move(next);
+        count_.store(subscribers_->size(), std::memory_order_release);
+        return id;
+    }
+
+    /// @return false if `id` is not subscribed
+    bool unsubscribe(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto next = std::make_shared<SubscriberList>(*subscribers_);
+        auto it = std::find_if(next->begin(), next->end(), [id](const auto& s) { return s->id == id; });
+        if (it == next->end()) return false;
+        next->erase(it);
+        subscribers_ = std::move(next);
+        count_.store(subscribers_->size(), std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Cheap check so the writer builds a ChangeBatch only when someone listens
+    [[nodiscard]] bool has_subscribers() const noexcept {
+        return count_.load(std::memory_order_acquire) != 0;
+    }
+
+    /// @brief Deliver `batch` to every subscriber with at least one matching key
+    /// A throwing callback is counted and skipped: the version is already committed.
+    void publish(const std::shared_ptr<const ChangeBatch>& batch) {
+        std::shared_ptr<const SubscriberList> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            subscribers = subscribers_;
+        }
+        batches_.fetch_add(1, std::memory_order_relaxed);
+
+        ChangeNotification notification;
+        notification.batch = batch;
+        for (const auto& subscriber : *subscribers) {
+            notification.runs.clear();
+            subscriber->filter.collect(batch->entries, notification.runs);
+            if (notification.runs.empty()) continue;
+            notifications_.fetch_add(1, std::memory_order_relaxed);
+            try {
+                subscriber->callback(notification);
+            } catch (...) {
+                callback_errors_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] ChangeFeedStats stats() const {
+        return {count_.load(std::memory_order_acquire), batches_.load(std::memory_order_relaxed),
+                notifications_.load(std::memory_order_relaxed), callback_errors_.load(std::memory_order_relaxed)};
+    }
+};
+
+} // namespace glofica::xook
@@ -0,0 +1,225 @@
+// =========================================================
+// FILE: src/xook/committed_node_index.hpp
+// PURPOSE: RCU-published hash index of committed nodes
+// CRITICAL: Readers take no locks and touch no shared atomics beyond the
+//           epoch pin; the single writer links / unlinks only the entries a
+//           commit changed and retires unlinked ones through EBR
+// =========================================================
+
+#pragma once
+
+#include "epoch_reclamation.hpp"
+#include "node_type.hpp"
+#include "node_type_hash.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Read-copy-update index over nodes of committed versions
+///
+/// Each shard is a chained hash table whose chains readers walk without
+/// locks. The single writer changes only what a commit touched: a new node
+/// is linked at the head of its bucket, a replaced or removed node is
+/// unlinked with one pointer store and retired through EBR, so a commit
+/// costs O(changes), not O(index size). A shard doubles its bucket array
+/// (copying its entries once) when it averages more than one entry per
+/// bucket; the old array and its entries are retired the same way.
+///
+/// Reads:  pin() -> find() -> use the `const Node*` while the guard lives.
+/// Writes: apply() from a single writer thread (the committing thread).
+class CommittedNodeIndex {
+public:
+    static constexpr size_t SHARDS = 64;
+    using Guard = EpochManager::Guard;
+
+private:
+    /// @brief Immutable except `next` (the writer relinks on removal)
+    struct Item {
+        NodeKey key;
+        std::shared_ptr<const Node> node;
+        std::atomic<const Item*> next{nullptr};
+    };
+
+    struct Table {
+        std::unique_ptr<std::atomic<const Item*>[]> buckets;
+        size_t mask = 0;
+        size_t count = 0;  // Writer only
+
+        explicit Table(size_t bucket_count)
+            : buckets(new std::atomic<const Item*>[bucket_count]), mask(bucket_count - 1) {
+            for (size_t i = 0; i < bucket_count; ++i) buckets[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        /// @brief Frees the items still linked (unlinked ones were retired separately)
+        ~Table() {
+            for (size_t i = 0; i <= mask; ++i) {
+                const Item* item = buckets[i].load(std::memory_order_relaxed);
+                while (item) {
+                    const Item* next = item->next.load(std::memory_order_relaxed);
+                    delete item;
+                    item = next;
+                }
+            }
+        }
+    };
+
+    static constexpr size_t INITIAL_BUCKETS = 16;
+
+    std::array<std::atomic<Table*>, SHARDS> shards_{};
+    mutable EpochManager epochs_;
+    std::atomic<size_t> size_{0};
+
+    [[nodiscard]] static size_t hash_key(const NodeKey& key) noexcept {
+        uint64_t h = std::hash<NodeKey>{}(key) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(h ^ (h >> 31));
+    }
+
+    [[nodiscard]] static size_t shard_of(size_t h) noexcept {
+        return (h >> 58) & (SHARDS - 1);
+    }
+
+    [[nodiscard]] static const Item* find_in(const Table* table, const NodeKey& key, size_t h) noexcept {
+        if (!table) return nullptr;
+        for (const Item* item = table->buckets[h & table->mask].load(std::memory_order_acquire); item;
+             item = item->next.load(std::memory_order_acquire)) {
+            if (item->key == key) return item;
+        }
+        return nullptr;
+    }
+
+    /// @brief Link of the item for `key` (bucket head or predecessor's next), or nullptr
+    [[nodiscard]] static std::atomic<const Item*>* link_of(Table& table, const NodeKey& key, size_t h) noexcept {
+        std::atomic<const Item*>* link = &table.buckets[h & table.mask];
+        for (const Item* item = link->load(std::memory_order_relaxed); item;
+             item = item->next.load(std::memory_order_relaxed)) {
+            if (item->key == key) return link;
+            link = const_cast<std::atomic<const Item*>*>(&item->next);
+        }
+        return nullptr;
+    }
+
+    /// @brief Writer's table for shard `s` (created on first use)
+    Table& writable(size_t s) {
+        Table* table = shards_[s].load(std::memory_order_relaxed);
+        if (!table) {
+            table = new Table(INITIAL_BUCKETS);
+            shards_[s].store(table, std::memory_order_release);
+        }
+        return *table;
+    }
+
+    void remove(size_t s, const NodeKey& key, size_t h) {
+        Table* table = shards_[s].load(std::memory_order_relaxed);
+        if (!table) return;
+        auto* link = link_of(*table, key, h);
+        if (!link) return;
+        const Item* item = link->load(std::memory_order_relaxed);
+        link->store(item->next.load(std::memory_order_relaxed), std::memory_order_release);
+        epochs_.retire(item);
+        --table->count;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void upsert(size_t s, const NodeKey& key, const std::shared_ptr<const Node>& node, size_t h) {
+        Table& table = writable(s);
+        auto* item = new Item{key, node, {}};
+        if (auto* link = link_of(table, key, h)) {
+            // Replace in place: the new item takes over the old one's successor
+            const Item* old = link->load(std::memory_order_relaxed);
+            item->next.store(old->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            link->store(item, std::memory_order_release);
+            epochs_.retire(old);
+            return;
+        }
+        auto& head = table.buckets[h & table.mask];
+        item->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        head.store(item, std::memory_order_release);
+        ++table.count;
+        size_.fetch_add(1, std::memory_order_relaxed);
+        if (table.count > table.mask + 1) grow(s);
+    }
+
+    /// @brief Double the bucket array: readers switch tables with one pointer load
+    void grow(size_t s) {
+        Table* old_table = shards_[s].load(std::memory_order_relaxed);
+        auto table = std::make_unique<Table>(2 * (old_table->mask + 1));
+        for (size_t i = 0; i <= old_table->mask; ++i) {
+            for (const Item* item = old_table->buckets[i].load(std::memory_order_relaxed); item;
+                 item = item->next.load(std::memory_order_relaxed)) {
+                auto& head = table->buckets[hash_key(item->key) & table->mask];
+                auto* copy = new Item{item->key, item->node, {}};
+                copy->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                head.store(copy, std::memory_order_relaxed);
+            }
+        }
+        table->count = old_table->count;
+        shards_[s].store(table.release(), std::memory_order_release);
+        epochs_.retire(old_table);  // With every item still linked in it
+    }
+
+public:
+    CommittedNodeIndex() {
+        for (auto& shard : shards_) shard.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~CommittedNodeIndex() {
+        for (auto& shard : shards_) delete shard.load(std::memory_order_relaxed);
+    }
+
+    CommittedNodeIndex(const CommittedNodeIndex&) = delete;
+    CommittedNodeIndex& operator=(const CommittedNodeIndex&) = delete;
+
+    /// @brief Pin the current epoch for a batch of find() calls
+    [[nodiscard]] Guard pin() const noexcept { return epochs_.pin(); }
+
+    /// @brief Lookup (caller holds a Guard from pin())
+    /// @return Borrowed node pointer, valid until the guard is released
+    [[nodiscard]] const Node* find(const NodeKey& key, const Guard&) const noexcept {
+        size_t h = hash_key(key);
+        const Item* item = find_in(shards_[shard_of(h)].load(std::memory_order_acquire), key, h);
+        return item ? item->node.get() : nullptr;
+    }
+
+    /// @brief Lookup returning an owning handle (one refcount increment)
+    [[nodiscard]] std::shared_ptr<const Node> find_shared(const NodeKey& key) const {
+        auto guard = pin();
+        size_t h = hash_key(key);
+        const Item* item = find_in(shards_[shard_of(h)].load(std::memory_order_acquire), key, h);
+        return item ? item->node : nullptr;
+    }
+
+    /// @brief Publish a set of changes (writer only); O(changes)
+    /// @param upserts Committed nodes to add (or replace)
+    /// @param removals Keys to drop (evicted from the owning cache)
+    void apply(const std::vector<std::pair<NodeKey, std::shared_ptr<const Node>>>& upserts,
+               const std::vector<NodeKey>& removals) {
+        if (upserts.empty() && removals.empty()) return;
+        // Removals first: a key evicted and re-inserted since ends up present
+        for (const auto& key : removals) {
+            size_t h = hash_key(key);
+            remove(shard_of(h), key, h);
+        }
+        for (const auto& [key, node] : upserts) {
+            size_t h = hash_key(key);
+            upsert(shard_of(h), key, node, h);
+        }
+        epochs_.reclaim();
+    }
+
+    /// @brief Drop every entry (writer only)
+    void clear() {
+        for (auto& shard : shards_) {
+            Table* old_table = shard.exchange(nullptr, std::memory_order_acq_rel);
+            if (old_table) epochs_.retire(old_table);
+        }
+        size_.store(0, std::memory_order_relaxed);
+        epochs_.reclaim();
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+};
+
+} // namespace glofica::xook
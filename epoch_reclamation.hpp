@@ -0,0 +1,179 @@
+// =========================================================
+// FILE: src/xook/epoch_reclamation.hpp
+// PURPOSE: Epoch-based reclamation (EBR) for lock-free readers
+// CRITICAL: Readers pin an epoch with one CAS + one store and never wait
+//           for the writer; the writer frees retired objects only once no
+//           pinned reader can still observe them
+// =========================================================
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Global-epoch EBR domain
+///
+/// Protocol:
+/// - Reader: pin() announces the current global epoch in a free slot, reads
+///   shared pointers, and the Guard clears the slot on destruction.
+/// - Writer: unlinks an object (atomic pointer swap), retire()s it with the
+///   current epoch, and reclaim() advances the epoch and frees everything
+///   retired before the oldest pinned epoch.
+///
+/// Guards may be long-lived (ReadSnapshot holds one for its lifetime); that
+/// only delays reclamation, it never blocks the writer.
+class EpochManager {
+public:
+    static constexpr size_t MAX_READERS = 256;  // Concurrent guards
+
+private:
+    static constexpr uint64_t QUIESCENT = 0;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{QUIESCENT};
+        std::atomic<bool> in_use{false};
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        void* object;
+        void (*deleter)(void*);
+    };
+
+    std::atomic<uint64_t> global_epoch_{1};
+    std::array<Slot, MAX_READERS> slots_{};
+
+    std::mutex retire_mutex_;  // Writer side only
+    std::vector<Retired> retired_;
+
+    [[nodiscard]] size_t acquire_slot() noexcept {
+        thread_local size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        for (;;) {
+            for (size_t i = 0; i < MAX_READERS; ++i) {
+                size_t idx = (hint + i) % MAX_READERS;
+                bool expected = false;
+                if (!slots_[idx].in_use.load(std::memory_order_relaxed) &&
+                    slots_[idx].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    hint = idx;
+                    return idx;
+                }
+            }
+            std::this_thread::yield();  // > MAX_READERS concurrent guards: wait for a reader, not the writer
+        }
+    }
+
+    [[nodiscard]] uint64_t min_pinned_epoch() const noexcept {
+        uint64_t min_epoch = global_epoch_.load(std::memory_order_seq_cst);
+        for (const auto& slot : slots_) {
+            uint64_t e = slot.epoch.load(std::memory_order_seq_cst);
+            if (e != QUIESCENT && e < min_epoch) min_epoch = e;
+        }
+        return min_epoch;
+    }
+
+public:
+    /// @brief RAII pin: shared objects read while alive are not freed
+    class Guard {
+    private:
+        EpochManager* manager_ = nullptr;
+        size_t slot_ = 0;
+
+    public:
+        Guard() = default;
+        Guard(EpochManager* manager, size_t slot) : manager_(manager), slot_(slot) {}
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        Guard(Guard&& other) noexcept : manager_(std::exchange(other.manager_, nullptr)), slot_(other.slot_) {}
+        Guard& operator=(Guard&& other) noexcept {
+            if (this != &other) {
+                release();
+                manager_ = std::exchange(other.manager_, nullptr);
+                slot_ = other.slot_;
+            }
+            return *this;
+        }
+
+        ~Guard() { release(); }
+
+        void release() noexcept {
+            if (!manager_) return;
+            auto& slot = manager_->slots_[slot_];
+            slot.epoch.store(QUIESCENT, std::memory_order_release);
+            slot.in_use.store(false, std::memory_order_release);
+            manager_ = nullptr;
+        }
+
+        [[nodiscard]] bool active() const noexcept { return manager_ != nullptr; }
+    };
+
+    EpochManager() = default;
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    ~EpochManager() {
+        // No guard may outlive the domain; free everything
+        for (auto& r : retired_) r.deleter(r.object);
+    }
+
+    /// @brief Pin the current epoch (lock-free unless > MAX_READERS guards are live)
+    [[nodiscard]] Guard pin() noexcept {
+        size_t idx = acquire_slot();
+        // seq_cst store orders the announcement before the caller's pointer loads
+        slots_[idx].epoch.store(global_epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        return Guard(this, idx);
+    }
+
+    /// @brief Defer deletion of an already-unlinked object
+    template <typename T>
+    void retire(const T* object) {
+        retire_raw(const_cast<T*>(object), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    void retire_raw(void* object, void (*deleter)(void*)) {
+        std::lock_guard<std::mutex> lock(retire_mutex_);
+        retired_.push_back({global_epoch_.load(std::memory_order_seq_cst), object, deleter});
+    }
+
+    /// @brief Advance the epoch and free objects no pinned reader can reach
+    /// @return Number of objects freed
+    size_t reclaim() {
+        global_epoch_.fetch_add(1, std::memory_order_seq_cst);
+        uint64_t safe_before = min_pinned_epoch();
+
+        std::vector<Retired> to_free;
+        {
+            std::lock_guard<std::mutex> lock(retire_mutex_);
+            auto keep = retired_.begin();
+            for (auto it = retired_.begin(); it != retired_.end(); ++it) {
+                if (it->epoch < safe_before) {
+                    to_free.push_back(*it);
+                } else {
+                    *keep++ = *it;
+                }
+            }
+            retired_.erase(keep, retired_.end());
+        }
+        for (auto& r : to_free) r.deleter(r.object);
+        return to_free.size();
+    }
+
+    [[nodiscard]] size_t pending_reclamation() {
+        std::lock_guard<std::mutex> lock(retire_mutex_);
+        return retired_.size();
+    }
+
+    [[nodiscard]] uint64_t epoch() const noexcept {
+        return global_epoch_.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace glofica::xook
@@ -0,0 +1,192 @@
+// =========================================================
+// FILE: src/xook/hasher_policy.hpp
+// PURPOSE: Compile-time node hash algorithm + digest width selection
+// CRITICAL: The production tree is Blake3_512 (64B). Changing the policy
+//           changes every root hash; FastBenchHasher is NOT cryptographic
+//           and must never back a consensus tree
+// =========================================================
+
+#pragma once
+
+#include "../common/hash.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace glofica::xook {
+
+/// Hasher policy concept (duck-typed):
+///   static constexpr size_t DIGEST_SIZE;
+///   using Digest = std::array<uint8_t, DIGEST_SIZE>;
+///   static Digest hash(const Bytes& data);
+///   static constexpr bool CRYPTOGRAPHIC;
+
+/// @brief BLAKE3 with 512-bit output (XOF) — the production policy
+struct Blake3_512 {
+    static constexpr size_t DIGEST_SIZE = 64;
+    static constexpr bool CRYPTOGRAPHIC = true;
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+    static_assert(std::is_same_v<Digest, glofica::Hash>, "Production digest must be glofica::Hash");
+
+    [[nodiscard]] static Digest hash(const Bytes& data) { return hash::blake3(data); }
+};
+
+/// @brief BLAKE3 with 256-bit output: half-size child records and leaves
+///
+/// BLAKE3's extendable output is prefix-consistent, so the first 32 bytes of
+/// the 512-bit output are exactly the standard 256-bit BLAKE3 digest.
+struct Blake3_256 {
+    static constexpr size_t DIGEST_SIZE = 32;
+    static constexpr bool CRYPTOGRAPHIC = true;
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    [[nodiscard]] static Digest hash(const Bytes& data) {
+        glofica::Hash full = hash::blake3(data);
+        Digest out;
+        std::copy(full.begin(), full.begin() + DIGEST_SIZE, out.begin());
+        return out;
+    }
+};
+
+namespace detail {
+
+[[nodiscard]] constexpr uint64_t rotl64(uint64_t x, int n) noexcept {
+    return (x << n) | (x >> (64 - n));
+}
+
+/// @brief Keccak-f[1600] permutation (FIPS 202)
+inline void keccak_f1600(uint64_t st[25]) noexcept {
+    static constexpr uint64_t RC[24] = {
+        0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+        0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+        0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+        0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+        0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+        0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+    static constexpr int ROTC[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+                                     27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+    static constexpr int PILN[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+                                     15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+    uint64_t bc[5];
+    for (int round = 0; round < 24; ++round) {
+        // Theta
+        for (int i = 0; i < 5; ++i) bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        for (int i = 0; i < 5; ++i) {
+            uint64_t t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) st[j + i] ^= t;
+        }
+        // Rho + Pi
+        uint64_t t = st[1];
+        for (int i = 0; i < 24; ++i) {
+            int j = PILN[i];
+            uint64_t tmp = st[j];
+            st[j] = rotl64(t, ROTC[i]);
+            t = tmp;
+        }
+        // Chi
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; ++i) bc[i] = st[j + i];
+            for (int i = 0; i < 5; ++i) st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+        }
+        // Iota
+        st[0] ^= RC[round];
+    }
+}
+
+[[nodiscard]] inline uint64_t load_le64(const uint8_t* p) noexcept {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+} // namespace detail
+
+/// @brief SHA3-512 (FIPS 202), self-contained Keccak: no extra dependency
+struct Sha3_512 {
+    static constexpr size_t DIGEST_SIZE = 64;
+    static constexpr bool CRYPTOGRAPHIC = true;
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    [[nodiscard]] static Digest hash(const Bytes& data) {
+        constexpr size_t RATE = 200 - 2 * DIGEST_SIZE;  // 72 bytes
+        uint64_t st[25] = {};
+
+        const uint8_t* p = data.data();
+        size_t len = data.size();
+        while (len >= RATE) {
+            for (size_t i = 0; i < RATE / 8; ++i) st[i] ^= detail::load_le64(p + 8 * i);
+            detail::keccak_f1600(st);
+            p += RATE;
+            len -= RATE;
+        }
+
+        // Final block: SHA3 domain bits 01 + pad10*1
+        uint8_t block[RATE] = {};
+        std::memcpy(block, p, len);
+        block[len] ^= 0x06;
+        block[RATE - 1] ^= 0x80;
+        for (size_t i = 0; i < RATE / 8; ++i) st[i] ^= detail::load_le64(block + 8 * i);
+        detail::keccak_f1600(st);
+
+        Digest out;
+        for (size_t i = 0; i < DIGEST_SIZE; ++i) out[i] = static_cast<uint8_t>(st[i / 8] >> (8 * (i % 8)));
+        return out;
+    }
+};
+
+/// @brief Fast non-cryptographic hasher — BENCHMARKS ONLY
+///
+/// Isolates tree/cache costs from hash costs in micro-benchmarks. Trivially
+/// forgeable: never use for a tree whose root is published or compared.
+template <size_t Width = 64>
+struct FastBenchHasher {
+    static constexpr size_t DIGEST_SIZE = Width;
+    static constexpr bool CRYPTOGRAPHIC = false;
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+    static_assert(Width % 8 == 0, "Digest width must be a multiple of 8");
+
+    [[nodiscard]] static uint64_t mix(uint64_t x) noexcept {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    [[nodiscard]] static Digest hash(const Bytes& data) {
+        uint64_t h = 0x9E3779B97F4A7C15ULL ^ data.size();
+        size_t i = 0;
+        for (; i + 8 <= data.size(); i += 8) h = mix(h ^ detail::load_le64(data.data() + i)) + i;
+        uint64_t tail = 0;
+        for (size_t k = 0; i + k < data.size(); ++k) tail |= static_cast<uint64_t>(data[i + k]) << (8 * k);
+        h = mix(h ^ tail);
+
+        Digest out;
+        for (size_t w = 0; w < DIGEST_SIZE / 8; ++w) {
+            uint64_t word = mix(h + w * 0x9E3779B97F4A7C15ULL);
+            for (size_t b = 0; b < 8; ++b) out[w * 8 + b] = static_cast<uint8_t>(word >> (8 * b));
+        }
+        return out;
+    }
+};
+
+/// @brief Serialized record sizes derived from a policy (compile-time)
+template <typename Hasher>
+struct NodeLayout {
+    static constexpr size_t DIGEST_SIZE = Hasher::DIGEST_SIZE;
+    static constexpr size_t CHILD_RECORD_SIZE = DIGEST_SIZE + 8;           // hash + version
+    static constexpr size_t LEAF_RECORD_SIZE = 2 * DIGEST_SIZE;            // key + value hash
+    static constexpr size_t LEAF_SERIALIZED_SIZE = 1 + LEAF_RECORD_SIZE;   // + type prefix
+    static constexpr size_t INTERNAL_HEADER_SIZE = 1 + 2;                  // type prefix + bitmap
+    static constexpr size_t MAX_INTERNAL_SERIALIZED_SIZE = INTERNAL_HEADER_SIZE + 16 * CHILD_RECORD_SIZE;
+};
+
+static_assert(NodeLayout<Blake3_512>::LEAF_SERIALIZED_SIZE == 129);
+static_assert(NodeLayout<Blake3_512>::CHILD_RECORD_SIZE == 72);
+static_assert(NodeLayout<Blake3_256>::LEAF_SERIALIZED_SIZE == 65);
+
+} // namespace glofica::xook
@@ -0,0 +1,92 @@
+// =========================================================
+// FILE: src/xook/l1_node_cache.hpp
+// PURPOSE: Per-thread, lock-free L1 in front of the shared TreeCache
+// CRITICAL: Upper tree levels are touched by every lookup; serving them
+//           thread-locally avoids the shared map + exclusive lock entirely
+// =========================================================
+
+#pragma once
+
+#include "node_type.hpp"
+#include "node_type_hash.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace glofica::xook {
+
+/// @brief Direct-mapped, thread-local node cache
+///
+/// One instance per thread (instance()), shared by every TreeCache that
+/// enables it: each slot is tagged with the owning cache's id and the
+/// owner's epoch at fill time. A slot is valid only while both still match,
+/// so bumping the owner's epoch invalidates all of that cache's L1 entries
+/// in every thread at once, without touching other threads' memory.
+///
+/// Slots hold NodeHandles: a hit is one hash, one key compare and a
+/// reference-count bump. Evicted nodes may stay alive here until their slot
+/// is reused (bounded by SLOTS per thread).
+class ThreadLocalNodeCache {
+public:
+    static constexpr size_t SLOTS = 4096;  // Power of two
+
+private:
+    struct Slot {
+        uint64_t owner = 0;  // 0 = empty (TreeCache ids start at 1)
+        uint64_t epoch = 0;
+        NodeKey key;
+        std::shared_ptr<const Node> node;
+    };
+
+    std::unique_ptr<std::array<Slot, SLOTS>> slots_ = std::make_unique<std::array<Slot, SLOTS>>();
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+
+    [[nodiscard]] static size_t slot_index(uint64_t owner, const NodeKey& key) noexcept {
+        uint64_t h = std::hash<NodeKey>{}(key) ^ (owner * 0x9E3779B97F4A7C15ULL);
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 32;
+        return static_cast<size_t>(h & (SLOTS - 1));
+    }
+
+public:
+    /// @brief The calling thread's L1 (heap-backed slots, ~256KB per thread)
+    [[nodiscard]] static ThreadLocalNodeCache& instance() {
+        thread_local ThreadLocalNodeCache cache;
+        return cache;
+    }
+
+    /// @brief Lookup; returns nullptr on miss or stale epoch
+    [[nodiscard]] std::shared_ptr<const Node> get(uint64_t owner, uint64_t epoch, const NodeKey& key) noexcept {
+        Slot& slot = (*slots_)[slot_index(owner, key)];
+        if (slot.owner == owner && slot.epoch == epoch && slot.key == key) {
+            ++hits_;
+            return slot.node;
+        }
+        ++misses_;
+        return nullptr;
+    }
+
+    /// @brief Fill (overwrites whatever the slot held)
+    void put(uint64_t owner, uint64_t epoch, const NodeKey& key, std::shared_ptr<const Node> node) {
+        Slot& slot = (*slots_)[slot_index(owner, key)];
+        slot.owner = owner;
+        slot.epoch = epoch;
+        slot.key = key;  // Reuses the slot's path storage once warm
+        slot.node = std::move(node);
+    }
+
+    /// @brief Drop every slot (releases pinned nodes on this thread)
+    void clear() noexcept {
+        for (auto& slot : *slots_) {
+            slot.owner = 0;
+            slot.node.reset();
+        }
+    }
+
+    [[nodiscard]] uint64_t hits() const noexcept { return hits_; }
+    [[nodiscard]] uint64_t misses() const noexcept { return misses_; }
+};
+
+} // namespace glofica::xook
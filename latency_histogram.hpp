@@ -0,0 +1,171 @@
+// =========================================================
+// FILE: src/xook/latency_histogram.hpp
+// PURPOSE: Lock-free HDR-style latency histograms
+// CRITICAL: Recording path is wait-free (one relaxed fetch_add per field)
+// =========================================================
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Immutable merged view of a LatencyHistogram
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;  // per bucket (see LatencyHistogram::bucket_lower_ns)
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+
+    [[nodiscard]] double mean_ns() const noexcept {
+        return count == 0 ? 0.0 : static_cast<double>(sum_ns) / static_cast<double>(count);
+    }
+
+    /// @brief Value at quantile q (0..1), reported as the bucket upper bound
+    [[nodiscard]] uint64_t percentile_ns(double q) const noexcept;
+};
+
+/// @brief Log-linear latency histogram (HDR layout), striped per thread
+///
+/// Bucket layout: values < 16ns are exact; above that every power of two is
+/// split into 16 linear sub-buckets, so relative error is <= 6.25%.
+/// Range: 0 .. 2^40 ns (~18 minutes); larger values saturate into the last bucket.
+///
+/// Each recording thread is mapped to one of STRIPES cache-line-aligned stripes
+/// (per-thread while threads <= STRIPES). Stripes are merged on snapshot().
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 4;
+    static constexpr uint64_t SUB_COUNT = 1ULL << SUB_BITS;            // 16
+    static constexpr unsigned MAX_EXPONENT = 40 - SUB_BITS;            // 36 groups above linear range
+    static constexpr size_t BUCKETS = SUB_COUNT + MAX_EXPONENT * SUB_COUNT;
+    static constexpr size_t STRIPES = 8;
+
+private:
+    struct alignas(64) Stripe {
+        std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+        std::atomic<uint64_t> sum_ns{0};
+        std::atomic<uint64_t> max_ns{0};
+    };
+
+    std::array<Stripe, STRIPES> stripes_{};
+
+    [[nodiscard]] static size_t thread_stripe() noexcept {
+        static std::atomic<size_t> next{0};
+        thread_local size_t stripe = next.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+        return stripe;
+    }
+
+public:
+    /// @brief Map a value in ns to its bucket index
+    [[nodiscard]] static constexpr size_t bucket_index(uint64_t ns) noexcept {
+        if (ns < SUB_COUNT) return static_cast<size_t>(ns);
+        unsigned exponent = static_cast<unsigned>(std::bit_width(ns)) - (SUB_BITS + 1);
+        if (exponent >= MAX_EXPONENT) return BUCKETS - 1;
+        uint64_t sub = (ns >> exponent) - SUB_COUNT;
+        return static_cast<size_t>(SUB_COUNT + exponent * SUB_COUNT + sub);
+    }
+
+    /// @brief Smallest value (ns) that maps to bucket idx
+    [[nodiscard]] static constexpr uint64_t bucket_lower_ns(size_t idx) noexcept {
+        if (idx < SUB_COUNT) return idx;
+        uint64_t exponent = (idx - SUB_COUNT) / SUB_COUNT;
+        uint64_t sub = (idx - SUB_COUNT) % SUB_COUNT;
+        return (SUB_COUNT + sub) << exponent;
+    }
+
+    /// @brief Largest value (ns) that maps to bucket idx
+    [[nodiscard]] static constexpr uint64_t bucket_upper_ns(size_t idx) noexcept {
+        if (idx < SUB_COUNT) return idx;
+        uint64_t exponent = (idx - SUB_COUNT) / SUB_COUNT;
+        return bucket_lower_ns(idx) + (1ULL << exponent) - 1;
+    }
+
+    /// @brief Record one sample (wait-free)
+    void record(uint64_t ns) noexcept {
+        Stripe& s = stripes_[thread_stripe()];
+        s.counts[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+        s.sum_ns.fetch_add(ns, std::memory_order_relaxed);
+
+        uint64_t prev = s.max_ns.load(std::memory_order_relaxed);
+        while (ns > prev && !s.max_ns.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// @brief Merge all stripes (concurrent recording may be partially visible)
+    [[nodiscard]] HistogramSnapshot snapshot() const {
+        HistogramSnapshot snap;
+        snap.counts.assign(BUCKETS, 0);
+        for (const auto& s : stripes_) {
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                uint64_t c = s.counts[i].load(std::memory_order_relaxed);
+                snap.counts[i] += c;
+                snap.count += c;
+            }
+            snap.sum_ns += s.sum_ns.load(std::memory_order_relaxed);
+            uint64_t m = s.max_ns.load(std::memory_order_relaxed);
+            if (m > snap.max_ns) snap.max_ns = m;
+        }
+        return snap;
+    }
+
+    /// @brief Reset all counters (not atomic with respect to concurrent record())
+    void reset() noexcept {
+        for (auto& s : stripes_) {
+            for (auto& c : s.counts) c.store(0, std::memory_order_relaxed);
+            s.sum_ns.store(0, std::memory_order_relaxed);
+            s.max_ns.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+inline uint64_t HistogramSnapshot::percentile_ns(double q) const noexcept {
+    if (count == 0) return 0;
+    if (q <= 0.0) q = 0.0;
+    if (q >= 1.0) return max_ns;
+
+    // Rank of the sample at quantile q (1-based, nearest-rank: ceil(q * n), at least 1);
+    // the relative slack keeps e.g. 0.07 * 100 = 7.000000000000001 at rank 7
+    double exact = q * static_cast<double>(count);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(exact - exact * 1e-12));
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t upper = LatencyHistogram::bucket_upper_ns(i);
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+/// @brief RAII timer recording elapsed steady-clock time into a histogram
+class LatencyTimer {
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    explicit LatencyTimer(LatencyHistogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+
+    ~LatencyTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        histogram_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+};
+
+} // namespace glofica::xook
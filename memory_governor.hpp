@@ -0,0 +1,212 @@
+// =========================================================
+// FILE: src/xook/memory_governor.hpp
+// PURPOSE: Unified memory budget for XOOK structures
+// CRITICAL: Keeps cache + speculative overlays + pending updates under EPC limit
+// =========================================================
+
+#pragma once
+
+#include "tree_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+namespace glofica::xook {
+
+/// @brief Snapshot of bytes held by each XOOK structure
+struct MemoryUsage {
+    size_t cache_bytes = 0;        // TreeCache (committed nodes)
+    size_t speculative_bytes = 0;  // SpeculativeTreeCache overlays (all live sessions)
+    size_t pending_bytes = 0;      // XookAdapter::pending_updates_
+
+    [[nodiscard]] size_t total() const noexcept {
+        return cache_bytes + speculative_bytes + pending_bytes;
+    }
+};
+
+/// @brief Single byte budget shared by TreeCache, speculative overlays and pending updates
+///
+/// Pressure policy (in order):
+/// 1. Shrink the shared TreeCache (cheapest: nodes can be re-read from the KVStore)
+///    down to a floor of `min_cache_bytes`.
+/// 2. Backpressure: new speculative sessions wait in admit_speculative() until the
+///    running sessions release their overlays. At least one session is always admitted,
+///    so a single oversized block still makes progress instead of deadlocking.
+///
+/// The host (e.g. an enclave EPC monitor) can force shrinking through shrink_handler().
+class MemoryGovernor {
+private:
+    std::atomic<TreeCache*> cache_;  // Swapped by set_cache() (XookAdapter::install_cache)
+    std::atomic<size_t> budget_bytes_;
+    std::atomic<size_t> min_cache_bytes_;
+
+    std::atomic<size_t> speculative_bytes_{0};
+    std::atomic<size_t> pending_bytes_{0};
+
+    // Speculative admission (backpressure)
+    std::mutex admit_mutex_;
+    std::condition_variable admit_cv_;
+    size_t active_sessions_ = 0;
+
+    std::atomic<uint64_t> cache_shrinks_{0};
+    std::atomic<uint64_t> backpressure_waits_{0};
+
+    [[nodiscard]] bool over_budget() const noexcept {
+        return usage().total() > budget_bytes_.load(std::memory_order_relaxed);
+    }
+
+public:
+    /// @brief RAII admission for one speculative session
+    ///
+    /// Overlay growth is charged through charge(); everything charged is
+    /// released when the lease is destroyed (overlay dropped).
+    class SpeculativeLease {
+    private:
+        MemoryGovernor* governor_ = nullptr;
+        size_t charged_ = 0;
+
+    public:
+        SpeculativeLease() = default;
+        explicit SpeculativeLease(MemoryGovernor* governor) : governor_(governor) {}
+
+        SpeculativeLease(const SpeculativeLease&) = delete;
+        SpeculativeLease& operator=(const SpeculativeLease&) = delete;
+
+        SpeculativeLease(SpeculativeLease&& other) noexcept
+            : governor_(other.governor_), charged_(other.charged_) {
+            other.governor_ = nullptr;
+            other.charged_ = 0;
+        }
+
+        ~SpeculativeLease() {
+            if (governor_) governor_->release_speculative(charged_);
+        }
+
+        /// @brief Account overlay growth; relieves pressure on the shared cache if needed
+        void charge(size_t bytes) {
+            if (!governor_) return;
+            charged_ += bytes;
+            governor_->speculative_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+            governor_->enforce();
+        }
+
+        [[nodiscard]] size_t charged() const noexcept { return charged_; }
+    };
+
+    /// @param cache Shared cache to shrink under pressure (not owned)
+    /// @param budget_bytes Total budget (default: unlimited)
+    explicit MemoryGovernor(TreeCache* cache,
+                            size_t budget_bytes = std::numeric_limits<size_t>::max())
+        : cache_(cache), budget_bytes_(budget_bytes), min_cache_bytes_(budget_bytes / 8) {}
+
+    MemoryGovernor(const MemoryGovernor&) = delete;
+    MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+    /// @brief Point at a replacement cache; budget, counters, charges and leases carry over
+    /// CRITICAL: Call before the old cache is destroyed
+    void set_cache(TreeCache* cache) noexcept {
+        cache_.store(cache, std::memory_order_release);
+    }
+
+    /// @brief Set total budget; the cache floor defaults to 1/8 of the budget
+    void set_budget(size_t budget_bytes) {
+        budget_bytes_.store(budget_bytes, std::memory_order_relaxed);
+        min_cache_bytes_.store(budget_bytes / 8, std::memory_order_relaxed);
+        enforce();
+        admit_cv_.notify_all();
+    }
+
+    /// @brief Cache bytes never reclaimed by automatic pressure (hot upper levels)
+    void set_min_cache_bytes(size_t bytes) noexcept {
+        min_cache_bytes_.store(bytes, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t budget() const noexcept { return budget_bytes_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] MemoryUsage usage() const noexcept {
+        MemoryUsage u;
+        TreeCache* cache = cache_.load(std::memory_order_acquire);
+        u.cache_bytes = cache ? cache->approx_bytes() : 0;
+        u.speculative_bytes = speculative_bytes_.load(std::memory_order_relaxed);
+        u.pending_bytes = pending_bytes_.load(std::memory_order_relaxed);
+        return u;
+    }
+
+    /// @brief Report the current size of XookAdapter::pending_updates_
+    void set_pending_bytes(size_t bytes) noexcept {
+        pending_bytes_.store(bytes, std::memory_order_relaxed);
+    }
+
+    /// @brief Shrink the cache until total usage fits the budget (step 1 of the policy)
+    /// @return Bytes released from the cache
+    size_t enforce() {
+        TreeCache* cache = cache_.load(std::memory_order_acquire);
+        if (!cache || !over_budget()) return 0;
+
+        MemoryUsage u = usage();
+        size_t budget = budget_bytes_.load(std::memory_order_relaxed);
+        size_t others = u.speculative_bytes + u.pending_bytes;
+        size_t target = budget > others ? budget - others : 0;
+        target = std::max(target, min_cache_bytes_.load(std::memory_order_relaxed));
+        if (u.cache_bytes <= target) return 0;
+
+        cache_shrinks_.fetch_add(1, std::memory_order_relaxed);
+        return cache->shrink_to_bytes(target);
+    }
+
+    /// @brief Admit a speculative session (step 2: blocks while over budget)
+    ///
+    /// Waits only while other sessions are active; their completion is the
+    /// only thing that can free speculative memory.
+    [[nodiscard]] SpeculativeLease admit_speculative() {
+        enforce();
+        std::unique_lock<std::mutex> lock(admit_mutex_);
+        if (active_sessions_ > 0 && over_budget()) {
+            backpressure_waits_.fetch_add(1, std::memory_order_relaxed);
+            admit_cv_.wait(lock, [this] { return active_sessions_ == 0 || !over_budget(); });
+        }
+        ++active_sessions_;
+        return SpeculativeLease(this);
+    }
+
+    /// @brief Host-triggered shrink: evict cache down to target_total_bytes of total usage
+    ///
+    /// Ignores the automatic cache floor, since the host knows better (e.g. EPC
+    /// paging already started). Returns bytes released.
+    size_t shrink(size_t target_total_bytes) {
+        TreeCache* cache = cache_.load(std::memory_order_acquire);
+        if (!cache) return 0;
+        MemoryUsage u = usage();
+        size_t others = u.speculative_bytes + u.pending_bytes;
+        size_t target = target_total_bytes > others ? target_total_bytes - others : 0;
+        cache_shrinks_.fetch_add(1, std::memory_order_relaxed);
+        size_t freed = cache->shrink_to_bytes(target);
+        admit_cv_.notify_all();
+        return freed;
+    }
+
+    /// @brief Callback for the host's memory-pressure hook
+    /// @return Callable taking a target total in bytes, returning bytes released
+    [[nodiscard]] std::function<size_t(size_t)> shrink_handler() {
+        return [this](size_t target_total_bytes) { return shrink(target_total_bytes); };
+    }
+
+    [[nodiscard]] uint64_t cache_shrinks() const noexcept { return cache_shrinks_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t backpressure_waits() const noexcept { return backpressure_waits_.load(std::memory_order_relaxed); }
+
+private:
+    void release_speculative(size_t bytes) {
+        speculative_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(admit_mutex_);
+            --active_sessions_;
+        }
+        admit_cv_.notify_all();
+    }
+};
+
+} // namespace glofica::xook
@@ -14,6 +14,8 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <memory>
+#include <memory_resource>
 
 namespace glofica::xook {
 
@@ -25,30 +27,44 @@ namespace glofica::xook {
 /// CRITICAL: This replaces std::vector<bool> which has non-deterministic
 /// iteration order. NibblePath guarantees identical serialization across
 /// all platforms and compilers.
-class NibblePath {
+///
+/// Allocator-aware: NibblePath uses the global heap, pmr::NibblePath takes a
+/// memory_resource (e.g. a per-block monotonic arena). Both encode, compare
+/// and hash identically.
+template <typename Allocator = std::allocator<uint8_t>>
+class BasicNibblePath {
 private:
-    std::vector<uint8_t> bytes_;  // Packed nibbles (2 per byte)
+    std::vector<uint8_t, Allocator> bytes_;  // Packed nibbles (2 per byte)
     size_t num_nibbles_;           // Actual number of nibbles
     
 public:
-    NibblePath() : num_nibbles_(0) {}
+    using allocator_type = Allocator;
+    
+    BasicNibblePath() : num_nibbles_(0) {}
+    
+    explicit BasicNibblePath(const Allocator& alloc) : bytes_(alloc), num_nibbles_(0) {}
+    
+    /// @brief Copy from a path with any allocator (also the uses-allocator copy constructor)
+    template <typename OtherAllocator>
+    BasicNibblePath(const BasicNibblePath<OtherAllocator>& other, const Allocator& alloc = Allocator())
+        : bytes_(other.bytes().begin(), other.bytes().end(), alloc), num_nibbles_(other.size()) {}
     
     /// @brief Construct from raw binary key
-    static NibblePath from_binary(const std::vector<uint8_t>& key) {
-        NibblePath path;
-        path.bytes_ = key;
+    static BasicNibblePath from_binary(const std::vector<uint8_t>& key) {
+        BasicNibblePath path;
+        path.bytes_.assign(key.begin(), key.end());
         path.num_nibbles_ = key.size() * 2;
         return path;
     }
 
     /// @brief Construct from packed bytes and nibble count
-    static NibblePath from_bytes(const std::vector<uint8_t>& bytes, size_t num_nibbles) {
-        NibblePath path;
+    static BasicNibblePath from_bytes(const std::vector<uint8_t>& bytes, size_t num_nibbles) {
+        BasicNibblePath path;
         size_t expected_size = (num_nibbles + 1) / 2;
         if (bytes.size() > expected_size) {
             path.bytes_.assign(bytes.begin(), bytes.begin() + expected_size);
         } else {
-            path.bytes_ = bytes;
+            path.bytes_.assign(bytes.begin(), bytes.end());
         }
         path.num_nibbles_ = num_nibbles;
         
@@ -109,10 +125,10 @@ public:
     [[nodiscard]] bool empty() const { return num_nibbles_ == 0; }
     
     /// @brief Get underlying bytes (for serialization)
-    [[nodiscard]] const std::vector<uint8_t>& bytes() const { return bytes_; }
+    [[nodiscard]] const std::vector<uint8_t, Allocator>& bytes() const { return bytes_; }
     
     /// @brief C++20 three-way comparison (deterministic ordering)
-    auto operator<=>(const NibblePath& other) const {
+    auto operator<=>(const BasicNibblePath& other) const {
         // 1. Compare length first
         if (auto cmp = num_nibbles_ <=> other.num_nibbles_; cmp != 0) {
             return cmp;
@@ -121,7 +137,14 @@ public:
         return bytes_ <=> other.bytes_;
     }
     
-    bool operator==(const NibblePath& other) const = default;
+    bool operator==(const BasicNibblePath& other) const = default;
+    
+    /// @brief Equality across allocators (heterogeneous cache lookups)
+    template <typename OtherAllocator>
+    [[nodiscard]] bool same_as(const BasicNibblePath<OtherAllocator>& other) const noexcept {
+        return num_nibbles_ == other.size() &&
+               std::equal(bytes_.begin(), bytes_.end(), other.bytes().begin(), other.bytes().end());
+    }
     
     /// @brief Convert to hex string (for debugging)
     [[nodiscard]] std::string to_hex() const {
@@ -133,4 +156,10 @@ public:
     }
 };
 
+using NibblePath = BasicNibblePath<>;
+
+namespace pmr {
+using NibblePath = BasicNibblePath<std::pmr::polymorphic_allocator<uint8_t>>;
+} // namespace pmr
+
 } // namespace glofica::xook
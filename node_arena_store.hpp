@@ -0,0 +1,309 @@
+// =========================================================
+// FILE: src/xook/node_arena_store.hpp
+// PURPOSE: Compact in-memory node store (test mode / in-process benchmarks)
+// CRITICAL: Serialized nodes live back-to-back in large arena chunks; the
+//           index holds views into the arena, so a stored node costs its
+//           bytes plus one hash-map entry, no per-node heap allocation
+// =========================================================
+
+#pragma once
+
+#include "node_serde.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Serialized-node store indexed by serialized NodeKey
+///
+/// Byte-level (put_raw/get_raw) so both tree flavours can use it: keys are
+/// NodeKey::serialize() output (8-byte LE version, then the path) and values
+/// are serialize_node_with_prefix() output, the same layout KVStore holds.
+///
+/// Optional pruning (enable_stale_tracking): a node written at (v, path)
+/// supersedes the previous node at the same path. prune(min_readable) drops
+/// nodes superseded at or before min_readable, and the arena is compacted
+/// once dead bytes outweigh live ones.
+/// CRITICAL: Pruning assumes a linear version history (no forks below
+/// min_readable). Orphans from deletions, which leave no successor at their
+/// path, are kept (never over-prunes).
+///
+/// Thread-safe: readers share a lock, writes/pruning are exclusive.
+class NodeArenaStore {
+public:
+    struct Stats {
+        size_t nodes = 0;
+        size_t live_bytes = 0;       // Keys + nodes reachable through the index
+        size_t arena_bytes = 0;      // Allocated chunk bytes (live + dead + slack)
+        size_t stale_pending = 0;    // Superseded nodes not yet pruned
+        uint64_t pruned_nodes = 0;
+        uint64_t compactions = 0;
+    };
+
+private:
+    struct Slot {
+        const uint8_t* node;
+        uint32_t node_size;
+    };
+
+    struct StaleEntry {
+        uint64_t superseded_at;
+        std::string_view key;
+    };
+
+    static constexpr size_t VERSION_BYTES = 8;
+
+    size_t chunk_bytes_;
+    std::vector<std::unique_ptr<uint8_t[]>> chunks_;
+    size_t chunk_used_ = 0;
+    size_t chunk_capacity_ = 0;
+    size_t arena_bytes_ = 0;
+    size_t live_bytes_ = 0;
+
+    // Views point into chunks_: valid until compact()
+    std::unordered_map<std::string_view, Slot> index_;
+
+    // Stale tracking: path (key minus version) → newest key at that path
+    bool track_stale_ = false;
+    std::unordered_map<std::string_view, std::string_view> latest_by_path_;
+    std::deque<StaleEntry> stale_;  // Ordered by superseded_at (commits are in order)
+    // Key bytes → position of its stale_ entry (at most one per key), offset by stale_popped_
+    std::unordered_map<const char*, uint64_t> stale_pos_;
+    uint64_t stale_popped_ = 0;
+
+    uint64_t pruned_nodes_ = 0;
+    uint64_t compactions_ = 0;
+    mutable std::shared_mutex mutex_;
+
+    [[nodiscard]] static uint64_t version_of(std::string_view key) {
+        uint64_t version = 0;
+        for (size_t i = 0; i < VERSION_BYTES && i < key.size(); ++i) {
+            version |= static_cast<uint64_t>(static_cast<uint8_t>(key[i])) << (i * 8);
+        }
+        return version;
+    }
+
+    [[nodiscard]] static std::string_view path_of(std::string_view key) {
+        return key.size() > VERSION_BYTES ? key.substr(VERSION_BYTES) : std::string_view();
+    }
+
+    /// @brief Bump-allocate `bytes` in the current chunk (oversized entries get their own)
+    uint8_t* allocate(size_t bytes) {
+        if (chunk_used_ + bytes > chunk_capacity_) {
+            size_t capacity = std::max(chunk_bytes_, bytes);
+            chunks_.push_back(std::make_unique<uint8_t[]>(capacity));
+            arena_bytes_ += capacity;
+            chunk_capacity_ = capacity;
+            chunk_used_ = 0;
+        }
+        uint8_t* p = chunks_.back().get() + chunk_used_;
+        chunk_used_ += bytes;
+        return p;
+    }
+
+    void push_stale_locked(uint64_t superseded_at, std::string_view key) {
+        stale_pos_.emplace(key.data(), stale_popped_ + stale_.size());
+        stale_.push_back({superseded_at, key});
+    }
+
+    void pop_stale_locked() {
+        stale_pos_.erase(stale_.front().key.data());
+        stale_.pop_front();
+        ++stale_popped_;
+    }
+
+    /// @brief Record that `key` replaces the previous node at its path
+    void note_write_locked(std::string_view key) {
+        std::string_view path = path_of(key);
+        auto it = latest_by_path_.find(path);
+        if (it != latest_by_path_.end()) {
+            uint64_t previous = version_of(it->second);
+            uint64_t current = version_of(key);
+            if (current < previous) return;  // Older write arriving late: it is the stale one
+            if (current > previous) push_stale_locked(current, it->second);
+            latest_by_path_.erase(it);
+        }
+        latest_by_path_.emplace(path_of(key), key);
+    }
+
+    void put_locked(const uint8_t* key, size_t key_size, const uint8_t* node, size_t node_size) {
+        uint8_t* p = allocate(key_size + node_size);
+        std::memcpy(p, key, key_size);
+        std::memcpy(p + key_size, node, node_size);
+        std::string_view key_view(reinterpret_cast<const char*>(p), key_size);
+        Slot slot{p + key_size, static_cast<uint32_t>(node_size)};
+
+        auto it = index_.find(key_view);
+        if (it != index_.end()) {
+            // Rewrite of the same key (idempotent persistence): old bytes become dead
+            live_bytes_ -= it->first.size() + it->second.node_size;
+            std::string_view old_key = it->first;
+            index_.erase(it);
+            if (track_stale_) {
+                auto latest = latest_by_path_.find(path_of(old_key));
+                if (latest != latest_by_path_.end() && latest->second.data() == old_key.data()) {
+                    latest_by_path_.erase(latest);
+                }
+                if (auto pos = stale_pos_.find(old_key.data()); pos != stale_pos_.end()) {
+                    uint64_t position = pos->second;
+                    stale_pos_.erase(pos);
+                    stale_[position - stale_popped_].key = key_view;
+                    stale_pos_.emplace(key_view.data(), position);
+                }
+            }
+        }
+        index_.emplace(key_view, slot);
+        live_bytes_ += key_size + node_size;
+        if (track_stale_) note_write_locked(key_view);
+    }
+
+    void put_raw_locked(const glofica::Bytes& key, const glofica::Bytes& node) {
+        put_locked(key.data(), key.size(), node.data(), node.size());
+    }
+
+    /// @brief Copy live entries into fresh chunks and rebuild every view
+    void compact_locked() {
+        std::vector<std::unique_ptr<uint8_t[]>> old_chunks = std::move(chunks_);
+        std::unordered_map<std::string_view, Slot> old_index = std::move(index_);
+        chunks_.clear();
+        index_.clear();
+        index_.reserve(old_index.size());
+        chunk_used_ = chunk_capacity_ = arena_bytes_ = live_bytes_ = 0;
+
+        std::unordered_map<const char*, std::string_view> moved;
+        if (track_stale_) moved.reserve(old_index.size());
+        for (const auto& [key, slot] : old_index) {
+            uint8_t* p = allocate(key.size() + slot.node_size);
+            std::memcpy(p, key.data(), key.size());
+            std::memcpy(p + key.size(), slot.node, slot.node_size);
+            std::string_view key_view(reinterpret_cast<const char*>(p), key.size());
+            index_.emplace(key_view, Slot{p + key.size(), slot.node_size});
+            live_bytes_ += key.size() + slot.node_size;
+            if (track_stale_) moved.emplace(key.data(), key_view);
+        }
+
+        if (track_stale_) {
+            std::unordered_map<std::string_view, std::string_view> latest;
+            latest.reserve(latest_by_path_.size());
+            for (const auto& [path, key] : latest_by_path_) {
+                if (auto it = moved.find(key.data()); it != moved.end()) latest.emplace(path_of(it->second), it->second);
+            }
+            latest_by_path_ = std::move(latest);
+
+            std::deque<StaleEntry> stale = std::move(stale_);
+            stale_.clear();
+            stale_pos_.clear();
+            stale_popped_ = 0;
+            for (const auto& entry : stale) {
+                if (auto it = moved.find(entry.key.data()); it != moved.end()) push_stale_locked(entry.superseded_at, it->second);
+            }
+        }
+        ++compactions_;
+    }
+
+public:
+    /// @param chunk_bytes Arena chunk size (entries larger than this get a dedicated chunk)
+    explicit NodeArenaStore(size_t chunk_bytes = size_t{4} << 20) : chunk_bytes_(chunk_bytes) {}
+
+    NodeArenaStore(const NodeArenaStore&) = delete;
+    NodeArenaStore& operator=(const NodeArenaStore&) = delete;
+
+    // ===== Byte-level API =====
+
+    void put_raw(const glofica::Bytes& key, const glofica::Bytes& node) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        put_raw_locked(key, node);
+    }
+
+    [[nodiscard]] std::optional<glofica::Bytes> get_raw(const glofica::Bytes& key) const {
+        std::string_view view(reinterpret_cast<const char*>(key.data()), key.size());
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = index_.find(view);
+        if (it == index_.end()) return std::nullopt;
+        return glofica::Bytes(it->second.node, it->second.node + it->second.node_size);
+    }
+
+    // ===== Typed API (XOOK nodes) =====
+
+    void put(const NodeKey& key, const Node& node) {
+        put_raw(key.serialize(), serialize_node_with_prefix(node));
+    }
+
+    /// @brief Store a commit's nodes under one lock (any range of {NodeKey, Node} pairs)
+    template <typename NodeBatch>
+    void put_batch(const NodeBatch& batch) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (const auto& [key, node] : batch) put_raw_locked(key.serialize(), serialize_node_with_prefix(node));
+    }
+
+    [[nodiscard]] std::optional<glofica::Bytes> get(const NodeKey& key) const {
+        return get_raw(key.serialize());
+    }
+
+    // ===== Pruning =====
+
+    /// @brief Start recording superseded nodes (indexes what is already stored)
+    void enable_stale_tracking() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (track_stale_) return;
+        track_stale_ = true;
+
+        // Existing keys in version order, so supersede records come out ordered
+        std::vector<std::string_view> keys;
+        keys.reserve(index_.size());
+        for (const auto& entry : index_) keys.push_back(entry.first);
+        std::sort(keys.begin(), keys.end(), [](std::string_view a, std::string_view b) {
+            return version_of(a) < version_of(b);
+        });
+        for (std::string_view key : keys) note_write_locked(key);
+    }
+
+    /// @brief Drop nodes superseded at or before `min_readable_version`
+    /// Versions >= min_readable_version stay fully readable.
+    /// @return Nodes removed
+    size_t prune(uint64_t min_readable_version) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        size_t removed = 0;
+        while (!stale_.empty() && stale_.front().superseded_at <= min_readable_version) {
+            auto it = index_.find(stale_.front().key);
+            if (it != index_.end() && it->first.data() == stale_.front().key.data()) {
+                live_bytes_ -= it->first.size() + it->second.node_size;
+                index_.erase(it);
+                ++removed;
+            }
+            pop_stale_locked();
+        }
+        pruned_nodes_ += removed;
+
+        // Compact once more than half the arena is dead
+        if (removed > 0 && arena_bytes_ > chunk_bytes_ && live_bytes_ < arena_bytes_ / 2) compact_locked();
+        return removed;
+    }
+
+    [[nodiscard]] Stats stats() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        Stats s;
+        s.nodes = index_.size();
+        s.live_bytes = live_bytes_;
+        s.arena_bytes = arena_bytes_;
+        s.stale_pending = stale_.size();
+        s.pruned_nodes = pruned_nodes_;
+        s.compactions = compactions_;
+        return s;
+    }
+
+    [[nodiscard]] size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return index_.size();
+    }
+};
+
+} // namespace glofica::xook
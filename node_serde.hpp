@@ -7,6 +7,7 @@
 #pragma once
 
 #include "node_type.hpp"
+#include <type_traits>
 
 namespace glofica::xook {
 
@@ -16,19 +17,47 @@ inline glofica::Bytes serialize_node_with_prefix(const Node& node) {
     
     if (std::holds_alternative<InternalNode>(node)) {
         result.push_back(0x01);  // Internal node marker
-        auto serialized = std::get<InternalNode>(node).serialize_canonical();
-        result.insert(result.end(), serialized.begin(), serialized.end());
+        std::get<InternalNode>(node).serialize_canonical_into(result);
     } else {
         result.push_back(0x02);  // Leaf node marker
-        auto serialized = std::get<LeafNode>(node).serialize_canonical();
-        result.insert(result.end(), serialized.begin(), serialized.end());
+        std::get<LeafNode>(node).serialize_canonical_into(result);
     }
     
     return result;
 }
 
+/// @brief Serialize a node of any hasher policy with type prefix
+template <typename Hasher, typename Allocator>
+inline glofica::Bytes serialize_node_with_prefix(const BasicNode<Hasher, Allocator>& node) {
+    glofica::Bytes result;
+    std::visit([&result](const auto& n) {
+        result.push_back(std::decay_t<decltype(n)>::TYPE_PREFIX);
+        n.serialize_canonical_into(result);
+    }, node);
+    return result;
+}
+
+/// @brief Serialize a node (any allocator) with type prefix into an arena buffer
+/// @return Buffer allocated from `resource` (released with the arena)
+template <typename NodeVariant>
+inline pmr::Bytes serialize_node_with_prefix(const NodeVariant& node, std::pmr::memory_resource* resource) {
+    pmr::Bytes result(resource);
+    std::visit([&result](const auto& n) {
+        result.push_back(std::decay_t<decltype(n)>::TYPE_PREFIX);  // Leaf / internal marker
+        n.serialize_canonical_into(result);
+    }, node);
+    return result;
+}
+
 /// @brief Deserialize node from bytes
-inline std::optional<Node> deserialize_node_from_bytes(const glofica::Bytes& bytes) {
+/// @tparam Hasher Policy the bytes were written with (record sizes follow its digest width)
+template <typename Hasher>
+inline std::optional<BasicNode<Hasher>> deserialize_node_from_bytes_as(const glofica::Bytes& bytes) {
+    using Layout = NodeLayout<Hasher>;
+    using Internal = BasicInternalNode<Hasher>;
+    using Leaf = BasicLeafNode<Hasher>;
+    constexpr size_t DIGEST_SIZE = Layout::DIGEST_SIZE;
+    
     if (bytes.empty()) {
         return std::nullopt;
     }
@@ -42,7 +71,7 @@ inline std::optional<Node> deserialize_node_from_bytes(const glofica::Bytes& byt
         size_t pos = 1; // Start after type byte
         
         // Deserialize InternalNode
-        InternalNode internal;
+        Internal internal;
         
         // Read bitmap (2 bytes, little-endian)
         uint16_t bitmap_mask = bytes[pos] | (bytes[pos + 1] << 8);
@@ -56,15 +85,15 @@ inline std::optional<Node> deserialize_node_from_bytes(const glofica::Bytes& byt
         internal.children.reserve(num_children);
         
         for (size_t i = 0; i < num_children; ++i) {
-            // Each child has 64 bytes (hash) + 8 bytes (version) = 72 bytes
-            if (pos + 72 > bytes.size()) {
+            // Each child has DIGEST_SIZE bytes (hash) + 8 bytes (version)
+            if (pos + Layout::CHILD_RECORD_SIZE > bytes.size()) {
                 return std::nullopt; // Truncated InternalNode data
             }
             
-            ChildInfo info;
-            // Read hash (64 bytes)
-            std::copy(bytes.begin() + pos, bytes.begin() + pos + 64, info.hash.begin());
-            pos += 64;
+            typename Internal::ChildInfo info;
+            // Read hash (DIGEST_SIZE bytes)
+            std::copy(bytes.begin() + pos, bytes.begin() + pos + DIGEST_SIZE, info.hash.begin());
+            pos += DIGEST_SIZE;
             
             // Read version (8 bytes, little-endian)
             info.version = 0;
@@ -86,18 +115,18 @@ inline std::optional<Node> deserialize_node_from_bytes(const glofica::Bytes& byt
     } else if (type == 0x02) {
         // Leaf node
         // CRITICAL FIX: Strict length check
-        if (bytes.size() != 129) return std::nullopt;  // Exact length: 1 + 64 + 64
+        if (bytes.size() != Layout::LEAF_SERIALIZED_SIZE) return std::nullopt;  // Exact length: 1 + 2×DIGEST_SIZE
         
-        LeafNode leaf;
+        Leaf leaf;
         
-        // Read account key (64 bytes)
+        // Read account key (DIGEST_SIZE bytes)
         std::copy(bytes.begin() + 1,
-                 bytes.begin() + 65,
+                 bytes.begin() + 1 + DIGEST_SIZE,
                  leaf.account_key.begin());
         
-        // Read value hash (64 bytes)
-        std::copy(bytes.begin() + 65,
-                 bytes.begin() + 129,
+        // Read value hash (DIGEST_SIZE bytes)
+        std::copy(bytes.begin() + 1 + DIGEST_SIZE,
+                 bytes.begin() + Layout::LEAF_SERIALIZED_SIZE,
                  leaf.value_hash.begin());
         
         return leaf;
@@ -106,4 +135,9 @@ inline std::optional<Node> deserialize_node_from_bytes(const glofica::Bytes& byt
     return std::nullopt;
 }
 
+/// @brief Deserialize a production (Blake3_512) node from bytes
+inline std::optional<Node> deserialize_node_from_bytes(const glofica::Bytes& bytes) {
+    return deserialize_node_from_bytes_as<Blake3_512>(bytes);
+}
+
 } // namespace glofica::xook
@@ -9,11 +9,13 @@
 
 #include "nibble_path.hpp"
 #include "sparse_bitmap.hpp"
+#include "hasher_policy.hpp"
 #include "../common/hash.hpp"
 #include <array>
 #include <optional>
 #include <variant>
 #include <vector>
+#include <memory_resource>
 #include <cstdint>
 #include <algorithm>
 
@@ -24,25 +26,45 @@ inline const std::string XOOK_INTERNAL_NODE_DOMAIN = "GLOFICA_InternalNode_V2_PQ
 inline const std::string XOOK_LEAF_NODE_DOMAIN     = "GLOFICA_LeafNode_V2_PQ";
 
 /// @brief Information about a child node (hash + version)
-struct ChildInfo {
-    Hash hash;
+template <typename Digest>
+struct BasicChildInfo {
+    Digest hash;
     uint64_t version;
 };
 
+using ChildInfo = BasicChildInfo<Hash>;
+
 /// @brief Internal node in XOOK Merkle Tree
 /// 
 /// Quantum-Safe Version: Uses 64-byte hashes for full 256-bit security 
 /// against quantum collision attacks.
-struct InternalNode {
+///
+/// Allocator-aware: InternalNode uses the global heap, pmr::InternalNode
+/// keeps its child array in a memory_resource. Serialization and hashes are
+/// identical for both.
+///
+/// Hasher-parameterized: digest width and algorithm are compile-time
+/// (hasher_policy.hpp). The default Blake3_512 is the production format.
+template <typename Hasher = Blake3_512,
+          typename Allocator = std::allocator<BasicChildInfo<typename Hasher::Digest>>>
+struct BasicInternalNode {
+    using hasher_type = Hasher;
+    using Digest = typename Hasher::Digest;
+    using ChildInfo = BasicChildInfo<Digest>;
+    using ChildVector = std::vector<ChildInfo, Allocator>;
+    
+    static constexpr uint8_t TYPE_PREFIX = 0x01;
+    static constexpr size_t CHILD_RECORD_SIZE = NodeLayout<Hasher>::CHILD_RECORD_SIZE;
+    
     SparseBitmap bitmap;
-    std::vector<ChildInfo> children;
+    ChildVector children;
     
     [[nodiscard]] std::optional<ChildInfo> get_child(uint8_t nibble) const {
         if (!bitmap.exists(nibble)) return std::nullopt;
         return children[bitmap.get_index(nibble)];
     }
     
-    void set_child(uint8_t nibble, const Hash& hash, uint64_t version) {
+    void set_child(uint8_t nibble, const Digest& hash, uint64_t version) {
         ChildInfo info{hash, version};
         if (!bitmap.exists(nibble)) {
             bitmap.set(nibble);
@@ -57,11 +79,18 @@ struct InternalNode {
     /// @brief Canonical serialization for Quantum-Safe nodes
     /// Format:
     /// - 2 bytes: bitmap
-    /// - N×(64+8) bytes: (hash + version)
+    /// - N×(DIGEST_SIZE+8) bytes: (hash + version)
     [[nodiscard]] Bytes serialize_canonical() const {
         Bytes buffer;
-        const size_t CHILD_RECORD_SIZE = 64 + 8;
-        buffer.reserve(2 + children.size() * CHILD_RECORD_SIZE);
+        serialize_canonical_into(buffer);
+        return buffer;
+    }
+    
+    /// @brief Append canonical serialization to an existing buffer (no temporary)
+    /// @tparam Buffer Byte vector with any allocator (Bytes, pmr::Bytes)
+    template <typename Buffer>
+    void serialize_canonical_into(Buffer& buffer) const {
+        buffer.reserve(buffer.size() + 2 + children.size() * CHILD_RECORD_SIZE);
         
         uint16_t mask = bitmap.raw_mask();
         buffer.push_back(static_cast<uint8_t>(mask & 0xFF));
@@ -73,57 +102,84 @@ struct InternalNode {
                 buffer.push_back(static_cast<uint8_t>((child.version >> (i * 8)) & 0xFF));
             }
         }
-        return buffer;
     }
     
-    [[nodiscard]] Hash hash() const {
-        Bytes final_buffer;
-        final_buffer.reserve(XOOK_INTERNAL_NODE_DOMAIN.size() + 2 + children.size() * 72);
+    /// @brief Domain-separated hash
+    /// PERF: Serializes straight into a per-thread scratch buffer; zero heap
+    /// allocations per call once the buffer has grown to a full node.
+    [[nodiscard]] Digest hash() const {
+        thread_local Bytes final_buffer;
+        final_buffer.clear();
         final_buffer.insert(final_buffer.end(), XOOK_INTERNAL_NODE_DOMAIN.begin(), XOOK_INTERNAL_NODE_DOMAIN.end());
-        auto serialized = serialize_canonical();
-        final_buffer.insert(final_buffer.end(), serialized.begin(), serialized.end());
-        return hash::blake3(final_buffer);
+        serialize_canonical_into(final_buffer);
+        return Hasher::hash(final_buffer);
     }
     
     [[nodiscard]] bool is_empty() const { return bitmap.empty(); }
     [[nodiscard]] size_t child_count() const { return bitmap.total_children(); }
 };
 
-/// @brief Leaf node in Quantum-Safe XOOK
-struct LeafNode {
-    Hash account_key;
-    Hash value_hash;
+/// @brief Leaf node in Quantum-Safe XOOK (key/value hash width follows Hasher)
+template <typename Hasher = Blake3_512>
+struct BasicLeafNode {
+    using hasher_type = Hasher;
+    using Digest = typename Hasher::Digest;
+    
+    static constexpr uint8_t TYPE_PREFIX = 0x02;
+    static constexpr size_t RECORD_SIZE = NodeLayout<Hasher>::LEAF_RECORD_SIZE;
+    
+    Digest account_key;
+    Digest value_hash;
     
     [[nodiscard]] Bytes serialize_canonical() const {
         Bytes buffer;
-        buffer.reserve(128); // 64 + 64
+        serialize_canonical_into(buffer);
+        return buffer;
+    }
+    
+    /// @brief Append canonical serialization to an existing buffer (no temporary)
+    template <typename Buffer>
+    void serialize_canonical_into(Buffer& buffer) const {
+        buffer.reserve(buffer.size() + RECORD_SIZE);
         buffer.insert(buffer.end(), account_key.begin(), account_key.end());
         buffer.insert(buffer.end(), value_hash.begin(), value_hash.end());
-        return buffer;
     }
     
-    [[nodiscard]] Hash hash() const {
-        Bytes final_buffer;
-        final_buffer.reserve(XOOK_LEAF_NODE_DOMAIN.size() + 128);
+    /// @brief Domain-separated hash (per-thread scratch buffer, no allocation)
+    [[nodiscard]] Digest hash() const {
+        thread_local Bytes final_buffer;
+        final_buffer.clear();
         final_buffer.insert(final_buffer.end(), XOOK_LEAF_NODE_DOMAIN.begin(), XOOK_LEAF_NODE_DOMAIN.end());
-        auto serialized = serialize_canonical();
-        final_buffer.insert(final_buffer.end(), serialized.begin(), serialized.end());
-        return hash::blake3(final_buffer);
+        serialize_canonical_into(final_buffer);
+        return Hasher::hash(final_buffer);
     }
 };
 
-using Node = std::variant<InternalNode, LeafNode>;
+template <typename Hasher = Blake3_512,
+          typename Allocator = std::allocator<BasicChildInfo<typename Hasher::Digest>>>
+using BasicNode = std::variant<BasicInternalNode<Hasher, Allocator>, BasicLeafNode<Hasher>>;
+
+using InternalNode = BasicInternalNode<>;
+using LeafNode = BasicLeafNode<>;
+using Node = BasicNode<>;
+
+/// @brief Half-width tree (BLAKE3-256): 40-byte child records, 65-byte leaves
+using InternalNode256 = BasicInternalNode<Blake3_256>;
+using LeafNode256 = BasicLeafNode<Blake3_256>;
+using Node256 = BasicNode<Blake3_256>;
 
-struct NodeKey {
+/// @brief Versioned node address (allocator follows the path's)
+template <typename PathAllocator = std::allocator<uint8_t>>
+struct BasicNodeKey {
     uint64_t version;
-    NibblePath nibble_path;
+    BasicNibblePath<PathAllocator> nibble_path;
     
-    auto operator<=>(const NodeKey& other) const {
+    auto operator<=>(const BasicNodeKey& other) const {
         if (auto cmp = version <=> other.version; cmp != 0) return cmp;
         return nibble_path <=> other.nibble_path;
     }
     
-    bool operator==(const NodeKey& other) const = default;
+    bool operator==(const BasicNodeKey& other) const = default;
 
     [[nodiscard]] Bytes serialize() const {
         Bytes res;
@@ -136,20 +192,59 @@ struct NodeKey {
         return res;
     }
 
-    static std::optional<NodeKey> deserialize(const Bytes& bytes) {
+    static std::optional<BasicNodeKey> deserialize(const Bytes& bytes) {
         if (bytes.size() < 12) return std::nullopt;
-        NodeKey res;
+        BasicNodeKey res;
         res.version = 0;
         for(int m=0; m<8; m++) res.version |= static_cast<uint64_t>(bytes[m]) << (m*8);
         size_t len = 0;
         for(int m=0; m<4; m++) len |= static_cast<size_t>(bytes[8+m]) << (m*8);
         if (bytes.size() < 12 + (len + 1) / 2) return std::nullopt;
         Bytes path_bytes(bytes.begin() + 12, bytes.end());
-        res.nibble_path = NibblePath::from_bytes(path_bytes, len);
+        res.nibble_path = BasicNibblePath<PathAllocator>::from_bytes(path_bytes, len);
         return res;
     }
 };
 
+using NodeKey = BasicNodeKey<>;
+
+/// @brief Allocator-aware variants for per-block arenas
+///
+/// Everything reachable from a pmr value (path bytes, child arrays, buffers)
+/// lives in the memory_resource it was created with, so a monotonic resource
+/// releases a whole block's worth of transient nodes in O(1). Moves keep the
+/// source's resource; use to_pmr()/to_std() to cross between heaps.
+namespace pmr {
+using Bytes = std::pmr::vector<uint8_t>;
+using InternalNode = BasicInternalNode<Blake3_512, std::pmr::polymorphic_allocator<ChildInfo>>;
+using Node = std::variant<InternalNode, LeafNode>;
+using NodeKey = BasicNodeKey<std::pmr::polymorphic_allocator<uint8_t>>;
+} // namespace pmr
+
+[[nodiscard]] inline pmr::NodeKey to_pmr(const NodeKey& key, std::pmr::memory_resource* resource) {
+    return pmr::NodeKey{key.version, pmr::NibblePath(key.nibble_path, resource)};
+}
+
+[[nodiscard]] inline pmr::Node to_pmr(const Node& node, std::pmr::memory_resource* resource) {
+    if (const auto* internal = std::get_if<InternalNode>(&node)) {
+        pmr::InternalNode copy{internal->bitmap, pmr::InternalNode::ChildVector(
+            internal->children.begin(), internal->children.end(), resource)};
+        return copy;
+    }
+    return std::get<LeafNode>(node);
+}
+
+[[nodiscard]] inline NodeKey to_std(const pmr::NodeKey& key) {
+    return NodeKey{key.version, NibblePath(key.nibble_path)};
+}
+
+[[nodiscard]] inline Node to_std(const pmr::Node& node) {
+    if (const auto* internal = std::get_if<pmr::InternalNode>(&node)) {
+        return InternalNode{internal->bitmap, {internal->children.begin(), internal->children.end()}};
+    }
+    return std::get<LeafNode>(node);
+}
+
 [[nodiscard]] inline Bytes serialize_node(const Node& node) {
     if (std::holds_alternative<InternalNode>(node)) {
         return std::get<InternalNode>(node).serialize_canonical();
@@ -166,4 +261,11 @@ struct NodeKey {
     }
 }
 
+namespace pmr {
+/// @brief hash_node() for arena nodes (separate namespace: no LeafNode ambiguity)
+[[nodiscard]] inline Hash hash_node(const Node& node) {
+    return std::visit([](const auto& n) { return n.hash(); }, node);
+}
+} // namespace pmr
+
 } // namespace glofica::xook
@@ -1,6 +1,6 @@
 // =========================================================
 // FILE: src/state/jmt/node_type_hash.hpp
-// PURPOSE: std::hash specialization for NodeKey
+// PURPOSE: std::hash specialization for NodeKey (all path allocators)
 // CRITICAL: Required for TreeCache (unordered_map)
 // =========================================================
 
@@ -9,11 +9,14 @@
 #include "node_type.hpp"
 #include <functional>
 
-namespace std {
+namespace glofica::xook {
 
-template <>
-struct hash<glofica::xook::NodeKey> {
-    size_t operator()(const glofica::xook::NodeKey& k) const noexcept {
+/// @brief NodeKey hash, identical for every path allocator
+struct NodeKeyHash {
+    using is_transparent = void;  // Heterogeneous lookup (NodeKey in pmr::NodeKey maps)
+    
+    template <typename PathAllocator>
+    size_t operator()(const BasicNodeKey<PathAllocator>& k) const noexcept {
         // Hash combine: version XOR path
         size_t h1 = std::hash<uint64_t>{}(k.version);
         
@@ -28,4 +31,37 @@ struct hash<glofica::xook::NodeKey> {
     }
 };
 
+/// @brief NibblePath hash (length + packed nibbles)
+struct NibblePathHash {
+    template <typename PathAllocator>
+    size_t operator()(const BasicNibblePath<PathAllocator>& path) const noexcept {
+        size_t h = std::hash<size_t>{}(path.size());
+        for (const auto& byte : path.bytes()) {
+            h = h * 31 + byte;
+        }
+        return h;
+    }
+};
+
+/// @brief NodeKey equality across path allocators
+struct NodeKeyEqual {
+    using is_transparent = void;
+    
+    template <typename A, typename B>
+    bool operator()(const BasicNodeKey<A>& a, const BasicNodeKey<B>& b) const noexcept {
+        return a.version == b.version && a.nibble_path.same_as(b.nibble_path);
+    }
+};
+
+} // namespace glofica::xook
+
+namespace std {
+
+template <typename PathAllocator>
+struct hash<glofica::xook::BasicNodeKey<PathAllocator>> {
+    size_t operator()(const glofica::xook::BasicNodeKey<PathAllocator>& k) const noexcept {
+        return glofica::xook::NodeKeyHash{}(k);
+    }
+};
+
 } // namespace std
@@ -0,0 +1,168 @@
+// =========================================================
+// FILE: src/xook/numa_topology.hpp
+// PURPOSE: NUMA topology discovery, thread and memory binding
+// CRITICAL: Raw syscalls (mbind / set_mempolicy / sched_setaffinity), no
+//           libnuma dependency; single-node machines and non-Linux builds
+//           degrade to one node and no-op binding
+// =========================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace glofica::xook {
+
+/// @brief Memory nodes and their CPUs, read once from /sys
+///
+/// Nodes are addressed by dense index [0, node_count()); node_id() maps an
+/// index back to the kernel's (possibly sparse) node number.
+class NumaTopology {
+private:
+    std::vector<int> node_ids_;
+    std::vector<std::vector<int>> cpus_;   // Per node index
+    std::vector<int> cpu_to_index_;        // Per CPU number (-1 = unknown)
+
+    /// @brief Parse a kernel cpulist/nodelist ("0-3,8,10-11")
+    static std::vector<int> parse_list(const std::string& text) {
+        std::vector<int> out;
+        std::stringstream ss(text);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty() || range == "\n") continue;
+            size_t dash = range.find('-');
+            try {
+                int lo = std::stoi(range.substr(0, dash));
+                int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+                for (int i = lo; i <= hi; ++i) out.push_back(i);
+            } catch (...) {
+                return {};
+            }
+        }
+        return out;
+    }
+
+    static std::string read_file(const std::string& path) {
+        std::ifstream in(path);
+        std::string text;
+        std::getline(in, text);
+        return text;
+    }
+
+    NumaTopology() {
+#ifdef __linux__
+        for (int id : parse_list(read_file("/sys/devices/system/node/online"))) {
+            auto cpus = parse_list(read_file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist"));
+            if (cpus.empty()) continue;  // Memory-only node (e.g. CXL): not a placement target
+            node_ids_.push_back(id);
+            cpus_.push_back(std::move(cpus));
+        }
+#endif
+        if (node_ids_.empty()) {
+            node_ids_ = {0};
+            cpus_ = {{}};
+        }
+        for (size_t idx = 0; idx < cpus_.size(); ++idx) {
+            for (int cpu : cpus_[idx]) {
+                if (cpu >= static_cast<int>(cpu_to_index_.size())) cpu_to_index_.resize(cpu + 1, -1);
+                cpu_to_index_[cpu] = static_cast<int>(idx);
+            }
+        }
+    }
+
+public:
+    [[nodiscard]] static const NumaTopology& system() {
+        static const NumaTopology topology;
+        return topology;
+    }
+
+    [[nodiscard]] size_t node_count() const noexcept { return node_ids_.size(); }
+    [[nodiscard]] int node_id(size_t index) const noexcept { return node_ids_[index]; }
+    [[nodiscard]] const std::vector<int>& cpus_of(size_t index) const noexcept { return cpus_[index]; }
+
+    /// @brief Node index the calling thread runs on (0 when unknown)
+    /// PERF: sched_getcpu() is served by rseq/vDSO, no syscall on the hot path
+    [[nodiscard]] size_t current_node() const noexcept {
+#ifdef __linux__
+        int cpu = sched_getcpu();
+        if (cpu >= 0 && cpu < static_cast<int>(cpu_to_index_.size()) && cpu_to_index_[cpu] >= 0) {
+            return static_cast<size_t>(cpu_to_index_[cpu]);
+        }
+#endif
+        return 0;
+    }
+
+    /// @brief Home node for a subtree keyed by its top-level nibble
+    /// Contiguous nibble ranges per node keep each socket's shard a set of whole subtrees.
+    [[nodiscard]] size_t home_node_for_nibble(uint8_t nibble) const noexcept {
+        return (static_cast<size_t>(nibble & 0x0F) * node_count()) / 16;
+    }
+};
+
+namespace numa {
+
+#ifdef __linux__
+// <numaif.h> constants (avoids a libnuma build dependency)
+inline constexpr int MPOL_PREFERRED_ = 1;
+inline constexpr unsigned MPOL_MF_MOVE_ = 1u << 1;
+
+/// @brief Node mask for one kernel node id (mask sized to cover the id)
+inline std::vector<unsigned long> node_mask(int node_id) {
+    constexpr size_t BITS = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> mask(static_cast<size_t>(node_id) / BITS + 1, 0);
+    mask[static_cast<size_t>(node_id) / BITS] |= 1UL << (static_cast<size_t>(node_id) % BITS);
+    return mask;
+}
+#endif
+
+/// @brief Pin the calling thread to a node's CPUs and prefer its memory
+/// @return false if the kernel refused (container cpusets, single node, ...)
+inline bool bind_current_thread(size_t node_index) {
+#ifdef __linux__
+    const auto& topo = NumaTopology::system();
+    if (node_index >= topo.node_count() || topo.cpus_of(node_index).empty()) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : topo.cpus_of(node_index)) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    bool ok = sched_setaffinity(0, sizeof(set), &set) == 0;
+
+    auto mask = node_mask(topo.node_id(node_index));
+    ok = syscall(SYS_set_mempolicy, MPOL_PREFERRED_, mask.data(), mask.size() * sizeof(unsigned long) * 8 + 1) == 0 && ok;
+    return ok;
+#else
+    (void)node_index;
+    return false;
+#endif
+}
+
+/// @brief Prefer a node for an address range (pages faulted later land there)
+inline bool bind_memory(void* addr, size_t bytes, size_t node_index) {
+#ifdef __linux__
+    const auto& topo = NumaTopology::system();
+    if (topo.node_count() < 2 || node_index >= topo.node_count()) return false;
+    auto mask = node_mask(topo.node_id(node_index));
+    return syscall(SYS_mbind, addr, bytes, MPOL_PREFERRED_, mask.data(),
+                   mask.size() * sizeof(unsigned long) * 8 + 1, MPOL_MF_MOVE_) == 0;
+#else
+    (void)addr; (void)bytes; (void)node_index;
+    return false;
+#endif
+}
+
+} // namespace numa
+
+} // namespace glofica::xook
@@ -0,0 +1,233 @@
+// =========================================================
+// FILE: src/xook/numa_tree_cache.hpp
+// PURPOSE: NUMA-aware TreeCache (per-socket top-level replicas + homed shards)
+// CRITICAL: On dual-socket validators a plain TreeCache places nodes wherever
+//           the putting thread ran, so ~half of all hits cross the interconnect
+// =========================================================
+
+#pragma once
+
+#include "tree_cache.hpp"
+#include "huge_page_resource.hpp"
+#include <memory>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief TreeCache partitioned by NUMA node
+///
+/// - Pinned levels (path length < pinned_depth): every lookup touches them,
+///   so each node keeps a full replica and readers use their local one.
+///   Puts write through to all replicas (a few hundred nodes per commit).
+/// - Deeper levels: one shard per node, homed by the key's top-level nibble
+///   (NumaTopology::home_node_for_nibble). Bind workers that walk subtree n
+///   to that nibble's node (numa::bind_current_thread) to keep hits local.
+///
+/// Each partition is a plain TreeCache whose node handles and map entries
+/// are allocated from a node-bound huge-page slab (HugePageSlabResource).
+/// InternalNode child arrays are allocated by the putting thread, so bind
+/// writers too. On single-node machines this is one replica + one shard and
+/// behaves like TreeCache.
+class NumaTreeCache : public TreeCache {
+private:
+    const NumaTopology& topology_;
+    size_t pinned_depth_;
+
+    std::vector<std::unique_ptr<TreeCache>> replicas_;  // Per node index
+    std::vector<std::unique_ptr<TreeCache>> shards_;    // Per node index
+
+    [[nodiscard]] bool is_pinned(const NodeKey& key) const noexcept {
+        return key.nibble_path.size() < pinned_depth_;
+    }
+
+    [[nodiscard]] TreeCache& shard_for(const NodeKey& key) const {
+        return *shards_[topology_.home_node_for_nibble(key.nibble_path.get_nibble(0))];
+    }
+
+    [[nodiscard]] TreeCache& local_replica() const {
+        return *replicas_[topology_.current_node()];
+    }
+
+    template <typename Fn>
+    void for_each_partition(Fn&& fn) const {
+        for (const auto& replica : replicas_) fn(*replica);
+        for (const auto& shard : shards_) fn(*shard);
+    }
+
+public:
+    /// @param capacity Total deep-level entries (split across shards)
+    /// @param pinned_depth Levels replicated per node (3 = root + 16 + 256 paths)
+    explicit NumaTreeCache(size_t capacity = 100000, size_t pinned_depth = 3,
+                           const NumaTopology& topology = NumaTopology::system())
+        : TreeCache(0), topology_(topology), pinned_depth_(std::max<size_t>(pinned_depth, 1)) {
+        size_t nodes = topology_.node_count();
+
+        // Pinned paths per version, with headroom for a few live versions
+        size_t replica_capacity = 4;
+        for (size_t d = 0, level = 1; d < pinned_depth_; ++d, level *= 16) replica_capacity += 4 * level;
+        size_t shard_capacity = std::max<size_t>(1, capacity / nodes);
+
+        for (size_t n = 0; n < nodes; ++n) {
+            // Shared with every handle allocated from it (outlives L1 slots)
+            auto slab = std::make_shared<HugePageSlabResource>(n);
+            replicas_.push_back(std::make_unique<TreeCache>(replica_capacity, slab));
+            shards_.push_back(std::make_unique<TreeCache>(shard_capacity, slab));
+        }
+    }
+
+    std::optional<Node> get(const NodeKey& key) override {
+        auto handle = get_shared(key);
+        if (!handle) return std::nullopt;
+        return *handle;
+    }
+
+    NodeHandle get_shared(const NodeKey& key) override {
+        return is_pinned(key) ? local_replica().get_shared(key) : shard_for(key).get_shared(key);
+    }
+
+    void put(const NodeKey& key, const Node& node) override {
+        if (is_pinned(key)) {
+            for (auto& replica : replicas_) replica->put(key, node);
+        } else {
+            shard_for(key).put(key, node);
+        }
+    }
+
+    /// @brief One locked pass per partition over the batch (replicas take pinned nodes)
+    void put_many(const std::vector<std::pair<NodeKey, Node>>& nodes) override {
+        for (auto& replica : replicas_) {
+            replica->put_many_if(nodes, [this](const NodeKey& key) { return is_pinned(key); });
+        }
+        for (auto& shard : shards_) {
+            TreeCache* target = shard.get();
+            shard->put_many_if(nodes, [this, target](const NodeKey& key) {
+                return !is_pinned(key) && &shard_for(key) == target;
+            });
+        }
+    }
+
+    void clear() override {
+        for_each_partition([](TreeCache& c) { c.clear(); });
+    }
+
+    /// @brief Distinct entries (one replica counted)
+    [[nodiscard]] size_t size() const override {
+        size_t total = replicas_.front()->size();
+        for (const auto& shard : shards_) total += shard->size();
+        return total;
+    }
+
+    /// @brief Resident bytes across all replicas and shards
+    [[nodiscard]] size_t approx_bytes() const noexcept override {
+        size_t total = 0;
+        for_each_partition([&total](const TreeCache& c) { total += c.approx_bytes(); });
+        return total;
+    }
+
+    /// @brief Shrink deep shards proportionally; replicas are small and stay hot
+    size_t shrink_to_bytes(size_t target_bytes) override {
+        size_t replica_bytes = 0;
+        for (const auto& replica : replicas_) replica_bytes += replica->approx_bytes();
+        size_t shard_target = target_bytes > replica_bytes ? (target_bytes - replica_bytes) / shards_.size() : 0;
+
+        size_t released = 0;
+        for (auto& shard : shards_) released += shard->shrink_to_bytes(shard_target);
+        return released;
+    }
+
+    void set_eviction_policy(EvictionPolicy policy, GreedyDualCost cost = {}) override {
+        for_each_partition([&](TreeCache& c) { c.set_eviction_policy(policy, cost); });
+    }
+
+    void set_supersede_policy(SupersedePolicy policy) override {
+        for_each_partition([policy](TreeCache& c) { c.set_supersede_policy(policy); });
+    }
+
+    /// @brief Partitions share one policy (set together)
+    [[nodiscard]] EvictionPolicy eviction_policy() const override {
+        return shards_.front()->eviction_policy();
+    }
+
+    [[nodiscard]] SupersedePolicy supersede_policy() const override {
+        return shards_.front()->supersede_policy();
+    }
+
+    /// @brief Summed over partitions (each replica counts its own copy)
+    [[nodiscard]] uint64_t superseded_count() const override {
+        uint64_t total = 0;
+        for_each_partition([&total](const TreeCache& c) { total += c.superseded_count(); });
+        return total;
+    }
+
+    [[nodiscard]] size_t supersede_backlog() const override {
+        size_t total = 0;
+        for_each_partition([&total](const TreeCache& c) { total += c.supersede_backlog(); });
+        return total;
+    }
+
+    /// @brief Every partition reports its evictions (pinned nodes once per replica)
+    void set_eviction_listener(EvictionListener listener) override {
+        for_each_partition([&listener](TreeCache& c) { c.set_eviction_listener(listener); });
+    }
+
+    /// @brief Same routing as get_shared(): local replica or home shard
+    bool visit_committed_node(const NodeKey& key, CommittedVisitor visit) const override {
+        return is_pinned(key) ? local_replica().visit_committed_node(key, visit)
+                              : shard_for(key).visit_committed_node(key, visit);
+    }
+
+    void enable_thread_local_l1(bool enabled = true) noexcept override {
+        for_each_partition([enabled](TreeCache& c) { c.enable_thread_local_l1(enabled); });
+    }
+
+    [[nodiscard]] bool thread_local_l1_enabled() const noexcept override {
+        return shards_.front()->thread_local_l1_enabled();
+    }
+
+    void enable_committed_index() override {
+        for_each_partition([](TreeCache& c) { c.enable_committed_index(); });
+    }
+
+    [[nodiscard]] bool committed_index_enabled() const noexcept override {
+        return shards_.front()->committed_index_enabled();
+    }
+
+    size_t publish_committed(uint64_t committed_version) override {
+        size_t published = 0;
+        for_each_partition([&](TreeCache& c) { published += c.publish_committed(committed_version); });
+        return published;
+    }
+
+    /// @brief Deep-level capacity (sum of shards; replicas are sized by pinned depth)
+    [[nodiscard]] size_t capacity() const noexcept override {
+        size_t total = 0;
+        for (const auto& shard : shards_) total += shard->capacity();
+        return total;
+    }
+
+    void set_capacity(size_t capacity) override {
+        size_t shard_capacity = std::max<size_t>(1, capacity / shards_.size());
+        for (auto& shard : shards_) shard->set_capacity(shard_capacity);
+    }
+
+    /// @brief Ghosts track the deep shards only (replicas hold every pinned path)
+    void set_ghost_capacity(size_t entries) override {
+        for (auto& shard : shards_) shard->set_ghost_capacity(entries / shards_.size());
+    }
+
+    [[nodiscard]] CacheFeedback feedback() const override {
+        CacheFeedback total;
+        for_each_partition([&total](const TreeCache& c) {
+            CacheFeedback f = c.feedback();
+            total.misses += f.misses;
+            total.ghost_hits += f.ghost_hits;
+            total.ghost_entries += f.ghost_entries;
+        });
+        return total;
+    }
+
+    [[nodiscard]] size_t node_count() const noexcept { return topology_.node_count(); }
+    [[nodiscard]] size_t pinned_depth() const noexcept { return pinned_depth_; }
+};
+
+} // namespace glofica::xook
@@ -0,0 +1,184 @@
+// =========================================================
+// FILE: src/xook/ordered_update_sets.hpp
+// PURPOSE: Partial update sets from parallel producers, merged by ordering key
+// CRITICAL: Resolution must equal serial application in order-key order
+//           (later sets overwrite earlier ones): the result is consensus-relevant
+// =========================================================
+
+#pragma once
+
+#include "../common/hash.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Key hash -> value hash, sorted by key hash, one entry per key
+using HashedUpdates = std::vector<std::pair<glofica::Hash, glofica::Hash>>;
+
+/// @brief Sort by key hash; the last write to a key wins (no-op on canonical input)
+template <typename Updates>
+void canonicalize_updates(Updates& updates) {
+    auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+    auto strictly = [](const auto& a, const auto& b) { return !(a.first < b.first); };
+    if (std::adjacent_find(updates.begin(), updates.end(), strictly) == updates.end()) return;
+
+    std::stable_sort(updates.begin(), updates.end(), by_key);
+    auto out = updates.begin();
+    for (auto it = updates.begin(); it != updates.end(); ++it) {
+        auto next = std::next(it);
+        if (next != updates.end() && next->first == it->first) continue;
+        if (out != it) *out = std::move(*it);  // No self-move (Bytes values)
+        ++out;
+    }
+    updates.erase(out, updates.end());
+}
+
+/// @brief A key written by more than one update set
+struct UpdateConflict {
+    glofica::Hash key_hash;
+    uint64_t winner;                   // Highest order key: its value is committed
+    std::vector<uint64_t> overridden;  // Ascending
+};
+
+/// @brief Canonical merge of all submitted sets
+struct ResolvedUpdates {
+    HashedUpdates updates;                 // Sorted by key hash (canonical order)
+    std::vector<UpdateConflict> conflicts; // Sorted by key hash
+    size_t sets = 0;
+};
+
+/// @brief Collects partial update sets tagged with an ordering key
+///
+/// Producers (e.g. executor groups) call submit() concurrently; keys are
+/// hashed and sorted on the producer's thread. resolve() merges the sets as
+/// if they had been applied one after another in ascending order-key order:
+/// on a key written by several sets the highest order key wins, and the
+/// overlap is reported. The merge runs per key-hash range (16 ranges by the
+/// leading nibble, which are disjoint subtrees), concurrently, and the
+/// output does not depend on submission order or thread count. Committing
+/// the result is one serial tree update in XookAdapter; ShardedXookState
+/// applies it per shard concurrently (under its own, sharded root).
+class OrderedUpdateSets {
+private:
+    struct Set {
+        uint64_t order;
+        HashedUpdates updates;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Set> sets_;
+
+    static constexpr size_t RANGES = 16;
+
+    struct RangeResult {
+        HashedUpdates updates;
+        std::vector<UpdateConflict> conflicts;
+    };
+
+    /// @brief Merge one leading-nibble range of every set (sets sorted by order)
+    static RangeResult resolve_range(const std::vector<const Set*>& sets, uint8_t nibble) {
+        struct Write {
+            const glofica::Hash* key;
+            const glofica::Hash* value;
+            uint64_t order;
+        };
+        std::vector<Write> writes;
+        for (const Set* set : sets) {
+            auto first = std::partition_point(set->updates.begin(), set->updates.end(),
+                                              [nibble](const auto& u) { return (u.first[0] >> 4) < nibble; });
+            auto last = std::partition_point(first, set->updates.end(),
+                                             [nibble](const auto& u) { return (u.first[0] >> 4) == nibble; });
+            for (auto it = first; it != last; ++it) writes.push_back({&it->first, &it->second, set->order});
+        }
+        // Sets are visited in order, so a stable sort by key keeps writes to one key in order
+        std::stable_sort(writes.begin(), writes.end(), [](const Write& a, const Write& b) { return *a.key < *b.key; });
+
+        RangeResult result;
+        result.updates.reserve(writes.size());
+        for (size_t i = 0; i < writes.size();) {
+            size_t end = i + 1;
+            while (end < writes.size() && *writes[end].key == *writes[i].key) ++end;
+            const Write& winner = writes[end - 1];
+            result.updates.emplace_back(*winner.key, *winner.value);
+            if (end - i > 1) {
+                UpdateConflict conflict{*winner.key, winner.order, {}};
+                for (size_t j = i; j + 1 < end; ++j) conflict.overridden.push_back(writes[j].order);
+                result.conflicts.push_back(std::move(conflict));
+            }
+            i = end;
+        }
+        return result;
+    }
+
+public:
+    /// @brief Submit a set of raw keys (hashed here with BLAKE3-512, as XookAdapter does)
+    /// @throws std::invalid_argument if `order_key` was already submitted
+    void submit(uint64_t order_key, const std::vector<std::pair<glofica::Bytes, glofica::Hash>>& updates) {
+        HashedUpdates hashed;
+        hashed.reserve(updates.size());
+        for (const auto& [key, value_hash] : updates) hashed.emplace_back(hash::blake3(key), value_hash);
+        submit_hashed(order_key, std::move(hashed));
+    }
+
+    /// @brief Submit a set of pre-hashed keys (any order; duplicates: last wins)
+    /// @throws std::invalid_argument if `order_key` was already submitted
+    void submit_hashed(uint64_t order_key, HashedUpdates updates) {
+        canonicalize_updates(updates);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& set : sets_) {
+            if (set.order == order_key) {
+                throw std::invalid_argument("OrderedUpdateSets: duplicate order key");
+            }
+        }
+        sets_.push_back({order_key, std::move(updates)});
+    }
+
+    [[nodiscard]] size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sets_.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sets_.clear();
+    }
+
+    /// @brief Merge all sets in order-key order (sets stay submitted; see clear())
+    /// @param threads Workers for the 16 key ranges (1 = calling thread only)
+    [[nodiscard]] ResolvedUpdates resolve(size_t threads = 1) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<const Set*> ordered;
+        ordered.reserve(sets_.size());
+        for (const auto& set : sets_) ordered.push_back(&set);
+        std::sort(ordered.begin(), ordered.end(), [](const Set* a, const Set* b) { return a->order < b->order; });
+
+        std::vector<RangeResult> ranges(RANGES);
+        threads = std::clamp<size_t>(threads, 1, RANGES);
+        auto work = [&](size_t first) {
+            for (size_t r = first; r < RANGES; r += threads) ranges[r] = resolve_range(ordered, static_cast<uint8_t>(r));
+        };
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < threads; ++t) workers.emplace_back(work, t);
+        work(0);
+        for (auto& w : workers) w.join();
+
+        ResolvedUpdates resolved;
+        resolved.sets = ordered.size();
+        size_t total = 0;
+        for (const auto& range : ranges) total += range.updates.size();
+        resolved.updates.reserve(total);
+        for (auto& range : ranges) {
+            resolved.updates.insert(resolved.updates.end(), range.updates.begin(), range.updates.end());
+            for (auto& conflict : range.conflicts) resolved.conflicts.push_back(std::move(conflict));
+        }
+        return resolved;
+    }
+};
+
+} // namespace glofica::xook
@@ -0,0 +1,400 @@
+// =========================================================
+// FILE: src/xook/shadow_adapter.hpp
+// PURPOSE: Shadow mode: legacy tree stays authoritative, XOOK runs behind it
+// CRITICAL: The secondary tree never sits on the commit path; its lag and
+//           queued memory are bounded, and divergence is reported async
+// =========================================================
+
+#pragma once
+
+#include "xook_adapter.hpp"
+#include "latency_histogram.hpp"
+#include "../common/hash.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Verdict for one shadowed block
+struct ShadowReport {
+    uint64_t version = 0;
+    glofica::Hash256 primary_root{};
+    glofica::Hash shadow_root{};
+    std::optional<glofica::Hash> expected;   // nullopt = no expectation for this block
+    std::string error;                       // Secondary threw, or shadow detached
+    bool diverged = false;
+};
+
+/// @brief What to do when the shadow falls max_lag_blocks / max_queued_bytes behind
+enum class ShadowOverflow : uint8_t {
+    Block,    // Back-pressure the primary until the shadow catches up (lag stays bounded)
+    Detach    // Stop shadowing (one report with error set); primary never waits
+};
+
+/// @brief Runs a secondary tree on its own thread behind an authoritative primary
+///
+/// The primary (XMTLegacyAdapter) is called synchronously and its root is
+/// returned immediately. Each block's updates are copied once into an
+/// immutable shared batch and queued; the shadow thread widens the values,
+/// applies them to the secondary (XookAdapter) against its own previous root,
+/// and compares the result with `expectation(version, primary_root)`.
+///
+/// The two trees hash different keys and widths, so their roots are never
+/// compared directly: the expectation maps a block to the XOOK root it must
+/// produce (e.g. roots recorded by a reference node or an XookMigrator run),
+/// and `value_transform` is the deterministic Hash256 → Hash widening both
+/// sides agreed on.
+///
+/// Primary:   put(Bytes, Hash256, version); calculate_root(updates, Hash256, version) -> Hash256
+/// Secondary: put(Bytes, Hash, version); calculate_root(updates, Hash, version) -> TreeUpdateBatch or Hash
+/// Both, if update_batch_with_precomputed_hashes() is used: the primary's
+/// (updates, version) + get_root_hash(version); the secondary's
+/// (updates, version, base_root) -> TreeUpdateBatch or Hash
+///
+/// A secondary that throws has not committed the block. With an expectation
+/// the shadow continues from the expected root; without one it detaches (its
+/// later roots could no longer be compared to anything).
+///
+/// Not thread-safe on the primary side (one committing thread, like the adapters).
+template <typename Primary, typename Secondary = XookAdapter>
+class ShadowAdapter {
+public:
+    using LegacyUpdate = std::pair<glofica::Bytes, glofica::Hash256>;
+    using ValueTransform = std::function<glofica::Hash(const glofica::Hash256&)>;
+    using Expectation = std::function<std::optional<glofica::Hash>(uint64_t version, const glofica::Hash256& primary_root)>;
+    using ReportSink = std::function<void(const ShadowReport&)>;
+
+    struct Options {
+        size_t max_lag_blocks = 8;                    // Queued blocks before overflow
+        size_t max_queued_bytes = size_t{64} << 20;   // Queued batch bytes before overflow
+        ShadowOverflow overflow = ShadowOverflow::Block;
+        bool report_all = false;                      // Sink gets every block, not just divergences
+        glofica::Hash initial_root{};                 // Secondary root before the first block (resume mid-chain)
+    };
+
+    struct Stats {
+        uint64_t blocks_submitted = 0;
+        uint64_t blocks_checked = 0;
+        uint64_t divergences = 0;
+        uint64_t primary_stalls = 0;                  // Enqueues that waited (ShadowOverflow::Block)
+        size_t max_queue_depth = 0;
+        bool detached = false;
+        std::optional<uint64_t> first_divergence;     // Version
+        HistogramSnapshot lag;                        // Submit → verdict
+    };
+
+    /// @brief Default widening: BLAKE3-512 over the 32-byte legacy value hash
+    [[nodiscard]] static glofica::Hash widen_value_hash(const glofica::Hash256& value) {
+        return hash::blake3(glofica::Bytes(value.begin(), value.end()));
+    }
+
+private:
+    /// @brief One block, shared read-only between the committing and shadow threads
+    struct Block {
+        uint64_t version = 0;
+        glofica::Hash256 primary_root{};
+        std::vector<LegacyUpdate> pending;   // From put(), applied via Secondary::put
+        std::vector<LegacyUpdate> explicit_updates;
+        bool precomputed = false;            // update_batch_with_precomputed_hashes (pending untouched)
+        size_t bytes = 0;
+        std::chrono::steady_clock::time_point submitted;
+        std::optional<ShadowReport> notice;  // Detach report: delivered in order, nothing applied
+    };
+
+    Primary* primary_;
+    Secondary* secondary_;
+    Options options_;
+    ValueTransform transform_;
+    Expectation expectation_;
+    ReportSink sink_;
+
+    // Committing thread only
+    std::vector<LegacyUpdate> pending_;
+
+    // Queue (mutex_)
+    std::mutex mutex_;
+    std::condition_variable queue_cv_;      // Shadow thread: work available / stop
+    std::condition_variable space_cv_;      // Primary + drain(): space freed / idle
+    std::deque<std::shared_ptr<const Block>> queue_;
+    size_t queued_bytes_ = 0;
+    bool busy_ = false;
+    bool stop_ = false;
+    Stats stats_;
+
+    // Shadow thread only
+    glofica::Hash shadow_root_;
+    LatencyHistogram lag_;
+    bool failed_ = false;                   // Secondary threw with nothing to resync from
+
+    std::atomic<bool> detached_{false};
+    std::thread worker_;
+
+    static size_t batch_bytes(const std::vector<LegacyUpdate>& updates) {
+        size_t bytes = updates.capacity() * sizeof(LegacyUpdate);
+        for (const auto& [key, value] : updates) bytes += key.capacity();
+        return bytes;
+    }
+
+    static constexpr bool has_precomputed_path = requires(
+        Primary& p, Secondary& s, const std::vector<LegacyUpdate>& legacy,
+        const std::vector<std::pair<glofica::Bytes, glofica::Hash>>& widened, const glofica::Hash& base) {
+        p.update_batch_with_precomputed_hashes(legacy, uint64_t{0});
+        p.get_root_hash(uint64_t{0});
+        s.update_batch_with_precomputed_hashes(widened, uint64_t{0}, base);
+    };
+
+    template <typename Result>
+    static glofica::Hash root_of(const Result& result) {
+        if constexpr (std::is_same_v<Result, glofica::Hash>) {
+            return result;
+        } else {
+            return result.new_root_hash;
+        }
+    }
+
+    void deliver(const ShadowReport& report) {
+        if (sink_ && (report.diverged || options_.report_all)) sink_(report);
+    }
+
+    /// @brief Secondary apply + verdict (shadow thread)
+    ShadowReport check(const Block& block) {
+        ShadowReport report;
+        report.version = block.version;
+        report.primary_root = block.primary_root;
+        bool applied = false;
+        try {
+            for (const auto& [key, value] : block.pending) secondary_->put(key, transform_(value), block.version);
+
+            std::vector<std::pair<glofica::Bytes, glofica::Hash>> updates;
+            updates.reserve(block.explicit_updates.size());
+            for (const auto& [key, value] : block.explicit_updates) updates.emplace_back(key, transform_(value));
+
+            if constexpr (has_precomputed_path) {
+                if (block.precomputed) {
+                    shadow_root_ = root_of(secondary_->update_batch_with_precomputed_hashes(updates, block.version, shadow_root_));
+                }
+            }
+            if (!block.precomputed) {
+                shadow_root_ = root_of(secondary_->calculate_root(updates, shadow_root_, block.version));
+            }
+            applied = true;
+            report.shadow_root = shadow_root_;
+            if (expectation_) report.expected = expectation_(block.version, block.primary_root);
+            report.diverged = report.expected && *report.expected != shadow_root_;
+        } catch (const std::exception& e) {
+            report.error = e.what();
+            report.diverged = true;
+            if (!applied) resync_after_failure(block, report);
+        }
+        return report;
+    }
+
+    /// @brief The secondary missed this block: continue from its expected root
+    /// (later blocks are checked as usual), or give up on the chain
+    void resync_after_failure(const Block& block, ShadowReport& report) {
+        if (expectation_) {
+            try {
+                report.expected = expectation_(block.version, block.primary_root);
+            } catch (const std::exception&) {
+                report.expected.reset();
+            }
+        }
+        if (report.expected) {
+            shadow_root_ = *report.expected;
+        } else {
+            failed_ = true;  // Detached by run(); queued blocks are dropped unchecked
+        }
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return;  // stop_ and fully drained
+
+            std::shared_ptr<const Block> block = queue_.front();
+            busy_ = true;
+            lock.unlock();
+
+            if (block->notice) {
+                if (sink_) sink_(*block->notice);  // Counted when detaching
+                lock.lock();
+                queue_.pop_front();
+                busy_ = false;
+                space_cv_.notify_all();
+                continue;
+            }
+            if (failed_) {
+                lock.lock();
+                queue_.pop_front();
+                queued_bytes_ -= block->bytes;
+                busy_ = false;
+                space_cv_.notify_all();
+                continue;
+            }
+
+            ShadowReport report = check(*block);
+            lag_.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - block->submitted).count()));
+            deliver(report);
+
+            lock.lock();
+            // Bytes stay charged until the block is applied: memory bound covers in-flight work
+            queue_.pop_front();
+            queued_bytes_ -= block->bytes;
+            busy_ = false;
+            ++stats_.blocks_checked;
+            if (report.diverged) {
+                ++stats_.divergences;
+                if (!stats_.first_divergence) stats_.first_divergence = report.version;
+            }
+            if (failed_) {
+                detached_.store(true, std::memory_order_relaxed);
+                stats_.detached = true;
+            }
+            space_cv_.notify_all();
+        }
+    }
+
+    /// @brief Stop shadowing for good: the secondary has missed a block
+    ShadowReport detach_locked(uint64_t version) {
+        detached_.store(true, std::memory_order_relaxed);
+        stats_.detached = true;
+        ShadowReport report;
+        report.version = version;
+        report.error = "shadow detached: lag bound exceeded";
+        report.diverged = true;
+        ++stats_.divergences;
+        if (!stats_.first_divergence) stats_.first_divergence = version;
+        return report;
+    }
+
+    void submit(std::shared_ptr<Block> block) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto full = [&] {
+            return !queue_.empty() &&
+                   (queue_.size() >= options_.max_lag_blocks ||
+                    queued_bytes_ + block->bytes > options_.max_queued_bytes);
+        };
+        if (full()) {
+            if (options_.overflow == ShadowOverflow::Detach) {
+                // The report follows the queued blocks to the shadow thread (uncharged, tiny)
+                auto notice = std::make_shared<Block>();
+                notice->version = block->version;
+                notice->notice = detach_locked(block->version);
+                queue_.push_back(std::move(notice));
+                queue_cv_.notify_one();
+                return;
+            }
+            ++stats_.primary_stalls;
+            space_cv_.wait(lock, [&] { return !full(); });
+        }
+
+        block->submitted = std::chrono::steady_clock::now();
+        queued_bytes_ += block->bytes;
+        queue_.push_back(std::move(block));
+        ++stats_.blocks_submitted;
+        stats_.max_queue_depth = std::max(stats_.max_queue_depth, queue_.size());
+        queue_cv_.notify_one();
+    }
+
+public:
+    /// @param expectation Expected secondary root per block (empty = record only)
+    /// @param sink Called on the shadow thread for divergences and the detach report
+    ///             (or every block with report_all)
+    ShadowAdapter(Primary* primary, Secondary* secondary, Options options = {},
+                  Expectation expectation = {}, ReportSink sink = {},
+                  ValueTransform transform = &ShadowAdapter::widen_value_hash)
+        : primary_(primary), secondary_(secondary), options_(options),
+          transform_(std::move(transform)), expectation_(std::move(expectation)), sink_(std::move(sink)),
+          shadow_root_(options.initial_root) {
+        options_.max_lag_blocks = std::max<size_t>(1, options_.max_lag_blocks);
+        worker_ = std::thread([this] { run(); });
+    }
+
+    /// @brief Finishes queued blocks, then stops the shadow thread
+    ~ShadowAdapter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        queue_cv_.notify_one();
+        worker_.join();
+    }
+
+    ShadowAdapter(const ShadowAdapter&) = delete;
+    ShadowAdapter& operator=(const ShadowAdapter&) = delete;
+
+    // ===== LEGACY API (primary is authoritative) =====
+
+    void put(const glofica::Bytes& key, const glofica::Hash256& value_hash, uint64_t version) {
+        primary_->put(key, value_hash, version);
+        if (!detached_.load(std::memory_order_relaxed)) pending_.emplace_back(key, value_hash);
+    }
+
+    /// @brief Primary root now; the secondary catches up on the shadow thread
+    glofica::Hash256 calculate_root(const std::vector<LegacyUpdate>& updates,
+                                    const glofica::Hash256& base_root, uint64_t version) {
+        glofica::Hash256 root = primary_->calculate_root(updates, base_root, version);
+        if (detached_.load(std::memory_order_relaxed)) {
+            pending_.clear();
+            return root;
+        }
+
+        auto block = std::make_shared<Block>();
+        block->version = version;
+        block->primary_root = root;
+        block->pending = std::move(pending_);
+        block->explicit_updates = updates;  // The one copy: shared read-only from here on
+        block->bytes = sizeof(Block) + batch_bytes(block->pending) + batch_bytes(block->explicit_updates);
+        pending_ = {};
+        submit(std::move(block));
+        return root;
+    }
+
+    /// @brief Primary batch now, the same batch on the secondary behind it
+    /// Pending put()s stay pending on both sides (committed by the next calculate_root)
+    void update_batch_with_precomputed_hashes(const std::vector<LegacyUpdate>& updates, uint64_t version) {
+        static_assert(has_precomputed_path, "Primary and Secondary both need update_batch_with_precomputed_hashes");
+        primary_->update_batch_with_precomputed_hashes(updates, version);
+        if (detached_.load(std::memory_order_relaxed)) return;
+
+        auto block = std::make_shared<Block>();
+        block->version = version;
+        block->primary_root = primary_->get_root_hash(version);
+        block->explicit_updates = updates;
+        block->precomputed = true;
+        block->bytes = sizeof(Block) + batch_bytes(block->explicit_updates);
+        submit(std::move(block));
+    }
+
+    /// @brief The primary itself: writes made through it are not shadowed
+    [[nodiscard]] Primary& primary() noexcept { return *primary_; }
+
+    /// @brief Block until every submitted block has a verdict
+    void drain() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_cv_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    }
+
+    [[nodiscard]] bool detached() const noexcept { return detached_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] Stats stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats copy = stats_;
+        copy.lag = lag_.snapshot();
+        return copy;
+    }
+};
+
+} // namespace glofica::xook
@@ -0,0 +1,213 @@
+// =========================================================
+// FILE: src/xook/sharded_node_store.hpp
+// PURPOSE: Spread XOOK nodes over M local KVStores by key range
+// CRITICAL: Placement depends only on the leading path nibbles (never the
+//           version), so every version of a subtree lives on one store and
+//           M must not change for an existing data set
+// =========================================================
+
+#pragma once
+
+#include "xook_merkle_tree.hpp"
+#include "node_serde.hpp"
+#include "worker_pool.hpp"
+#include "../common/hash.hpp"
+#include "../kv/kv_store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Maps a NibblePath to one of M stores by its first `prefix_nibbles` nibbles
+///
+/// The 16^d possible prefixes are cut into M contiguous ranges, so a subtree
+/// rooted at depth >= d is entirely on one store. Paths shorter than d (the
+/// root and the top levels) are zero-padded: they land on the store owning
+/// the start of their range (the root on store 0).
+class KeyRangePartitioner {
+    size_t stores_;
+    size_t prefix_nibbles_;
+    size_t prefix_shift_;  // 4 * prefix_nibbles
+
+public:
+    /// @param prefix_nibbles Partition depth (1-4); 16^d must be >= stores
+    explicit KeyRangePartitioner(size_t stores, size_t prefix_nibbles = 1)
+        : stores_(stores), prefix_nibbles_(prefix_nibbles), prefix_shift_(4 * prefix_nibbles) {
+        if (stores == 0) throw std::invalid_argument("KeyRangePartitioner: need at least one store");
+        if (prefix_nibbles == 0 || prefix_nibbles > 4) {
+            throw std::invalid_argument("KeyRangePartitioner: prefix_nibbles must be 1-4");
+        }
+        if (stores > (size_t{1} << prefix_shift_)) {
+            throw std::invalid_argument("KeyRangePartitioner: more stores than key ranges");
+        }
+    }
+
+    /// @brief Store index for a path (hot path: no allocation)
+    template <typename Path>
+    [[nodiscard]] size_t store_of(const Path& path) const noexcept {
+        size_t prefix = 0;
+        size_t known = std::min(prefix_nibbles_, path.size());
+        const auto& bytes = path.bytes();
+        for (size_t i = 0; i < known; ++i) {
+            uint8_t byte = bytes[i / 2];
+            prefix = (prefix << 4) | ((i % 2 == 0) ? (byte >> 4) : (byte & 0x0F));
+        }
+        prefix <<= 4 * (prefix_nibbles_ - known);
+        return (prefix * stores_) >> prefix_shift_;
+    }
+
+    /// @brief First prefix (in [0, 16^d)) owned by `store`
+    [[nodiscard]] size_t range_begin(size_t store) const noexcept {
+        // Smallest p with p * M >= store * 16^d
+        return ((store << prefix_shift_) + stores_ - 1) / stores_;
+    }
+
+    [[nodiscard]] size_t store_count() const noexcept { return stores_; }
+    [[nodiscard]] size_t prefix_nibbles() const noexcept { return prefix_nibbles_; }
+};
+
+/// @brief TreeReader + parallel batch writer over M KVStores (separate dirs / disks)
+///
+/// Same key/value layout as a single store (NodeKey::serialize() →
+/// serialize_node_with_prefix()); only the placement changes. Reads touch
+/// exactly one store. write_batch() groups a commit's nodes by store and
+/// writes the groups concurrently on a persistent pool, so commit I/O is
+/// spread over every disk instead of serialized on one. Each group goes to
+/// its store as one atomic write batch when the KVStore offers write_batch(),
+/// key by key otherwise.
+///
+/// Thread-safety is that of the underlying stores: reads may run
+/// concurrently with each other; one writer at a time.
+class ShardedNodeStore : public TreeReader {
+public:
+    struct Stats {
+        std::vector<uint64_t> nodes_written;   // Per store
+        std::vector<uint64_t> bytes_written;   // Per store (keys + values)
+        uint64_t batches = 0;
+    };
+
+private:
+    using Group = std::vector<std::pair<glofica::Bytes, glofica::Bytes>>;
+
+    std::vector<kv::KVStore*> stores_;
+    KeyRangePartitioner partitioner_;
+    std::vector<Group> groups_;  // Reused per batch
+    Stats stats_;
+    mutable std::mutex stats_mutex_;
+    WorkerPool pool_;  // One job per busy store
+
+    /// @brief One atomic batch if the store supports it, else one put() per node
+    template <typename Store>
+    static void write_group(Store& store, const Group& group) {
+        if constexpr (requires { store.write_batch(group); }) {
+            store.write_batch(group);
+        } else {
+            for (const auto& [key, value] : group) store.put(key, value);
+        }
+    }
+
+    /// @brief Write every non-empty group concurrently; rethrows the first failure
+    void flush_groups() {
+        std::vector<uint64_t> bytes(groups_.size(), 0);
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+        auto write_store = [&](size_t s) {
+            try {
+                write_group(*stores_[s], groups_[s]);
+                for (const auto& [key, value] : groups_[s]) bytes[s] += key.size() + value.size();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                if (!failure) failure = std::current_exception();
+            }
+        };
+
+        std::vector<size_t> busy;
+        std::vector<std::function<void()>> jobs;
+        for (size_t s = 0; s < groups_.size(); ++s) {
+            if (groups_[s].empty()) continue;
+            busy.push_back(s);
+            jobs.emplace_back([&write_store, s] { write_store(s); });
+        }
+        if (jobs.size() == 1) {
+            jobs[0]();
+        } else if (!jobs.empty()) {
+            pool_.run(std::move(jobs));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            for (size_t s : busy) {
+                stats_.nodes_written[s] += groups_[s].size();
+                stats_.bytes_written[s] += bytes[s];
+            }
+            ++stats_.batches;
+        }
+        for (auto& group : groups_) group.clear();
+        if (failure) std::rethrow_exception(failure);
+    }
+
+public:
+    /// @param stores One KVStore per directory / disk (order defines the key ranges)
+    /// @param prefix_nibbles Partition depth; 1 suffices for up to 16 stores
+    explicit ShardedNodeStore(std::vector<kv::KVStore*> stores, size_t prefix_nibbles = 1)
+        : stores_(std::move(stores)), partitioner_(stores_.size(), prefix_nibbles),
+          groups_(stores_.size()), pool_(WorkerPool::threads_for(stores_.size())) {
+        for (kv::KVStore* store : stores_) {
+            if (!store) throw std::invalid_argument("ShardedNodeStore: null KVStore");
+        }
+        stats_.nodes_written.assign(stores_.size(), 0);
+        stats_.bytes_written.assign(stores_.size(), 0);
+    }
+
+    ShardedNodeStore(const ShardedNodeStore&) = delete;
+    ShardedNodeStore& operator=(const ShardedNodeStore&) = delete;
+
+    // ===== READ (TreeReader) =====
+
+    std::optional<glofica::Bytes> get_node_bytes(const NodeKey& key) override {
+        return stores_[partitioner_.store_of(key.nibble_path)]->get(key.serialize());
+    }
+
+    // ===== WRITE =====
+
+    /// @brief Persist a commit's nodes (TreeUpdateBatch::node_batch or any {NodeKey, Node} range)
+    template <typename NodeBatch>
+    void write_batch(const NodeBatch& batch) {
+        for (const auto& [key, node] : batch) {
+            groups_[partitioner_.store_of(key.nibble_path)].emplace_back(
+                key.serialize(), serialize_node_with_prefix(node));
+        }
+        flush_groups();
+    }
+
+    /// @brief Persist already-serialized nodes (e.g. XookMigrator output)
+    void write_serialized(const std::vector<std::pair<NodeKey, glofica::Bytes>>& nodes) {
+        for (const auto& [key, bytes] : nodes) {
+            groups_[partitioner_.store_of(key.nibble_path)].emplace_back(key.serialize(), bytes);
+        }
+        flush_groups();
+    }
+
+    // ===== INTROSPECTION =====
+
+    [[nodiscard]] size_t store_of(const NodeKey& key) const noexcept {
+        return partitioner_.store_of(key.nibble_path);
+    }
+
+    [[nodiscard]] const KeyRangePartitioner& partitioner() const noexcept { return partitioner_; }
+    [[nodiscard]] size_t store_count() const noexcept { return stores_.size(); }
+
+    [[nodiscard]] Stats stats() const {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return stats_;
+    }
+};
+
+} // namespace glofica::xook
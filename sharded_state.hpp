@@ -0,0 +1,331 @@
+// =========================================================
+// FILE: src/xook/sharded_state.hpp
+// PURPOSE: K independent XOOK trees behind one state facade
+// CRITICAL: Routing (leading key-hash bits) and the top-level root encoding
+//           are consensus-relevant: shard count is part of the state format
+// =========================================================
+
+#pragma once
+
+#include "xook_adapter.hpp"
+#include "numa_topology.hpp"
+#include "worker_pool.hpp"
+#include "../common/hash.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace glofica::xook {
+
+// Domain separator for the aggregated root (distinct from node domains)
+inline const std::string XOOK_SHARDED_ROOT_DOMAIN = "GLOFICA_ShardedRoot_V1";
+
+/// @brief Binds a shard root to the top-level root
+///
+/// A full inclusion proof is this plus the shard tree's own proof for the key
+/// against shard_roots[shard_index].
+struct ShardRootProof {
+    uint32_t shard_index = 0;
+    uint32_t shard_count = 0;
+    uint64_t version = 0;
+    std::vector<glofica::Hash> shard_roots;  // All K roots at `version`
+};
+
+/// @brief Result of one sharded commit
+struct ShardedCommit {
+    glofica::Hash root{};
+    std::vector<glofica::Hash> shard_roots;
+    std::vector<uint32_t> committed_shards;  // Shards that had updates
+};
+
+/// @brief Routes keys by leading blake3(key) bits to K XookAdapters
+///
+/// Each shard has its own cache, governor and reader (KVStore or in-memory
+/// store), and dirty shards commit in parallel on a persistent pool. The
+/// top-level root is
+///   blake3(XOOK_SHARDED_ROOT_DOMAIN || K (u32 LE) || root_0 || ... || root_{K-1})
+/// and is recomputed from the shard roots on every commit. It is not the
+/// root an unsharded XookAdapter computes over the same keys (nor the root
+/// for another K): moving between them rebuilds the state.
+///
+/// Shards without updates keep their previous (root, version); reads at a
+/// facade version go to each shard's latest version at or below it.
+///
+/// Not thread-safe for writers (one committing thread); get()/get_root_hash()
+/// may run concurrently with each other.
+class ShardedXookState {
+public:
+    static constexpr size_t MAX_SHARDS = 256;  // Routing uses the first key-hash byte
+
+private:
+    struct ShardHead {
+        glofica::Hash root{};
+        std::optional<uint64_t> version;  // nullopt = never committed
+    };
+
+    struct HistoryEntry {
+        uint64_t version;
+        glofica::Hash root;
+        std::vector<ShardHead> shards;
+    };
+
+    std::vector<std::unique_ptr<XookAdapter>> shards_;
+    unsigned shard_bits_;
+    std::vector<ShardHead> heads_;           // Writer thread
+    std::vector<bool> dirty_;                // put() since last commit
+    size_t history_limit_;
+    std::deque<HistoryEntry> history_;       // Oldest first
+    mutable std::mutex history_mutex_;
+
+    bool numa_bind_ = false;  // enable_numa_binding(); set by the writer between commits
+    bool failed_ = false;     // A commit failed part-way (writer thread)
+    std::unique_ptr<WorkerPool> pool_;  // Persistent commit pool; declared after shards_, stops first
+
+    /// @brief NUMA node homing shard s: the node of its first top-level nibble
+    [[nodiscard]] size_t home_node(size_t s) const noexcept {
+        uint8_t first_byte = shard_bits_ == 0 ? 0 : static_cast<uint8_t>(s << (8 - shard_bits_));
+        return NumaTopology::system().home_node_for_nibble(first_byte >> 4);
+    }
+
+    /// @brief Move a pool worker to `node` (one syscall per change of node)
+    static void bind_worker(size_t node) {
+        thread_local size_t bound = SIZE_MAX;
+        if (bound == node) return;
+        bound = node;
+        numa::bind_current_thread(node);  // Refused (one node, cpusets): runs unbound
+    }
+
+    [[nodiscard]] static glofica::Hash combine(const std::vector<ShardHead>& heads) {
+        glofica::Bytes buffer;
+        buffer.reserve(XOOK_SHARDED_ROOT_DOMAIN.size() + 4 + heads.size() * sizeof(glofica::Hash));
+        buffer.insert(buffer.end(), XOOK_SHARDED_ROOT_DOMAIN.begin(), XOOK_SHARDED_ROOT_DOMAIN.end());
+        uint32_t count = static_cast<uint32_t>(heads.size());
+        for (int i = 0; i < 4; ++i) buffer.push_back(static_cast<uint8_t>((count >> (i * 8)) & 0xFF));
+        for (const auto& head : heads) buffer.insert(buffer.end(), head.root.begin(), head.root.end());
+        return hash::blake3(buffer);
+    }
+
+    [[nodiscard]] std::optional<HistoryEntry> entry_at(uint64_t version) const {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        // Newest entry at or below `version`: unchanged facade versions are not recorded
+        for (auto it = history_.rbegin(); it != history_.rend(); ++it) {
+            if (it->version <= version) return *it;
+        }
+        return std::nullopt;
+    }
+
+    /// @brief Commit every shard with updates (or pending put()s) in parallel, aggregate the roots
+    /// @param commit_shard (adapter, shard index) -> TreeUpdateBatch for that shard
+    /// All or nothing at the facade: heads_, dirty_ and history change only
+    /// if every shard committed (see failed()).
+    template <typename CommitShard>
+    ShardedCommit commit_routed(const std::vector<bool>& has_updates, uint64_t version, CommitShard&& commit_shard) {
+        if (failed_) {
+            throw std::logic_error("ShardedXookState: a shard commit failed earlier; state must be reopened");
+        }
+        ShardedCommit commit;
+        std::vector<ShardHead> next = heads_;
+        std::vector<std::function<void()>> jobs;
+        std::vector<std::exception_ptr> failures(shards_.size());
+        const std::thread::id committer = std::this_thread::get_id();
+        for (size_t s = 0; s < shards_.size(); ++s) {
+            if (!has_updates[s] && !dirty_[s]) continue;
+            commit.committed_shards.push_back(static_cast<uint32_t>(s));
+            jobs.emplace_back([this, s, version, committer, &next, &commit_shard, &failures] {
+                // Workers follow the shard's home node; the committer's affinity is left alone
+                if (numa_bind_ && std::this_thread::get_id() != committer) bind_worker(home_node(s));
+                try {
+                    auto result = commit_shard(*shards_[s], s);
+                    next[s].root = result.new_root_hash;
+                    next[s].version = version;
+                } catch (...) {
+                    failures[s] = std::current_exception();
+                }
+            });
+        }
+        pool_->run(std::move(jobs));
+        for (auto& failure : failures) {
+            if (!failure) continue;
+            // Shards that did commit cannot be rolled back (their put()s are consumed),
+            // so the facade stays at the last complete version and stops accepting writes
+            failed_ = true;
+            std::rethrow_exception(failure);
+        }
+        heads_ = std::move(next);
+        std::fill(dirty_.begin(), dirty_.end(), false);
+
+        commit.root = combine(heads_);
+        commit.shard_roots.reserve(heads_.size());
+        for (const auto& head : heads_) commit.shard_roots.push_back(head.root);
+
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        history_.push_back({version, commit.root, heads_});
+        if (history_.size() > history_limit_) history_.pop_front();
+        return commit;
+    }
+
+    /// @brief Validate the shard count, build the shards, start the pool
+    template <typename MakeShard>
+    ShardedXookState(size_t shard_count, size_t history_versions, MakeShard&& make_shard)
+        : shard_bits_(0), heads_(shard_count), dirty_(shard_count, false),
+          history_limit_(std::max<size_t>(1, history_versions)) {
+        if (shard_count == 0 || shard_count > MAX_SHARDS || (shard_count & (shard_count - 1)) != 0) {
+            throw std::invalid_argument("ShardedXookState: shard_count must be a power of two in [1, 256]");
+        }
+        while ((size_t{1} << shard_bits_) < shard_count) ++shard_bits_;
+
+        shards_.reserve(shard_count);
+        for (size_t i = 0; i < shard_count; ++i) shards_.push_back(make_shard(i));
+        pool_ = std::make_unique<WorkerPool>(WorkerPool::threads_for(shard_count));
+    }
+
+public:
+    /// @param shard_count Power of two in [1, 256]
+    /// @param stores One KVStore per shard, or empty for in-memory shards (test mode)
+    /// @param history_versions Facade versions kept for historical reads/proofs
+    explicit ShardedXookState(size_t shard_count, const std::vector<kv::KVStore*>& stores = {},
+                              size_t history_versions = 128)
+        : ShardedXookState(shard_count, history_versions, [&stores, shard_count](size_t i) {
+              if (!stores.empty() && stores.size() != shard_count) {
+                  throw std::invalid_argument("ShardedXookState: need one KVStore per shard");
+              }
+              return std::make_unique<XookAdapter>(stores.empty() ? nullptr : stores[i]);
+          }) {}
+
+    /// @brief Shards over caller-provided node readers (one per shard, power-of-two count)
+    explicit ShardedXookState(const std::vector<std::shared_ptr<TreeReader>>& readers, size_t history_versions = 128)
+        : ShardedXookState(readers.size(), history_versions, [&readers](size_t i) {
+              return std::make_unique<XookAdapter>(readers[i]);
+          }) {}
+
+    ShardedXookState(const ShardedXookState&) = delete;
+    ShardedXookState& operator=(const ShardedXookState&) = delete;
+
+    /// @brief Bind pool workers to the NUMA node of the shard they commit
+    /// Shard s holds the subtrees of its top-level nibbles, and a shard's
+    /// nodes are allocated by the worker that commits it, so binding keeps
+    /// each shard's cache and its commit traffic on one socket (the nibble
+    /// homing of NumaTreeCache). Harmless on single-node hosts.
+    void enable_numa_binding(bool enabled = true) noexcept { numa_bind_ = enabled; }
+
+    [[nodiscard]] size_t shard_count() const noexcept { return shards_.size(); }
+    [[nodiscard]] XookAdapter& shard(size_t index) { return *shards_[index]; }
+
+    /// @brief Shard owning a key hash: its leading shard_bits bits
+    [[nodiscard]] size_t shard_of_hash(const glofica::Hash& key_hash) const noexcept {
+        return shard_bits_ == 0 ? 0 : static_cast<size_t>(key_hash[0] >> (8 - shard_bits_));
+    }
+
+    [[nodiscard]] size_t shard_of(const glofica::Bytes& key) const {
+        return shard_of_hash(hash::blake3(key));
+    }
+
+    /// @brief True after a partial commit failure (writes refused; reads still served)
+    [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+    /// @brief Accumulate an update in its shard (committed by the next calculate_root)
+    void put(const glofica::Bytes& key, const glofica::Hash& value_hash, uint64_t version) {
+        if (failed_) {
+            throw std::logic_error("ShardedXookState: a shard commit failed earlier; state must be reopened");
+        }
+        size_t s = shard_of(key);
+        shards_[s]->put(key, value_hash, version);
+        dirty_[s] = true;
+    }
+
+    /// @brief Commit all dirty shards in parallel and aggregate the roots
+    /// @throws The first shard failure. Other shards' commits still complete
+    ///         and cannot be undone, so the facade keeps its previous version
+    ///         (heads, history and reads unchanged) and refuses further
+    ///         writes with std::logic_error: reopen the state from its stores.
+    ShardedCommit calculate_root(const std::vector<std::pair<glofica::Bytes, glofica::Hash>>& updates,
+                                 uint64_t version) {
+        std::vector<std::vector<std::pair<glofica::Bytes, glofica::Hash>>> routed(shards_.size());
+        for (const auto& update : updates) routed[shard_of(update.first)].push_back(update);
+
+        std::vector<bool> has_updates(shards_.size());
+        for (size_t s = 0; s < shards_.size(); ++s) has_updates[s] = !routed[s].empty();
+        return commit_routed(has_updates, version, [&](XookAdapter& shard, size_t s) {
+            return shard.calculate_root(routed[s], heads_[s].root, version, heads_[s].version);
+        });
+    }
+
+    /// @brief Commit partial update sets merged by OrderedUpdateSets::resolve()
+    /// Shards are disjoint subtrees: each applies its slice of the canonical
+    /// merge concurrently. Same root as this class's calculate_root() of the
+    /// sets applied in order; that is the sharded root, not the root of
+    /// XookAdapter::calculate_root(resolved) over the same keys.
+    ShardedCommit calculate_root(const ResolvedUpdates& resolved, uint64_t version) {
+        // Sorted input, so each shard's slice stays sorted
+        std::vector<HashedUpdates> routed(shards_.size());
+        for (const auto& update : resolved.updates) routed[shard_of_hash(update.first)].push_back(update);
+
+        std::vector<bool> has_updates(shards_.size());
+        for (size_t s = 0; s < shards_.size(); ++s) has_updates[s] = !routed[s].empty();
+        return commit_routed(has_updates, version, [&](XookAdapter& shard, size_t s) {
+            return shard.calculate_root_hashed(routed[s], heads_[s].root, version, heads_[s].version);
+        });
+    }
+
+    /// @brief Value at a facade version (routed to the shard's version at or below it)
+    [[nodiscard]] std::optional<glofica::Hash> get(const glofica::Bytes& key, uint64_t version) const {
+        auto entry = entry_at(version);
+        if (!entry) return std::nullopt;
+        size_t s = shard_of(key);
+        const auto& head = entry->shards[s];
+        if (!head.version) return std::nullopt;  // Shard empty at that version
+        return shards_[s]->get(key, *head.version);
+    }
+
+    /// @brief Top-level root at a facade version (nullopt if outside the history window)
+    [[nodiscard]] std::optional<glofica::Hash> get_root_hash(uint64_t version) const {
+        auto entry = entry_at(version);
+        if (!entry) return std::nullopt;
+        return entry->root;
+    }
+
+    /// @brief Shard binding for a key at a facade version
+    [[nodiscard]] std::optional<ShardRootProof> shard_proof(const glofica::Bytes& key, uint64_t version) const {
+        auto entry = entry_at(version);
+        if (!entry) return std::nullopt;
+        ShardRootProof proof;
+        proof.shard_index = static_cast<uint32_t>(shard_of(key));
+        proof.shard_count = static_cast<uint32_t>(shards_.size());
+        proof.version = entry->version;
+        proof.shard_roots.reserve(entry->shards.size());
+        for (const auto& head : entry->shards) proof.shard_roots.push_back(head.root);
+        return proof;
+    }
+
+    /// @brief Check a shard binding against a trusted top-level root
+    /// @return The shard root the key's inner proof must verify against
+    [[nodiscard]] static std::optional<glofica::Hash> verify_shard_proof(const ShardRootProof& proof,
+                                                                         const glofica::Hash& top_root,
+                                                                         const glofica::Bytes& key) {
+        const size_t count = proof.shard_count;
+        if (count == 0 || count > MAX_SHARDS || (count & (count - 1)) != 0) return std::nullopt;
+        if (proof.shard_roots.size() != count || proof.shard_index >= count) return std::nullopt;
+
+        unsigned bits = 0;
+        while ((size_t{1} << bits) < count) ++bits;
+        glofica::Hash key_hash = hash::blake3(key);
+        size_t expected_shard = bits == 0 ? 0 : static_cast<size_t>(key_hash[0] >> (8 - bits));
+        if (expected_shard != proof.shard_index) return std::nullopt;  // Key routed elsewhere
+
+        std::vector<ShardHead> heads(count);
+        for (size_t i = 0; i < count; ++i) heads[i].root = proof.shard_roots[i];
+        if (combine(heads) != top_root) return std::nullopt;
+        return proof.shard_roots[proof.shard_index];
+    }
+};
+
+} // namespace glofica::xook
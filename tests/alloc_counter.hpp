@@ -0,0 +1,96 @@
+// =========================================================
+// FILE: tests/xook/alloc_counter.hpp
+// PURPOSE: Counting global operator new for zero-allocation assertions
+// CRITICAL: Replaces the global allocation functions. Include from exactly
+//           ONE translation unit per test binary (replacement functions
+//           cannot be inline).
+// =========================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace glofica::xook::test {
+
+/// @brief Per-thread allocation counter (other threads never perturb a scope)
+inline thread_local uint64_t g_thread_allocations = 0;
+
+/// @brief Counts heap allocations made by the current thread while alive
+class AllocationScope {
+private:
+    uint64_t start_;
+
+public:
+    AllocationScope() : start_(g_thread_allocations) {}
+
+    [[nodiscard]] uint64_t count() const noexcept {
+        return g_thread_allocations - start_;
+    }
+};
+
+/// @brief Allocations performed by fn() on the calling thread
+template <typename Fn>
+[[nodiscard]] uint64_t count_allocations(Fn&& fn) {
+    AllocationScope scope;
+    fn();
+    return scope.count();
+}
+
+// The allocation and release functions below are paired and kept out of
+// line: once malloc()/free() inline into operator new/delete, GCC matches a
+// caller's operator new against the free() in operator delete and reports
+// -Wmismatched-new-delete. Opaque calls leave it operator new/delete.
+
+[[gnu::noinline]] inline void* counted_alloc(std::size_t size) {
+    ++g_thread_allocations;
+    if (size == 0) size = 1;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] inline void* counted_aligned_alloc(std::size_t size, std::align_val_t align) {
+    ++g_thread_allocations;
+    std::size_t a = static_cast<std::size_t>(align);
+    std::size_t rounded = (size + a - 1) / a * a;
+    if (rounded == 0) rounded = a;
+    if (void* p = std::aligned_alloc(a, rounded)) return p;
+    throw std::bad_alloc();
+}
+
+/// @brief Release for both counted_alloc() and counted_aligned_alloc()
+[[gnu::noinline]] inline void counted_free(void* p) noexcept {
+    std::free(p);
+}
+
+} // namespace glofica::xook::test
+
+// ===== GLOBAL REPLACEMENTS =====
+
+void* operator new(std::size_t size) { return glofica::xook::test::counted_alloc(size); }
+void* operator new[](std::size_t size) { return glofica::xook::test::counted_alloc(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return glofica::xook::test::counted_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return glofica::xook::test::counted_alloc(size); } catch (...) { return nullptr; }
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return glofica::xook::test::counted_aligned_alloc(size, align);
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return glofica::xook::test::counted_aligned_alloc(size, align);
+}
+
+void operator delete(void* p) noexcept { glofica::xook::test::counted_free(p); }
+void operator delete[](void* p) noexcept { glofica::xook::test::counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { glofica::xook::test::counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { glofica::xook::test::counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { glofica::xook::test::counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { glofica::xook::test::counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { glofica::xook::test::counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { glofica::xook::test::counted_free(p); }
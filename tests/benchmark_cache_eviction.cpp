@@ -0,0 +1,166 @@
+// =========================================================
+// FILE: tests/xook/benchmark_cache_eviction.cpp
+// PURPOSE: TreeCache miss rates, LRU vs GreedyDual, on Zipfian tree lookups
+// USAGE: ./benchmark_cache_eviction [keys] [lookups]
+// NOTE: Replays root-to-leaf traversals of a synthetic 16-ary tree against a
+//       byte-budgeted cache (as MemoryGovernor enforces it); every miss is one
+//       node read from the KVStore
+// =========================================================
+
+#include "../../src/xook/tree_cache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace glofica::xook;
+
+namespace {
+
+uint64_t splitmix(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/// @brief Key hashes (first 8 bytes suffice for path shape) and their leaf depths
+struct SyntheticTree {
+    std::vector<uint64_t> keys;        // Sorted
+    std::vector<uint8_t> leaf_depth;   // Nibbles from the root to the leaf
+
+    explicit SyntheticTree(size_t n) {
+        uint64_t state = 42;
+        keys.resize(n);
+        for (auto& k : keys) k = splitmix(state);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        auto common_nibbles = [](uint64_t a, uint64_t b) -> size_t {
+            return a == b ? 16 : static_cast<size_t>(__builtin_clzll(a ^ b)) / 4;
+        };
+        leaf_depth.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            size_t lcp = 0;
+            if (i > 0) lcp = std::max(lcp, common_nibbles(keys[i - 1], keys[i]));
+            if (i + 1 < keys.size()) lcp = std::max(lcp, common_nibbles(keys[i], keys[i + 1]));
+            leaf_depth[i] = static_cast<uint8_t>(lcp + 1);
+        }
+    }
+
+    static NodeKey node_key(uint64_t key, size_t depth) {
+        NodeKey nk;
+        nk.version = 1;
+        for (size_t d = 0; d < depth; ++d) nk.nibble_path.push(static_cast<uint8_t>((key >> (60 - 4 * d)) & 0x0F));
+        return nk;
+    }
+};
+
+/// @brief Zipf(s) over ranks [0, n) by inverse CDF; rank r maps to a random key
+class ZipfSampler {
+    std::vector<double> cdf_;
+    std::vector<uint32_t> rank_to_key_;
+    uint64_t state_;
+
+public:
+    ZipfSampler(size_t n, double s, uint64_t seed) : state_(seed) {
+        cdf_.resize(n);
+        double sum = 0;
+        for (size_t r = 0; r < n; ++r) cdf_[r] = (sum += 1.0 / std::pow(static_cast<double>(r + 1), s));
+        for (auto& c : cdf_) c /= sum;
+        rank_to_key_.resize(n);
+        for (size_t i = 0; i < n; ++i) rank_to_key_[i] = static_cast<uint32_t>(i);
+        for (size_t i = n - 1; i > 0; --i) std::swap(rank_to_key_[i], rank_to_key_[splitmix(state_) % (i + 1)]);
+    }
+
+    size_t next() {
+        double u = static_cast<double>(splitmix(state_) >> 11) * 0x1.0p-53;
+        size_t rank = static_cast<size_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin());
+        return rank_to_key_[std::min(rank, rank_to_key_.size() - 1)];
+    }
+};
+
+Node make_node(size_t depth, size_t leaf_depth, size_t tree_levels) {
+    if (depth == leaf_depth) {
+        LeafNode leaf;
+        leaf.account_key.fill(1);
+        leaf.value_hash.fill(2);
+        return leaf;
+    }
+    // Full fan-out in the dense top of the tree, sparse below it
+    InternalNode internal;
+    size_t children = depth + 1 < tree_levels ? 16 : 2;
+    for (uint8_t n = 0; n < children; ++n) internal.set_child(n, glofica::Hash{}, 1);
+    return internal;
+}
+
+struct RunResult {
+    double miss_ratio;      // Node misses / node accesses
+    double reads_per_get;   // KVStore reads per key lookup
+    double ns_per_access;
+};
+
+RunResult run(const SyntheticTree& tree, double s, size_t budget_bytes, EvictionPolicy policy, size_t lookups) {
+    TreeCache cache(SIZE_MAX);
+    cache.set_eviction_policy(policy);
+    ZipfSampler zipf(tree.keys.size(), s, 7);
+    size_t tree_levels = static_cast<size_t>(std::log(static_cast<double>(tree.keys.size())) / std::log(16.0));
+
+    uint64_t accesses = 0, misses = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i) {
+        size_t k = zipf.next();
+        size_t leaf_depth = tree.leaf_depth[k];
+        for (size_t d = 0; d <= leaf_depth; ++d) {
+            NodeKey key = SyntheticTree::node_key(tree.keys[k], d);
+            ++accesses;
+            if (cache.get_shared(key)) continue;
+            ++misses;
+            cache.put(key, make_node(d, leaf_depth, tree_levels));
+            if (cache.approx_bytes() > budget_bytes) cache.shrink_to_bytes(budget_bytes);
+        }
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return {static_cast<double>(misses) / accesses, static_cast<double>(misses) / lookups, elapsed / accesses};
+}
+
+/// @brief Resident bytes of the whole tree (every internal node and leaf)
+size_t full_tree_bytes(const SyntheticTree& tree) {
+    TreeCache cache(SIZE_MAX);
+    size_t tree_levels = static_cast<size_t>(std::log(static_cast<double>(tree.keys.size())) / std::log(16.0));
+    for (size_t k = 0; k < tree.keys.size(); ++k) {
+        for (size_t d = 0; d <= tree.leaf_depth[k]; ++d) {
+            cache.put(SyntheticTree::node_key(tree.keys[k], d), make_node(d, tree.leaf_depth[k], tree_levels));
+        }
+    }
+    return cache.approx_bytes();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 400'000;
+
+    std::cout << "=== TreeCache Eviction: LRU vs GreedyDual (Zipfian lookups) ===" << std::endl;
+    SyntheticTree tree(keys);
+    size_t total = full_tree_bytes(tree);
+    std::printf("%zu keys, %zu lookups, full tree %.1f MB\n\n", tree.keys.size(), lookups, total / 1048576.0);
+    std::printf("%-6s %-8s | %-22s | %-22s | %s\n", "zipf", "budget", "LRU miss (reads/get)", "GD miss (reads/get)", "miss reduction");
+
+    for (double s : {0.7, 0.9, 1.1}) {
+        for (double fraction : {0.02, 0.05, 0.15}) {
+            size_t budget = static_cast<size_t>(total * fraction);
+            RunResult lru = run(tree, s, budget, EvictionPolicy::LRU, lookups);
+            RunResult gd = run(tree, s, budget, EvictionPolicy::GreedyDual, lookups);
+            std::printf("%-6.1f %5.0f%%   | %6.2f%% (%5.2f)        | %6.2f%% (%5.2f)        | %5.1f%%  [%.0f / %.0f ns]\n",
+                        s, fraction * 100, lru.miss_ratio * 100, lru.reads_per_get, gd.miss_ratio * 100,
+                        gd.reads_per_get, (1.0 - gd.miss_ratio / lru.miss_ratio) * 100,
+                        lru.ns_per_access, gd.ns_per_access);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+// =========================================================
+// FILE: tests/xook/benchmark_harness.hpp
+// PURPOSE: Micro-benchmark harness with optional hardware counters
+// NOTE: Counters use perf_event_open (Linux). Anywhere else, or when the
+//       kernel refuses (perf_event_paranoid, containers, SGX), the harness
+//       reports timing only.
+// =========================================================
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace glofica::xook::bench {
+
+/// @brief Hardware events read around each benchmark case
+enum class PerfEvent : size_t {
+    Cycles = 0,
+    Instructions,
+    L1DMisses,
+    LLCMisses,
+    BranchMisses,
+    DTLBMisses,
+    Count
+};
+
+inline constexpr size_t PERF_EVENT_COUNT = static_cast<size_t>(PerfEvent::Count);
+
+/// @brief Counter values for one measured region (nullopt = counter unavailable)
+struct PerfSample {
+    std::array<std::optional<uint64_t>, PERF_EVENT_COUNT> values{};
+
+    [[nodiscard]] std::optional<uint64_t> get(PerfEvent e) const {
+        return values[static_cast<size_t>(e)];
+    }
+
+    [[nodiscard]] std::optional<double> ipc() const {
+        auto cycles = get(PerfEvent::Cycles);
+        auto instructions = get(PerfEvent::Instructions);
+        if (!cycles || !instructions || *cycles == 0) return std::nullopt;
+        return static_cast<double>(*instructions) / static_cast<double>(*cycles);
+    }
+};
+
+/// @brief Independently opened perf counters (no group: tolerates small PMUs)
+///
+/// Each counter is scaled by time_enabled/time_running, so multiplexing
+/// when more events than hardware counters are requested stays unbiased.
+class PerfCounters {
+private:
+    std::array<int, PERF_EVENT_COUNT> fds_;
+
+#if defined(__linux__)
+    static int open_event(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;  // Works with perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+        return cache | (op << 8) | (result << 16);
+    }
+#endif
+
+public:
+    PerfCounters() {
+        fds_.fill(-1);
+#if defined(__linux__)
+        fds_[static_cast<size_t>(PerfEvent::Cycles)] =
+            open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds_[static_cast<size_t>(PerfEvent::Instructions)] =
+            open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds_[static_cast<size_t>(PerfEvent::L1DMisses)] =
+            open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D,
+                                                       PERF_COUNT_HW_CACHE_OP_READ,
+                                                       PERF_COUNT_HW_CACHE_RESULT_MISS));
+        fds_[static_cast<size_t>(PerfEvent::LLCMisses)] =
+            open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds_[static_cast<size_t>(PerfEvent::BranchMisses)] =
+            open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds_[static_cast<size_t>(PerfEvent::DTLBMisses)] =
+            open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB,
+                                                       PERF_COUNT_HW_CACHE_OP_READ,
+                                                       PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /// @brief True if at least one counter could be opened
+    [[nodiscard]] bool available() const {
+        for (int fd : fds_) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    [[nodiscard]] PerfSample stop() {
+        PerfSample sample;
+#if defined(__linux__)
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            int fd = fds_[i];
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+            uint64_t buf[3] = {0, 0, 0};  // value, time_enabled, time_running
+            if (read(fd, buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)) || buf[2] == 0) {
+                continue;  // Never scheduled: report as unavailable
+            }
+            double scale = static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+            sample.values[i] = static_cast<uint64_t>(static_cast<double>(buf[0]) * scale);
+        }
+#endif
+        return sample;
+    }
+};
+
+/// @brief Result of one benchmark case
+struct BenchmarkResult {
+    std::string name;
+    uint64_t ops = 0;
+    double ns_per_op = 0.0;
+    PerfSample counters;
+
+    [[nodiscard]] std::optional<double> per_op(PerfEvent e) const {
+        auto v = counters.get(e);
+        if (!v || ops == 0) return std::nullopt;
+        return static_cast<double>(*v) / static_cast<double>(ops);
+    }
+};
+
+/// @brief Harness options (parse from argv: --perf enables counters)
+struct BenchmarkOptions {
+    bool use_perf_counters = false;
+    uint64_t warmup_ops = 1000;
+
+    static BenchmarkOptions from_args(int argc, char** argv) {
+        BenchmarkOptions opts;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--perf") == 0) opts.use_perf_counters = true;
+        }
+        return opts;
+    }
+};
+
+/// @brief Runs cases and prints ns/op next to IPC and misses/op
+class BenchmarkHarness {
+private:
+    BenchmarkOptions options_;
+    std::optional<PerfCounters> counters_;
+    std::vector<BenchmarkResult> results_;
+
+    static void print_metric(std::optional<double> v, const char* fmt) {
+        if (v) {
+            std::printf(fmt, *v);
+        } else {
+            std::printf(" %10s", "n/a");
+        }
+    }
+
+public:
+    explicit BenchmarkHarness(BenchmarkOptions options = {}) : options_(options) {
+        if (options_.use_perf_counters) {
+            counters_.emplace();
+            if (!counters_->available()) {
+                std::printf("⚠️  perf_event_open unavailable (check perf_event_paranoid); timing only\n");
+                counters_.reset();
+            }
+        }
+        std::printf("%-36s %12s %10s %10s %10s %10s %10s\n",
+                    "case", "ns/op", "IPC", "L1D/op", "LLC/op", "brmiss/op", "dTLB/op");
+    }
+
+    /// @brief Time `ops` invocations of fn(i); fn must not be optimized away by the caller
+    template <typename Fn>
+    const BenchmarkResult& run(const std::string& name, uint64_t ops, Fn&& fn) {
+        for (uint64_t i = 0; i < options_.warmup_ops; ++i) fn(i);
+
+        BenchmarkResult result;
+        result.name = name;
+        result.ops = ops;
+
+        if (counters_) counters_->start();
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < ops; ++i) fn(i);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        if (counters_) result.counters = counters_->stop();
+
+        result.ns_per_op = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(ops);
+
+        std::printf("%-36s %12.2f", name.c_str(), result.ns_per_op);
+        print_metric(result.counters.ipc(), " %10.2f");
+        print_metric(result.per_op(PerfEvent::L1DMisses), " %10.3f");
+        print_metric(result.per_op(PerfEvent::LLCMisses), " %10.3f");
+        print_metric(result.per_op(PerfEvent::BranchMisses), " %10.3f");
+        print_metric(result.per_op(PerfEvent::DTLBMisses), " %10.3f");
+        std::printf("\n");
+
+        results_.push_back(std::move(result));
+        return results_.back();
+    }
+
+    [[nodiscard]] const std::vector<BenchmarkResult>& results() const { return results_; }
+};
+
+/// @brief Prevent the optimizer from discarding a computed value
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace glofica::xook::bench
@@ -0,0 +1,85 @@
+// =========================================================
+// FILE: tests/xook/benchmark_xook_ops.cpp
+// PURPOSE: Hot-path micro-benchmarks (POPCNT navigation, hashing, cache)
+// USAGE: ./benchmark_xook_ops [--perf]
+// =========================================================
+
+#include "benchmark_harness.hpp"
+#include "node_fixtures.hpp"
+#include "../../src/xook/node_serde.hpp"
+#include "../../src/xook/tree_cache.hpp"
+#include <iostream>
+
+using namespace glofica::xook;
+using namespace glofica::xook::bench;
+using glofica::xook::test::make_full_internal;
+
+int main(int argc, char** argv) {
+    std::cout << "=== XOOK Hot-Path Benchmarks ===" << std::endl;
+    BenchmarkHarness harness(BenchmarkOptions::from_args(argc, argv));
+
+    // 1. POPCNT navigation
+    SparseBitmap bitmap(0xA5C3);
+    harness.run("SparseBitmap::get_index", 10'000'000, [&](uint64_t i) {
+        do_not_optimize(bitmap.get_index(static_cast<uint8_t>(i & 0x0F)));
+    });
+
+    // 2. Node hashing
+    InternalNode internal = make_full_internal();
+    harness.run("InternalNode::hash (16 children)", 200'000, [&](uint64_t) {
+        do_not_optimize(internal.hash());
+    });
+
+    LeafNode leaf;
+    leaf.account_key.fill(0xAA);
+    leaf.value_hash.fill(0xBB);
+    harness.run("LeafNode::hash", 1'000'000, [&](uint64_t) {
+        do_not_optimize(leaf.hash());
+    });
+
+    // 3. Serde round trip
+    auto internal_bytes = serialize_node_with_prefix(internal);
+    harness.run("deserialize InternalNode", 500'000, [&](uint64_t) {
+        do_not_optimize(deserialize_node_from_bytes(internal_bytes));
+    });
+
+    // 4. Cache hits on a resident working set (64K nodes)
+    constexpr uint64_t WORKING_SET = 1 << 16;
+    TreeCache cache(WORKING_SET);
+    std::vector<NodeKey> keys;
+    keys.reserve(WORKING_SET);
+    for (uint64_t i = 0; i < WORKING_SET; ++i) {
+        NodeKey key;
+        key.version = 1;
+        for (int n = 0; n < 4; ++n) key.nibble_path.push(static_cast<uint8_t>((i >> (4 * n)) & 0x0F));
+        cache.put(key, leaf);
+        keys.push_back(std::move(key));
+    }
+    harness.run("TreeCache::get (hit, 64K set)", 2'000'000, [&](uint64_t i) {
+        // Multiplicative stride defeats the hardware prefetcher
+        do_not_optimize(cache.get(keys[(i * 40503) & (WORKING_SET - 1)]));
+    });
+
+    cache.enable_thread_local_l1();
+    harness.run("TreeCache::get_shared (L1, 1K hot set)", 2'000'000, [&](uint64_t i) {
+        do_not_optimize(cache.get_shared(keys[(i * 40503) & 1023]));
+    });
+
+    cache.enable_committed_index();
+    cache.publish_committed(1);
+    harness.run("TreeCache::visit_committed (64K set)", 2'000'000, [&](uint64_t i) {
+        cache.visit_committed(keys[(i * 40503) & (WORKING_SET - 1)], [](const Node& node) {
+            do_not_optimize(node.index());
+        });
+    });
+
+    // 5. Path construction
+    harness.run("NibblePath push/pop x64", 500'000, [&](uint64_t i) {
+        NibblePath path;
+        for (uint8_t n = 0; n < 64; ++n) path.push(static_cast<uint8_t>((i + n) & 0x0F));
+        for (uint8_t n = 0; n < 64; ++n) path.pop();
+        do_not_optimize(path.size());
+    });
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+// =========================================================
+// FILE: tests/xook/node_fixtures.hpp
+// PURPOSE: Node keys and nodes shared by the cache, store and verifier tests
+// =========================================================
+
+#pragma once
+
+#include "../../src/xook/node_type.hpp"
+#include "../../src/xook/nibble_path.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace glofica::xook::test {
+
+/// @brief Key at `version` whose path is the low `depth` nibbles of `id`, lowest first
+inline NodeKey make_key(uint64_t version, uint64_t id, size_t depth = 4) {
+    NodeKey key;
+    key.version = version;
+    for (size_t n = 0; n < depth; ++n) key.nibble_path.push(static_cast<uint8_t>((id >> (4 * n)) & 0x0F));
+    return key;
+}
+
+/// @brief Key at `version` with an explicit path ({} = root)
+inline NodeKey key_at(uint64_t version, std::initializer_list<uint8_t> nibbles) {
+    NodeKey key{version, NibblePath()};
+    for (uint8_t n : nibbles) key.nibble_path.push(n);
+    return key;
+}
+
+inline LeafNode make_leaf(uint8_t account_fill, uint8_t value_fill) {
+    LeafNode leaf;
+    leaf.account_key.fill(account_fill);
+    leaf.value_hash.fill(value_fill);
+    return leaf;
+}
+
+inline LeafNode make_leaf(uint8_t fill) {
+    return make_leaf(fill, fill);
+}
+
+/// @brief Internal node with all 16 children set (the largest node shape)
+inline InternalNode make_full_internal(uint64_t child_version = 7) {
+    InternalNode node;
+    for (uint8_t n = 0; n < 16; ++n) {
+        glofica::Hash h{};
+        h.fill(static_cast<uint8_t>(n + 1));
+        node.set_child(n, h, child_version);
+    }
+    return node;
+}
+
+} // namespace glofica::xook::test
@@ -0,0 +1,243 @@
+// =========================================================
+// FILE: tests/xook/test_adaptive_cache_sizing.cpp
+// PURPOSE: Ghost entries, AdaptiveCacheSizer grow/shrink decisions, adapter stats
+// =========================================================
+
+#include "../../src/xook/adaptive_cache_sizer.hpp"
+#include "../../src/xook/numa_tree_cache.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+using glofica::Hash;
+using glofica::Bytes;
+using namespace std::chrono_literals;
+
+/// @brief Read-through lookup as XookTree does it; misses cost `miss_ns` at the "store"
+static void lookup(TreeCache& cache, LatencyHistogram& store, uint64_t id, uint64_t miss_ns) {
+    if (cache.get_shared(make_key(1, id, 5))) return;
+    store.record(miss_ns);
+    cache.put(make_key(1, id, 5), make_leaf(static_cast<uint8_t>(id)));
+}
+
+void test_ghost_entries() {
+    std::cout << "[TEST] Ghost entries count hits a larger cache would have had..." << std::endl;
+
+    TreeCache cache(10);
+    cache.set_ghost_capacity(5);
+    for (uint64_t id = 0; id < 20; ++id) cache.put(make_key(1, id, 5), make_leaf(static_cast<uint8_t>(id)));
+
+    // Evicted 0..9; ghosts remember the last 5 evictions (5..9)
+    assert(cache.feedback().ghost_entries == 5);
+    assert(!cache.get_shared(make_key(1, 7, 5)));
+    assert(!cache.get_shared(make_key(1, 2, 5)));
+    assert(!cache.get_shared(make_key(1, 99, 5)));
+    CacheFeedback f = cache.feedback();
+    assert(f.misses == 3 && f.ghost_hits == 1);
+    assert(!cache.get_shared(make_key(1, 7, 5)) && cache.feedback().ghost_hits == 1);  // Consumed
+
+    cache.set_ghost_capacity(0);
+    assert(cache.feedback().ghost_entries == 0);
+    cache.put(make_key(1, 30, 5), make_leaf(30));
+    assert(!cache.get_shared(make_key(1, 10, 5)) && cache.feedback().ghost_hits == 1);
+    std::cout << "  ✅ misses=" << cache.feedback().misses << ", 1 ghost hit" << std::endl;
+}
+
+void test_grows_for_working_set() {
+    std::cout << "[TEST] Grows while a looping working set misses, shrinks when idle..." << std::endl;
+
+    TreeCache cache(100);
+    LatencyHistogram store;
+    AdaptiveSizingConfig config;
+    config.min_capacity = 60;
+    config.max_capacity = 400;
+    config.interval = 100ms;
+    AdaptiveCacheSizer sizer(&cache, &store, config);
+
+    auto now = std::chrono::steady_clock::time_point{};
+    assert(!sizer.tick(now));  // Baseline
+
+    // Looping working sets just beyond the cache (within one ghost step): each grows it
+    for (uint64_t working_set : {120, 150}) {
+        for (int interval = 0; interval < 4 && cache.capacity() < working_set; ++interval) {
+            for (int round = 0; round < 20; ++round) {
+                for (uint64_t id = 0; id < working_set; ++id) lookup(cache, store, id, 50'000);
+            }
+            now += 100ms;
+            auto d = sizer.tick(now);
+            assert(d && d->action == SizingAction::Grow && d->ghost_hits > 0 && d->miss_ns == 50'000);
+        }
+        assert(cache.capacity() >= working_set);
+    }
+    size_t grown = cache.capacity();
+
+    // Working set now fits: no misses
+    for (uint64_t id = 0; id < 150; ++id) lookup(cache, store, id, 50'000);
+    CacheFeedback before = cache.feedback();
+    for (int round = 0; round < 20; ++round) {
+        for (uint64_t id = 0; id < 150; ++id) lookup(cache, store, id, 50'000);
+    }
+    assert(cache.feedback().misses == before.misses);
+
+    now += 100ms;
+    sizer.tick(now);  // Settles the warm-up misses
+
+    // Idle: after the cooldown, half-steps down to the floor
+    size_t shrinks = 0;
+    for (int interval = 0; interval < 30; ++interval) {
+        now += 100ms;
+        auto d = sizer.tick(now);
+        assert(d && d->action != SizingAction::Grow);
+        if (d->action == SizingAction::Shrink) ++shrinks;
+    }
+    assert(shrinks > 0 && cache.capacity() == config.min_capacity);
+    assert(sizer.stats().grows >= 2 && sizer.stats().shrinks == shrinks);
+    std::cout << "  ✅ 100 → " << grown << " under load, → " << cache.capacity() << " idle ("
+              << sizer.stats().grows << " grows, " << shrinks << " shrinks)" << std::endl;
+}
+
+void test_cheap_misses_and_bounds() {
+    std::cout << "[TEST] Cheap misses do not grow; bounds and interval respected..." << std::endl;
+
+    TreeCache cache(1000);
+    LatencyHistogram store;
+    AdaptiveSizingConfig config;
+    config.min_capacity = 50;
+    config.max_capacity = 120;
+    config.interval = 100ms;
+    config.shrink_cooldown = 0;
+    AdaptiveCacheSizer sizer(&cache, &store, config);
+    assert(cache.capacity() == 120);  // Clamped on bind
+
+    auto now = std::chrono::steady_clock::time_point{};
+    sizer.tick(now);
+    for (int round = 0; round < 5; ++round) {
+        for (uint64_t id = 0; id < 130; ++id) lookup(cache, store, id, 1);  // In-memory store: ~free misses
+    }
+    assert(!sizer.tick(now + 50ms));  // Inside the interval
+    now += 100ms;
+    auto d = sizer.tick(now);
+    assert(d && d->ghost_hits > 0 && d->action == SizingAction::Shrink);
+    assert(cache.capacity() < 120);
+
+    // Expensive misses: grows, but never past max
+    for (int i = 0; i < 10; ++i) {
+        for (int round = 0; round < 5; ++round) {
+            for (uint64_t id = 0; id < 130; ++id) lookup(cache, store, id, 1'000'000);
+        }
+        now += 100ms;
+        sizer.tick(now);
+        assert(cache.capacity() <= 120);
+    }
+    assert(cache.capacity() == 120);
+    std::cout << "  ✅ Capacity held within [50, 120]" << std::endl;
+}
+
+void test_numa_feedback() {
+    std::cout << "[TEST] NUMA cache splits capacity and sums feedback..." << std::endl;
+
+    NumaTreeCache cache(1000, 2);
+    size_t shards = cache.node_count();
+    cache.set_capacity(400);
+    assert(cache.capacity() == (400 / shards) * shards);
+    cache.set_ghost_capacity(100);
+    for (uint64_t id = 0; id < 2000; ++id) cache.put(make_key(1, id, 5), make_leaf(static_cast<uint8_t>(id)));
+    for (uint64_t id = 1990; id > 1900; --id) cache.get_shared(make_key(1, id - 500, 5));
+    CacheFeedback f = cache.feedback();
+    assert(f.misses == 90 && f.ghost_entries > 0);
+    std::cout << "  ✅ " << shards << " shard(s), " << f.ghost_hits << " ghost hits" << std::endl;
+}
+
+void test_adapter_stats() {
+    std::cout << "[TEST] XookAdapter exposes sizing decisions..." << std::endl;
+
+    XookAdapter adapter;
+    AdaptiveSizingConfig config;
+    config.min_capacity = 1'000;
+    config.max_capacity = 200'000;
+    config.interval = 0ms;
+    adapter.enable_adaptive_cache_sizing(config);
+
+    Hash root{};
+    for (uint64_t v = 1; v <= 4; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 40; ++i) {
+            Hash value;
+            value.fill(static_cast<uint8_t>(i + v));
+            updates.emplace_back(Bytes{static_cast<uint8_t>(i), 0x77}, value);
+        }
+        root = adapter.calculate_root(updates, root, v).new_root_hash;
+    }
+
+    AdapterStats stats = adapter.stats();
+    assert(stats.cache_sizing.enabled);
+    assert(stats.cache_sizing.grows + stats.cache_sizing.shrinks + stats.cache_sizing.holds >= 3);
+    assert(stats.cache_capacity >= config.min_capacity && stats.cache_capacity <= config.max_capacity);
+    std::string text = stats.to_prometheus();
+    assert(text.find("xook_cache_capacity ") != std::string::npos);
+    assert(text.find("xook_cache_sizing_shrinks_total") != std::string::npos);
+    assert(text.find("op=\"store_read\"") != std::string::npos);
+
+    adapter.enable_numa_cache();  // Sizer follows the new cache
+    adapter.disable_adaptive_cache_sizing();
+    assert(!adapter.stats().cache_sizing.enabled);
+    std::cout << "  ✅ capacity " << stats.cache_capacity << " after " << stats.cache_sizing.shrinks << " shrinks" << std::endl;
+}
+
+void test_stats_read_while_writer_resizes() {
+    std::cout << "[TEST] capacity() / stats() read while the writer resizes..." << std::endl;
+
+    XookAdapter adapter;
+    AdaptiveSizingConfig config;
+    config.min_capacity = 1'000;
+    config.max_capacity = 200'000;
+    config.interval = 0ms;
+    config.shrink_cooldown = 0;
+    adapter.enable_adaptive_cache_sizing(config);
+
+    // Metrics scraper: runs against every tick (TSan flags unsynchronized reads)
+    std::atomic<bool> stop{false};
+    uint64_t scrapes = 0;
+    std::thread scraper([&] {
+        while (!stop.load()) {
+            AdapterStats s = adapter.stats();
+            assert(s.cache_capacity >= config.min_capacity && s.cache_capacity <= config.max_capacity);
+            ++scrapes;
+        }
+    });
+
+    Hash root{};
+    for (uint64_t v = 1; v <= 50; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 20; ++i) {
+            Hash value;
+            value.fill(static_cast<uint8_t>(i + v));
+            updates.emplace_back(Bytes{static_cast<uint8_t>(i), 0x55}, value);
+        }
+        root = adapter.calculate_root(updates, root, v).new_root_hash;
+    }
+    stop = true;
+    scraper.join();
+    SizingStats sizing = adapter.stats().cache_sizing;
+    assert(sizing.grows + sizing.shrinks + sizing.holds >= 49);
+    std::cout << "  ✅ " << scrapes << " scrapes during 50 commits" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== ADAPTIVE CACHE SIZING TESTS ===\n" << std::endl;
+
+    test_ghost_entries();
+    test_grows_for_working_set();
+    test_cheap_misses_and_bounds();
+    test_numa_feedback();
+    test_adapter_stats();
+    test_stats_read_while_writer_resizes();
+
+    std::cout << "\n=== ALL ADAPTIVE CACHE SIZING TESTS PASSED ===" << std::endl;
+    return 0;
+}
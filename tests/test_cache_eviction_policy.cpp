@@ -0,0 +1,142 @@
+// =========================================================
+// FILE: tests/xook/test_cache_eviction_policy.cpp
+// PURPOSE: TreeCache GreedyDual eviction: depth/size/hit weighting, policy switch
+// =========================================================
+
+#include "../../src/xook/tree_cache.hpp"
+#include "../../src/xook/numa_tree_cache.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+using glofica::Hash;
+using glofica::Bytes;
+
+static InternalNode make_internal(size_t children) {
+    InternalNode node;
+    for (uint8_t n = 0; n < children; ++n) node.set_child(n, Hash{}, 1);
+    return node;
+}
+
+void test_lru_unchanged() {
+    std::cout << "[TEST] LRU policy (default) evicts least recently used..." << std::endl;
+
+    TreeCache cache(3);
+    assert(cache.eviction_policy() == EvictionPolicy::LRU);
+    cache.put(make_key(1, 1, 2), make_internal(16));
+    cache.put(make_key(1, 2, 8), make_leaf(2));
+    cache.put(make_key(1, 3, 8), make_leaf(3));
+    cache.put(make_key(1, 4, 8), make_leaf(4));  // Evicts the internal node, however costly
+    assert(!cache.get_shared(make_key(1, 1, 2)));
+    assert(cache.size() == 3);
+    std::cout << "  ✅ Oldest entry evicted" << std::endl;
+}
+
+/// @brief Internal-node misses when the 16 depth-1 nodes are revisited between scans of one-shot leaves
+static size_t internal_misses(EvictionPolicy policy) {
+    TreeCache cache(40);
+    cache.set_eviction_policy(policy);
+    size_t misses = 0;
+    uint64_t leaf_id = 0;
+    for (int round = 0; round < 200; ++round) {
+        for (uint64_t i = 0; i < 16; ++i) {
+            if (cache.get_shared(make_key(1, i, 1))) continue;
+            ++misses;
+            cache.put(make_key(1, i, 1), make_internal(16));
+        }
+        for (int j = 0; j < 30; ++j, ++leaf_id) cache.put(make_key(1, 1000 + leaf_id, 10), make_leaf(1));
+    }
+    return misses;
+}
+
+void test_greedy_dual_keeps_upper_levels() {
+    std::cout << "[TEST] GreedyDual keeps reused upper nodes through leaf scans..." << std::endl;
+
+    size_t lru = internal_misses(EvictionPolicy::LRU);
+    size_t gd = internal_misses(EvictionPolicy::GreedyDual);
+    assert(lru == 200 * 16);  // 16 + 30 > 40: LRU flushes them every round
+    assert(gd == 16);         // Cold start only: hits then outweigh the scans
+    std::cout << "  ✅ Internal-node misses: LRU " << lru << ", GreedyDual " << gd << std::endl;
+}
+
+void test_hits_and_aging() {
+    std::cout << "[TEST] Hit counts protect hot leaves; unused entries age out..." << std::endl;
+
+    TreeCache cache(20);
+    cache.set_eviction_policy(EvictionPolicy::GreedyDual);
+    cache.put(make_key(1, 7, 10), make_leaf(7));
+    cache.put(make_key(1, 9, 3), make_internal(16));  // Costly but never hit again
+    for (uint64_t i = 0; i < 5000; ++i) {
+        cache.get_shared(make_key(1, 7, 10));  // Hot leaf
+        cache.put(make_key(1, 100 + i, 10), make_leaf(static_cast<uint8_t>(i)));
+    }
+    assert(cache.get_shared(make_key(1, 7, 10)));
+    assert(!cache.get_shared(make_key(1, 9, 3)));  // Inflation caught up with it
+    std::cout << "  ✅ Hot leaf kept, idle internal node eventually evicted" << std::endl;
+}
+
+void test_switch_policy_and_shrink() {
+    std::cout << "[TEST] Policy switch keeps entries; byte shrink evicts by priority..." << std::endl;
+
+    TreeCache cache(1000);
+    for (uint64_t i = 0; i < 16; ++i) cache.put(make_key(1, i, 1), make_internal(16));
+    for (uint64_t i = 0; i < 200; ++i) cache.put(make_key(1, i, 9), make_leaf(static_cast<uint8_t>(i)));
+    size_t entries = cache.size();
+
+    cache.set_eviction_policy(EvictionPolicy::GreedyDual);
+    assert(cache.size() == entries && cache.eviction_policy() == EvictionPolicy::GreedyDual);
+
+    cache.shrink_to_bytes(cache.approx_bytes() / 2);
+    for (uint64_t i = 0; i < 16; ++i) assert(cache.get_shared(make_key(1, i, 1)));  // Depth 1 weighted x8
+
+    cache.set_eviction_policy(EvictionPolicy::LRU);
+    cache.put(make_key(1, 999, 9), make_leaf(1));
+    cache.clear();
+    assert(cache.size() == 0 && cache.approx_bytes() == 0);
+
+    // Forwarded to every NUMA partition
+    NumaTreeCache numa(100, 2);
+    numa.set_eviction_policy(EvictionPolicy::GreedyDual);
+    numa.put(make_key(1, 3, 4), make_leaf(3));
+    assert(numa.get_shared(make_key(1, 3, 4)));
+    std::cout << "  ✅ Entries preserved across switches" << std::endl;
+}
+
+void test_adapter_policy() {
+    std::cout << "[TEST] XookAdapter with GreedyDual eviction: same roots..." << std::endl;
+
+    XookAdapter gd;
+    gd.set_cache_eviction_policy(EvictionPolicy::GreedyDual);
+    gd.enable_cold_tier(size_t{1} << 20);  // Cache swap keeps the policy
+    XookAdapter lru;
+
+    Hash gd_root{}, lru_root{};
+    for (uint64_t v = 1; v <= 3; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 300; ++i) {
+            Hash value;
+            value.fill(static_cast<uint8_t>(i * v));
+            updates.emplace_back(Bytes{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)}, value);
+        }
+        gd_root = gd.calculate_root(updates, gd_root, v).new_root_hash;
+        lru_root = lru.calculate_root(updates, lru_root, v).new_root_hash;
+        assert(gd_root == lru_root);
+    }
+    std::cout << "  ✅ Roots match over 3 versions" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== CACHE EVICTION POLICY TESTS ===\n" << std::endl;
+
+    test_lru_unchanged();
+    test_greedy_dual_keeps_upper_levels();
+    test_hits_and_aging();
+    test_switch_policy_and_shrink();
+    test_adapter_policy();
+
+    std::cout << "\n=== ALL CACHE EVICTION POLICY TESTS PASSED ===" << std::endl;
+    return 0;
+}
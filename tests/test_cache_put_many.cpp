@@ -0,0 +1,220 @@
+// =========================================================
+// FILE: tests/xook/test_cache_put_many.cpp
+// PURPOSE: TreeCache::put_many: put()-equivalence, bulk eviction, partitions, commit buffer
+// =========================================================
+
+#include "../../src/xook/tree_cache.hpp"
+#include "../../src/xook/numa_tree_cache.hpp"
+#include "../../src/xook/tiered_tree_cache.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <chrono>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+using glofica::Hash;
+using glofica::Bytes;
+
+using NodeBatch = std::vector<std::pair<NodeKey, Node>>;
+
+static Node make_node(uint64_t id, size_t children) {
+    if (children == 0) {
+        LeafNode leaf;
+        leaf.account_key.fill(static_cast<uint8_t>(id));
+        leaf.value_hash.fill(static_cast<uint8_t>(id >> 8));
+        return leaf;
+    }
+    InternalNode node;
+    for (uint8_t n = 0; n < children; ++n) {
+        Hash h;
+        h.fill(static_cast<uint8_t>(id + n));
+        node.set_child(n, h, 1);
+    }
+    return node;
+}
+
+static bool same_node(const Node& a, const Node& b) {
+    return serialize_node_with_prefix(a) == serialize_node_with_prefix(b);
+}
+
+/// @brief 30 nodes at version 2, the first 5 replacing version-1 keys already cached
+static NodeBatch make_batch() {
+    NodeBatch batch;
+    for (uint64_t id = 0; id < 5; ++id) batch.emplace_back(make_key(1, id), make_node(id + 100, 3));
+    for (uint64_t id = 0; id < 25; ++id) batch.emplace_back(make_key(2, id), make_node(id, id % 4 == 0 ? 16 : 0));
+    return batch;
+}
+
+void test_matches_sequential_put(EvictionPolicy policy) {
+    std::cout << "[TEST] put_many == put per node (" << (policy == EvictionPolicy::LRU ? "LRU" : "GreedyDual")
+              << ")..." << std::endl;
+
+    TreeCache sequential(50), batched(50);
+    for (TreeCache* cache : {&sequential, &batched}) {
+        cache->set_eviction_policy(policy);
+        for (uint64_t id = 0; id < 40; ++id) cache->put(make_key(1, id), make_node(id, id % 3 == 0 ? 8 : 0));
+    }
+
+    NodeBatch batch = make_batch();
+    for (const auto& [key, node] : batch) sequential.put(key, node);
+    batched.put_many(batch);
+
+    assert(batched.size() == sequential.size() && batched.size() == 50);
+
+    // Every batch node resident, replacements visible
+    for (const auto& [key, node] : batch) assert(same_node(*batched.get_shared(key), node));
+    if (policy == EvictionPolicy::GreedyDual) {
+        std::cout << "  ✅ Same size, whole batch resident" << std::endl;
+        return;
+    }
+
+    // LRU: same survivors and the same eviction order afterwards
+    assert(batched.approx_bytes() == sequential.approx_bytes());
+    auto resident = [](TreeCache& cache, const NodeKey& key) { return cache.get_shared(key) != nullptr; };
+    for (uint64_t id = 0; id < 40; ++id) assert(resident(batched, make_key(1, id)) == resident(sequential, make_key(1, id)));
+    for (uint64_t id = 0; id < 40; ++id) {
+        sequential.put(make_key(3, id), make_node(id, 0));
+        batched.put(make_key(3, id), make_node(id, 0));
+    }
+    for (uint64_t v : {1, 2, 3}) {
+        for (uint64_t id = 0; id < 40; ++id) assert(resident(batched, make_key(v, id)) == resident(sequential, make_key(v, id)));
+    }
+    std::cout << "  ✅ Same contents, bytes and later victims" << std::endl;
+}
+
+void test_bulk_eviction_and_l1() {
+    std::cout << "[TEST] Bulk eviction, oversized batch, L1 invalidation..." << std::endl;
+
+    TreeCache cache(10);
+    cache.enable_thread_local_l1();
+    size_t evicted = 0;
+    cache.set_eviction_listener([&evicted](const NodeKey&, const NodeHandle&, bool) { ++evicted; });
+
+    for (uint64_t id = 0; id < 10; ++id) cache.put(make_key(1, id), make_node(id, 0));
+    assert(same_node(*cache.get_shared(make_key(1, 9)), make_node(9, 0)));  // Now in L1
+
+    NodeBatch batch;
+    batch.emplace_back(make_key(1, 9), make_node(900, 0));  // Replacement
+    for (uint64_t id = 0; id < 25; ++id) batch.emplace_back(make_key(2, id), make_node(id, 2));
+    cache.put_many(batch);
+
+    // Only the last 10 batch nodes fit; the replaced node is stale in no L1
+    assert(cache.size() == 10);
+    assert(evicted == 10 + 16);
+    for (uint64_t id = 15; id < 25; ++id) assert(cache.get_shared(make_key(2, id)));
+    assert(!cache.get_shared(make_key(1, 9)));
+    assert(!cache.get_shared(make_key(2, 0)));
+
+    cache.put_many({});
+    assert(cache.size() == 10);
+    std::cout << "  ✅ " << evicted << " evictions delivered after the batch" << std::endl;
+}
+
+void test_partitioned_caches() {
+    std::cout << "[TEST] NUMA and tiered caches route the batch..." << std::endl;
+
+    NumaTreeCache numa(1000, 2);
+    NodeBatch batch;
+    for (uint64_t id = 0; id < 16; ++id) batch.emplace_back(make_key(5, id, 1), make_node(id, 16));
+    for (uint64_t id = 0; id < 200; ++id) batch.emplace_back(make_key(5, id, 3), make_node(id, 0));
+    numa.put_many(batch);
+    for (const auto& [key, node] : batch) assert(same_node(*numa.get_shared(key), node));
+
+    TieredTreeCache tiered(8, size_t{1} << 20);
+    for (uint64_t id = 0; id < 40; ++id) tiered.put(make_key(5, id), make_node(id, 4));
+    assert(tiered.cold().size() == 32);
+    NodeBatch replacements;
+    for (uint64_t id = 0; id < 4; ++id) replacements.emplace_back(make_key(5, id), make_node(id + 50, 4));
+    tiered.put_many(replacements);
+    for (uint64_t id = 0; id < 4; ++id) assert(same_node(*tiered.get_shared(make_key(5, id)), make_node(id + 50, 4)));
+    std::cout << "  ✅ Shards, replicas and tiers hold the batch; no stale cold copy" << std::endl;
+}
+
+/// @brief Counts put_many batches reaching the main cache
+class CountingCache : public TreeCache {
+public:
+    size_t batches = 0;
+    using TreeCache::TreeCache;
+    void put_many(const NodeBatch& nodes) override {
+        ++batches;
+        TreeCache::put_many(nodes);
+    }
+};
+
+void test_commit_buffer() {
+    std::cout << "[TEST] Commit buffer: read-your-writes, one flush..." << std::endl;
+
+    CountingCache main_cache(100);
+    main_cache.put(make_key(1, 7), make_node(7, 0));
+
+    CommitBufferCache buffer(&main_cache);
+    buffer.begin();
+    buffer.put(make_key(2, 1), make_node(1, 0));
+    buffer.put(make_key(2, 1), make_node(11, 0));  // Rewritten within the commit
+    buffer.put(make_key(2, 2), make_node(2, 5));
+    assert(same_node(*buffer.get_shared(make_key(2, 1)), make_node(11, 0)));
+    assert(same_node(*buffer.get(make_key(1, 7)), make_node(7, 0)));  // Falls through to the main cache
+    assert(!main_cache.get_shared(make_key(2, 1)));
+    std::thread([&] { assert(!buffer.get_shared(make_key(2, 1))); }).join();  // Other threads: main cache only
+
+    buffer.flush();
+    assert(main_cache.batches == 1 && buffer.size() == 0);
+    assert(main_cache.size() == 3);
+    assert(same_node(*main_cache.get_shared(make_key(2, 1)), make_node(11, 0)));
+    buffer.put(make_key(3, 1), make_node(3, 0));  // Outside a commit: straight through
+    assert(main_cache.get_shared(make_key(3, 1)) && buffer.size() == 0);
+
+    // Adapter commits through its own tree: every committed root stays resolvable
+    XookAdapter adapter;
+    Hash root{};
+    std::vector<Hash> roots;
+    for (uint64_t v = 1; v <= 3; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 50; ++i) {
+            Hash value;
+            value.fill(static_cast<uint8_t>(i + v));
+            updates.emplace_back(Bytes{static_cast<uint8_t>(i), 0x5A}, value);
+        }
+        root = adapter.calculate_root(updates, root, v).new_root_hash;
+        roots.push_back(root);
+        if (v == 2) adapter.enable_numa_cache();  // Cache swap keeps the same tree
+    }
+    assert(adapter.cache_size() > 0);
+    for (uint64_t v = 1; v <= 3; ++v) assert(adapter.get_root_hash(v) == roots[v - 1]);
+    std::cout << "  ✅ Buffered reads, single put_many, past roots resolvable after batched commits" << std::endl;
+}
+
+void test_population_time() {
+    std::cout << "[TEST] Population time, 50k-node block..." << std::endl;
+
+    NodeBatch batch;
+    for (uint64_t id = 0; id < 50'000; ++id) batch.emplace_back(make_key(9, id, 5), make_node(id, id % 8 == 0 ? 16 : 0));
+
+    auto time_ms = [&](auto&& fill) {
+        TreeCache cache(40'000);
+        cache.enable_committed_index();
+        auto start = std::chrono::steady_clock::now();
+        fill(cache);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    double per_node = time_ms([&](TreeCache& c) { for (const auto& [k, n] : batch) c.put(k, n); });
+    double batched = time_ms([&](TreeCache& c) { c.put_many(batch); });
+    std::cout << "  ✅ put: " << per_node << " ms, put_many: " << batched << " ms" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== CACHE PUT_MANY TESTS ===\n" << std::endl;
+
+    test_matches_sequential_put(EvictionPolicy::LRU);
+    test_matches_sequential_put(EvictionPolicy::GreedyDual);
+    test_bulk_eviction_and_l1();
+    test_partitioned_caches();
+    test_commit_buffer();
+    test_population_time();
+
+    std::cout << "\n=== ALL CACHE PUT_MANY TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,156 @@
+// =========================================================
+// FILE: tests/xook/test_cache_supersede.cpp
+// PURPOSE: Version-aware TreeCache invalidation: demote / drop superseded nodes
+// =========================================================
+
+#include "../../src/xook/tree_cache.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+using glofica::Hash;
+using glofica::Bytes;
+
+/// @brief 10-entry cache holding path 0 at v1 (most recently used) plus 8 other live paths
+static void fill(TreeCache& cache) {
+    for (uint64_t id = 1; id <= 8; ++id) cache.put(make_key(1, id, 3), make_leaf(static_cast<uint8_t>(id)));
+    cache.put(make_key(1, 0, 3), make_leaf(0));
+    cache.publish_committed(1);
+    assert(cache.get_shared(make_key(1, 0, 3)));  // MRU
+}
+
+void test_demote(EvictionPolicy eviction) {
+    std::cout << "[TEST] Demote superseded version (" << (eviction == EvictionPolicy::LRU ? "LRU" : "GreedyDual")
+              << ")..." << std::endl;
+
+    TreeCache cache(10);
+    cache.set_eviction_policy(eviction);
+    cache.set_supersede_policy(SupersedePolicy::Demote);
+    fill(cache);
+
+    cache.put(make_key(2, 0, 3), make_leaf(0xA0));
+    assert(cache.size() == 10);
+    assert(cache.superseded_count() == 0);  // Not before the version is committed
+    cache.publish_committed(2);
+    assert(cache.superseded_count() == 1);
+
+    // One more insert: the demoted MRU node goes, not the oldest live one
+    cache.put(make_key(2, 9, 3), make_leaf(9));
+    assert(!cache.get_shared(make_key(1, 0, 3)));
+    for (uint64_t id = 1; id <= 8; ++id) assert(cache.get_shared(make_key(1, id, 3)));
+    assert(cache.get_shared(make_key(2, 0, 3)) && cache.get_shared(make_key(2, 9, 3)));
+    std::cout << "  ✅ Superseded versions evicted before older live nodes" << std::endl;
+}
+
+void test_drop() {
+    std::cout << "[TEST] Drop superseded version at publish..." << std::endl;
+
+    TreeCache cache(10);
+    cache.enable_committed_index();
+    cache.set_supersede_policy(SupersedePolicy::Drop);
+    fill(cache);
+    cache.publish_committed(1);
+    assert(cache.visit_committed(make_key(1, 0, 3), [](const Node&) {}));
+
+    cache.put(make_key(5, 0, 3), make_leaf(0xC0));
+    assert(cache.get_shared(make_key(1, 0, 3)));  // Version 5 not committed yet
+    cache.publish_committed(5);
+    assert(cache.size() == 9);
+    assert(!cache.get_shared(make_key(1, 0, 3)));
+    assert(!cache.visit_committed(make_key(1, 0, 3), [](const Node&) {}));  // Gone from the index too
+    assert(cache.get_shared(make_key(5, 0, 3)));
+
+    // Late historical read: the older node loses to the cached live one
+    cache.put(make_key(3, 0, 3), make_leaf(0x30));
+    cache.publish_committed(5);
+    assert(!cache.get_shared(make_key(3, 0, 3)) && cache.get_shared(make_key(5, 0, 3)));
+    assert(cache.superseded_count() == 2);
+    std::cout << "  ✅ Dropped from map and committed index; late older read dropped" << std::endl;
+}
+
+void test_off_and_clear() {
+    std::cout << "[TEST] Off keeps plain LRU behaviour..." << std::endl;
+
+    TreeCache cache(10);
+    fill(cache);
+    cache.put(make_key(2, 0, 3), make_leaf(0xA0));
+    cache.publish_committed(2);
+    assert(cache.superseded_count() == 0 && cache.size() == 10);
+
+    cache.set_supersede_policy(SupersedePolicy::Demote);
+    cache.clear();
+    cache.put(make_key(4, 0, 3), make_leaf(1));
+    cache.publish_committed(4);
+    assert(cache.size() == 1 && cache.superseded_count() == 0);
+    std::cout << "  ✅ No tracking when off; clear() resets tracking" << std::endl;
+}
+
+void test_adapter_drop_keeps_history_readable() {
+    std::cout << "[TEST] XookAdapter with Drop: same roots, historical reads via the store..." << std::endl;
+
+    XookAdapter dropping;
+    dropping.set_cache_supersede_policy(SupersedePolicy::Drop);
+    XookAdapter plain;  // Default: no supersede tracking
+
+    Hash dropping_root{}, plain_root{};
+    for (uint64_t v = 1; v <= 10; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 100; ++i) {
+            Hash value;
+            value.fill(static_cast<uint8_t>(i + 3 * v));
+            updates.emplace_back(Bytes{static_cast<uint8_t>(i), 0x42}, value);
+        }
+        dropping_root = dropping.calculate_root(updates, dropping_root, v).new_root_hash;
+        plain_root = plain.calculate_root(updates, plain_root, v).new_root_hash;
+        assert(dropping_root == plain_root);
+    }
+    for (uint64_t v : {1, 5, 10}) {
+        for (uint32_t i = 0; i < 100; i += 9) {
+            Bytes key{static_cast<uint8_t>(i), 0x42};
+            assert(dropping.get(key, v) == plain.get(key, v));
+        }
+    }
+    std::cout << "  ✅ Roots match over 10 versions; versions 1/5/10 readable" << std::endl;
+}
+
+void test_evicted_before_publish_and_bounded_backlog() {
+    std::cout << "[TEST] Evicted before publish: not tracked; backlog bounded without publish..." << std::endl;
+
+    TreeCache cache(4);
+    cache.set_supersede_policy(SupersedePolicy::Demote);
+    cache.put(make_key(5, 0, 3), make_leaf(5));
+    for (uint64_t id = 1; id <= 4; ++id) cache.put(make_key(5, id, 3), make_leaf(static_cast<uint8_t>(id)));
+    assert(!cache.get_shared(make_key(5, 0, 3)));  // Evicted before v5 was published
+    cache.publish_committed(5);
+
+    // Path 0 has no cached newer node: a historical read of it stays live
+    cache.put(make_key(3, 0, 3), make_leaf(3));
+    cache.publish_committed(5);
+    assert(cache.superseded_count() == 0 && cache.get_shared(make_key(3, 0, 3)));
+
+    // Writer that never publishes (e.g. a read-only cache): queue stays O(capacity)
+    for (uint64_t round = 0; round < 2000; ++round) {
+        for (uint64_t id = 0; id < 8; ++id) cache.put(make_key(10 + round, id, 3), make_leaf(static_cast<uint8_t>(id)));
+    }
+    assert(cache.supersede_backlog() <= 2 * cache.capacity() + 1024);
+    cache.publish_committed(10 + 2000);
+    assert(cache.supersede_backlog() == 0 && cache.size() == 4);
+    std::cout << "  ✅ 16000 unpublished puts, backlog capped" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== CACHE SUPERSEDE TESTS ===\n" << std::endl;
+
+    test_demote(EvictionPolicy::LRU);
+    test_demote(EvictionPolicy::GreedyDual);
+    test_drop();
+    test_off_and_clear();
+    test_adapter_drop_keeps_history_readable();
+    test_evicted_before_publish_and_bounded_backlog();
+
+    std::cout << "\n=== ALL CACHE SUPERSEDE TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,255 @@
+// =========================================================
+// FILE: tests/xook/test_change_feed.cpp
+// PURPOSE: Changed-key notifications: filters, zero-copy views, adapter delivery
+// =========================================================
+
+#include "../../src/xook/change_feed.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+
+using namespace glofica::xook;
+using glofica::Hash;
+using glofica::Bytes;
+
+static Bytes key_of(uint32_t i) {
+    return Bytes{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x7E};
+}
+
+static Hash value_of(uint32_t i, uint64_t version) {
+    Hash value;
+    value.fill(static_cast<uint8_t>(i * 3 + version));
+    return value;
+}
+
+/// @brief What get() returns for a key committed with `value` (the leaf's BLAKE3 of its bytes)
+static Hash committed(const Hash& value) {
+    return glofica::hash::blake3(Bytes(value.begin(), value.end()));
+}
+
+/// @brief Batch of keys 0..n-1 at `version`, canonical order
+static std::shared_ptr<const ChangeBatch> make_batch(uint32_t n, uint64_t version) {
+    auto batch = std::make_shared<ChangeBatch>();
+    batch->version = version;
+    for (uint32_t i = 0; i < n; ++i) batch->entries.emplace_back(glofica::hash::blake3(key_of(i)), value_of(i, version));
+    canonicalize_updates(batch->entries);
+    return batch;
+}
+
+static NibblePath first_nibbles(const Hash& h, size_t nibbles) {
+    NibblePath path;
+    for (size_t i = 0; i < nibbles; ++i) path.push(i % 2 == 0 ? h[i / 2] >> 4 : h[i / 2] & 0x0F);
+    return path;
+}
+
+/// @brief Every key hash delivered, in order; asserts the views point into the batch
+static std::vector<Hash> delivered(const ChangeNotification& n) {
+    std::vector<Hash> keys;
+    const ChangeEntry* begin = n.batch->entries.data();
+    const ChangeEntry* end = begin + n.batch->entries.size();
+    for (const auto& run : n.runs) assert(run.data() >= begin && run.data() + run.size() <= end);
+    n.for_each([&keys](const Hash& key_hash, const Hash&) { keys.push_back(key_hash); });
+    return keys;
+}
+
+void test_filters() {
+    std::cout << "[TEST] All / prefix / key-set filters over one batch..." << std::endl;
+
+    auto batch = make_batch(500, 1);
+    const auto& entries = batch->entries;
+    NibblePath one_nibble = first_nibbles(entries[100].first, 1);
+    NibblePath three_nibbles = first_nibbles(entries[400].first, 3);
+
+    ChangeFeed feed;
+    std::vector<Hash> all, prefix, keys, mixed;
+    feed.subscribe(ChangeFilter::all(), [&](const ChangeNotification& n) { all = delivered(n); });
+    feed.subscribe(ChangeFilter{}.add_prefix(one_nibble).add_prefix(three_nibbles),
+                   [&](const ChangeNotification& n) { prefix = delivered(n); });
+    feed.subscribe(ChangeFilter{}.add_key(key_of(7)).add_key(key_of(321)).add_key(key_of(9999)),
+                   [&](const ChangeNotification& n) { keys = delivered(n); });
+    // Overlapping: a key inside the prefix, a key outside it
+    feed.subscribe(ChangeFilter{}.add_prefix(one_nibble).add_key_hash(entries[100].first).add_key_hash(entries[499].first),
+                   [&](const ChangeNotification& n) { mixed = delivered(n); });
+    bool called = false;
+    feed.subscribe(ChangeFilter{}.add_key(key_of(12345)), [&](const ChangeNotification&) { called = true; });
+
+    feed.publish(batch);
+
+    auto expect = [&](auto&& wanted) {
+        std::vector<Hash> out;
+        for (const auto& [key_hash, value_hash] : entries) if (wanted(key_hash)) out.push_back(key_hash);
+        return out;
+    };
+    auto in = [](const Hash& h, const NibblePath& p) { return first_nibbles(h, p.size()) == p; };
+    assert(all.size() == 500);
+    assert(prefix == expect([&](const Hash& h) { return in(h, one_nibble) || in(h, three_nibbles); }));
+    assert(keys.size() == 2);
+    assert(keys == expect([&](const Hash& h) {
+        return h == glofica::hash::blake3(key_of(7)) || h == glofica::hash::blake3(key_of(321));
+    }));
+    assert(mixed == expect([&](const Hash& h) { return in(h, one_nibble) || h == entries[499].first; }));
+    assert(!called);
+
+    ChangeFeedStats stats = feed.stats();
+    assert(stats.subscribers == 5 && stats.batches == 1 && stats.notifications == 4);
+    std::cout << "  ✅ " << prefix.size() << " prefix, " << keys.size() << " key-set matches; no-match subscriber skipped"
+              << std::endl;
+}
+
+void test_key_set_exact_under_bloom() {
+    std::cout << "[TEST] Large key set: Bloom false positives never delivered..." << std::endl;
+
+    auto batch = make_batch(20'000, 1);
+    ChangeFilter filter;
+    for (uint32_t i = 20'000; i < 22'000; ++i) filter.add_key(key_of(i));  // Not in the batch
+    filter.add_key(key_of(10));
+
+    ChangeFeed feed;
+    size_t matches = 0;
+    feed.subscribe(std::move(filter), [&](const ChangeNotification& n) { matches = n.size(); });
+    feed.publish(batch);
+    assert(matches == 1);
+    std::cout << "  ✅ 1 match out of 20000 changes against 2001 keys" << std::endl;
+}
+
+void test_subscription_rules() {
+    std::cout << "[TEST] Empty filter rejected, unsubscribe, throwing callback..." << std::endl;
+
+    ChangeFeed feed;
+    bool rejected = false;
+    try { feed.subscribe(ChangeFilter{}, [](const ChangeNotification&) {}); } catch (const std::invalid_argument&) { rejected = true; }
+    assert(rejected && !feed.has_subscribers());
+
+    size_t calls = 0;
+    uint64_t self = 0;
+    self = feed.subscribe(ChangeFilter::all(), [&](const ChangeNotification&) {
+        ++calls;
+        feed.unsubscribe(self);  // From inside the callback
+    });
+    feed.subscribe(ChangeFilter::all(), [](const ChangeNotification&) { throw std::runtime_error("subscriber bug"); });
+    feed.publish(make_batch(10, 1));
+    feed.publish(make_batch(10, 2));
+    assert(calls == 1);
+    assert(!feed.unsubscribe(self));
+    assert(feed.stats().callback_errors == 2 && feed.stats().subscribers == 1);
+    std::cout << "  ✅ Rules hold" << std::endl;
+}
+
+void test_adapter_delivery() {
+    std::cout << "[TEST] XookAdapter publishes each commit to subscribers..." << std::endl;
+
+    XookAdapter adapter;
+    std::vector<std::shared_ptr<const ChangeBatch>> held;
+    std::vector<std::pair<uint64_t, Hash>> watched;
+    adapter.subscribe_changes(ChangeFilter::all(), [&](const ChangeNotification& n) { held.push_back(n.batch); });
+    adapter.subscribe_changes(ChangeFilter{}.add_key(key_of(42)), [&](const ChangeNotification& n) {
+        assert(n.size() == 1);
+        watched.emplace_back(n.version(), n.runs[0][0].second);
+        // Head already published: the version is readable from the callback
+        assert(adapter.get_root_hash(n.version()) == n.batch->root);
+    });
+
+    Hash root{};
+    for (uint64_t v = 1; v <= 3; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 100; ++i) {
+            if (v == 2 && i == 42) continue;
+            updates.emplace_back(key_of(i), value_of(i, v));
+        }
+        if (v == 3) adapter.put(key_of(500), value_of(500, v), v);  // Pending put() is a change too
+        root = adapter.calculate_root(updates, root, v).new_root_hash;
+    }
+
+    // Ordered update sets (hashed path)
+    OrderedUpdateSets sets;
+    sets.submit(1, {{key_of(42), value_of(42, 4)}});
+    sets.submit(2, {{key_of(43), value_of(43, 4)}});
+    root = adapter.calculate_root(sets.resolve(), root, 4).new_root_hash;
+
+    assert(held.size() == 4);
+    assert(held[0]->entries.size() == 100 && held[1]->entries.size() == 99 && held[2]->entries.size() == 101);
+    assert(held[3]->entries.size() == 2 && held[3]->root == root && held[3]->version == 4);
+    for (const auto& batch : held) {
+        assert(std::is_sorted(batch->entries.begin(), batch->entries.end(),
+                              [](const auto& a, const auto& b) { return a.first < b.first; }));
+    }
+    assert((watched == std::vector<std::pair<uint64_t, Hash>>{
+        {1, committed(value_of(42, 1))}, {3, committed(value_of(42, 3))}, {4, committed(value_of(42, 4))}}));
+
+    AdapterStats stats = adapter.stats();
+    assert(stats.changes.subscribers == 2 && stats.changes.batches == 4 && stats.changes.notifications == 7);
+    assert(stats.to_prometheus().find("xook_change_notifications_total 7") != std::string::npos);
+    std::cout << "  ✅ 4 versions delivered; key-set subscriber woke 3 times" << std::endl;
+}
+
+void test_duplicates_match_committed() {
+    std::cout << "[TEST] Duplicate keys: delivered value == committed value..." << std::endl;
+
+    XookAdapter adapter;
+    std::shared_ptr<const ChangeBatch> batch;
+    adapter.subscribe_changes(ChangeFilter::all(), [&](const ChangeNotification& n) { batch = n.batch; });
+
+    // Legacy path: a key repeated in the updates and in a pending put()
+    std::vector<std::pair<Bytes, Hash>> updates{
+        {key_of(7), value_of(7, 1)}, {key_of(8), value_of(8, 1)}, {key_of(7), value_of(7, 2)}};
+    adapter.put(key_of(7), value_of(7, 3), 1);
+    Hash root = adapter.calculate_root(updates, Hash{}, 1).new_root_hash;
+    assert(batch && batch->entries.size() == 2);
+    for (const auto& [key_hash, value_hash] : batch->entries) {
+        const Bytes& key = key_hash == glofica::hash::blake3(key_of(7)) ? key_of(7) : key_of(8);
+        assert(adapter.get(key, 1) == value_hash);
+    }
+    assert(adapter.get(key_of(7), 1) == committed(value_of(7, 2)));  // Pending put() is older than the updates
+
+    // Precomputed-hash path: the later update wins
+    adapter.update_batch_with_precomputed_hashes({{key_of(9), value_of(9, 1)}, {key_of(9), value_of(9, 2)}}, 2, root, 1);
+    assert(batch->version == 2 && batch->entries.size() == 1);
+    assert(batch->entries[0].second == committed(value_of(9, 2)));
+    assert(adapter.get(key_of(9), 2) == committed(value_of(9, 2)));
+    std::cout << "  ✅ One entry per key, matching get() on both legacy paths" << std::endl;
+}
+
+void test_concurrent_subscribers() {
+    std::cout << "[TEST] Subscribe / unsubscribe while the writer commits..." << std::endl;
+
+    XookAdapter adapter;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> received{0};
+    std::thread churn([&] {
+        while (!stop.load()) {
+            uint64_t id = adapter.subscribe_changes(ChangeFilter::all(), [&](const ChangeNotification& n) {
+                received.fetch_add(n.size());
+            });
+            adapter.unsubscribe_changes(id);
+        }
+    });
+    uint64_t steady = 0;
+    adapter.subscribe_changes(ChangeFilter::all(), [&](const ChangeNotification& n) { steady += n.size(); });
+
+    Hash root{};
+    for (uint64_t v = 1; v <= 50; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 20; ++i) updates.emplace_back(key_of(i), value_of(i, v));
+        root = adapter.calculate_root(updates, root, v).new_root_hash;
+    }
+    stop = true;
+    churn.join();
+    assert(steady == 50 * 20);
+    std::cout << "  ✅ Steady subscriber saw every change (" << received.load() << " to churned ones)" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== CHANGE FEED TESTS ===\n" << std::endl;
+
+    test_filters();
+    test_key_set_exact_under_bloom();
+    test_subscription_rules();
+    test_adapter_delivery();
+    test_duplicates_match_committed();
+    test_concurrent_subscribers();
+
+    std::cout << "\n=== ALL CHANGE FEED TESTS PASSED ===" << std::endl;
+    return 0;
+}
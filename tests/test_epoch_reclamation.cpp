@@ -0,0 +1,179 @@
+// =========================================================
+// FILE: tests/xook/test_epoch_reclamation.cpp
+// PURPOSE: EBR frees retired objects only after pinned readers leave
+// =========================================================
+
+#include "../../src/xook/epoch_reclamation.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace glofica::xook;
+
+struct Tracked {
+    static inline std::atomic<int> live{0};
+    uint64_t value;
+    explicit Tracked(uint64_t v) : value(v) { live.fetch_add(1); }
+    ~Tracked() { value = 0xDEADDEADDEADDEADULL; live.fetch_sub(1); }
+};
+
+void test_pinned_reader_blocks_reclamation() {
+    std::cout << "[TEST] Pinned reader delays reclamation..." << std::endl;
+
+    EpochManager epochs;
+    std::atomic<const Tracked*> head{new Tracked(1)};
+
+    auto guard = epochs.pin();
+    const Tracked* seen = head.load();
+
+    // Writer swaps and retires while the reader still holds `seen`
+    epochs.retire(head.exchange(new Tracked(2)));
+    assert(epochs.reclaim() == 0);
+    assert(seen->value == 1);  // Still valid
+    assert(epochs.pending_reclamation() == 1);
+
+    guard.release();
+    assert(epochs.reclaim() == 1);
+    assert(Tracked::live.load() == 1);
+
+    delete head.load();
+    std::cout << "  ✅ Object freed only after guard release" << std::endl;
+}
+
+void test_new_readers_do_not_block_old_garbage() {
+    std::cout << "[TEST] Readers pinned after retire do not hold old objects..." << std::endl;
+
+    EpochManager epochs;
+    std::atomic<const Tracked*> head{new Tracked(1)};
+
+    epochs.retire(head.exchange(new Tracked(2)));
+    epochs.reclaim();  // Advances epoch; nothing pinned
+    assert(Tracked::live.load() == 1);
+
+    epochs.retire(head.exchange(new Tracked(3)));
+    auto late_guard = epochs.pin();  // Pinned after the retire above
+    epochs.reclaim();
+    epochs.reclaim();
+    // late_guard may conservatively hold garbage retired at its epoch, never older
+    assert(Tracked::live.load() <= 2);
+
+    late_guard.release();
+    epochs.reclaim();
+    assert(Tracked::live.load() == 1);
+    delete head.load();
+    std::cout << "  ✅ Old garbage reclaimed" << std::endl;
+}
+
+void test_concurrent_readers_and_writer() {
+    std::cout << "[TEST] Concurrent readers during commits..." << std::endl;
+
+    EpochManager epochs;
+    std::atomic<const Tracked*> head{new Tracked(1)};
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 8; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                auto guard = epochs.pin();
+                const Tracked* t = head.load();
+                uint64_t v = t->value;
+                assert(v != 0xDEADDEADDEADDEADULL);  // Never observe freed memory
+                (void)v;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (uint64_t version = 2; version < 20000; ++version) {
+        epochs.retire(head.exchange(new Tracked(version)));
+        epochs.reclaim();
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+
+    epochs.reclaim();
+    assert(Tracked::live.load() == 1);
+    delete head.load();
+    std::cout << "  ✅ " << reads.load() << " reads, no use-after-free" << std::endl;
+}
+
+/// @brief 20 keys rewritten every version (each commit supersedes the last)
+static glofica::Hash commit(XookAdapter& adapter, const glofica::Hash& base, uint64_t version, uint8_t salt,
+                            NodeKey* first_node = nullptr) {
+    std::vector<std::pair<glofica::Bytes, glofica::Hash>> updates;
+    for (uint8_t i = 0; i < 20; ++i) {
+        glofica::Hash value;
+        value.fill(static_cast<uint8_t>(i + salt));
+        updates.emplace_back(glofica::Bytes{i, 0x11}, value);
+    }
+    auto result = adapter.calculate_root(updates, base, version);
+    if (first_node) *first_node = result.node_batch.front().first;
+    return result.new_root_hash;
+}
+
+void test_snapshot_pins_version_against_pruning() {
+    std::cout << "[TEST] ReadSnapshot pins its version against retention pruning..." << std::endl;
+
+    XookAdapter adapter;
+    adapter.set_in_memory_retention(1);
+    NodeKey v1_node;
+    glofica::Hash root = commit(adapter, {}, 1, 1, &v1_node);
+    assert(!adapter.oldest_pinned_version());
+
+    std::optional<XookAdapter::ReadSnapshot> pinned(adapter.snapshot());
+    assert(pinned->version() == 1 && adapter.oldest_pinned_version() == 1u);
+    XookAdapter::ReadSnapshot moved = std::move(*pinned);  // The pin moves with it
+    pinned.reset();
+    assert(adapter.oldest_pinned_version() == 1u);
+
+    for (uint64_t v = 2; v <= 6; ++v) root = commit(adapter, root, v, static_cast<uint8_t>(v));
+    assert(adapter.in_memory_store()->get(v1_node));  // Superseded at 2, kept for the snapshot
+
+    {
+        XookAdapter::ReadSnapshot released = std::move(moved);
+    }
+    assert(!adapter.oldest_pinned_version());
+    root = commit(adapter, root, 7, 7);
+    assert(!adapter.in_memory_store()->get(v1_node));  // Pin gone: pruned with the window
+    std::cout << "  ✅ Version 1 nodes survive 5 commits under retention 1 while pinned" << std::endl;
+}
+
+void test_snapshot_detects_rewritten_version() {
+    std::cout << "[TEST] ReadSnapshot refuses a version re-committed with another root..." << std::endl;
+
+    XookAdapter adapter;
+    glofica::Hash v1 = commit(adapter, {}, 1, 1);
+    commit(adapter, v1, 2, 2);
+
+    auto snap = adapter.snapshot();
+    (void)snap.get(glofica::Bytes{1, 0x11});  // No rewrite: reads normally
+
+    // Rollback recovery: version 2 again, different contents
+    std::vector<std::pair<glofica::Bytes, glofica::Hash>> other{{glofica::Bytes{1, 0x11}, glofica::Hash{}}};
+    adapter.update_batch_with_precomputed_hashes(other, 2, v1, 1);
+
+    bool refused = false;
+    try { (void)snap.get(glofica::Bytes{1, 0x11}); } catch (const std::runtime_error&) { refused = true; }
+    assert(refused);
+
+    auto fresh = adapter.snapshot();
+    (void)fresh.get(glofica::Bytes{1, 0x11});  // Taken after the rewrite: fine
+    std::cout << "  ✅ Stale snapshot throws, fresh snapshot reads" << std::endl;
+}
+
+int main() {
+    test_pinned_reader_blocks_reclamation();
+    test_new_readers_do_not_block_old_garbage();
+    test_concurrent_readers_and_writer();
+    test_snapshot_pins_version_against_pruning();
+    test_snapshot_detects_rewritten_version();
+
+    std::cout << "\nALL EPOCH RECLAMATION TESTS PASSED" << std::endl;
+    return 0;
+}
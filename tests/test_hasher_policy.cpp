@@ -0,0 +1,120 @@
+// =========================================================
+// FILE: tests/xook/test_hasher_policy.cpp
+// PURPOSE: Compile-time hasher policies: vectors, record widths, serde
+// =========================================================
+
+#include "../../src/xook/hasher_policy.hpp"
+#include "../../src/xook/node_serde.hpp"
+#include <iostream>
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace glofica::xook;
+
+template <typename Digest>
+std::string hex(const Digest& d) {
+    std::ostringstream out;
+    for (uint8_t b : d) out << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
+    return out.str();
+}
+
+void test_sha3_512_vectors() {
+    std::cout << "[TEST] SHA3-512 FIPS 202 vectors..." << std::endl;
+
+    assert(hex(Sha3_512::hash({})) ==
+           "a69f73cca23a9ac5c8b567dc185a756e97c982164fe25859e0d1dcc1475c80a6"
+           "15b2123af1f5f94c11e3e9402c3ac558f500199d95b6d3e301758586281dcd26");
+    assert(hex(Sha3_512::hash({'a', 'b', 'c'})) ==
+           "b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e"
+           "10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0");
+
+    // Exactly one rate block (72B) and one byte more take different padding paths
+    glofica::Bytes block(72, 0x61), longer(73, 0x61);
+    assert(Sha3_512::hash(block) != Sha3_512::hash(longer));
+    std::cout << "  ✅ Empty / \"abc\" digests match, block boundary handled" << std::endl;
+}
+
+void test_blake3_256_is_prefix() {
+    std::cout << "[TEST] BLAKE3-256 is the 32-byte prefix of BLAKE3-512..." << std::endl;
+
+    glofica::Bytes data = {1, 2, 3, 4, 5};
+    auto full = Blake3_512::hash(data);
+    auto half = Blake3_256::hash(data);
+    assert(std::equal(half.begin(), half.end(), full.begin()));
+    std::cout << "  ✅ Prefix-consistent" << std::endl;
+}
+
+template <typename Hasher>
+void check_roundtrip(const char* name) {
+    using Layout = NodeLayout<Hasher>;
+    BasicInternalNode<Hasher> internal;
+    typename Hasher::Digest child{};
+    child.fill(0x11);
+    internal.set_child(3, child, 7);
+    internal.set_child(12, child, 9);
+
+    auto bytes = serialize_node_with_prefix(BasicNode<Hasher>(internal));
+    assert(bytes.size() == Layout::INTERNAL_HEADER_SIZE + 2 * Layout::CHILD_RECORD_SIZE);
+    auto back = deserialize_node_from_bytes_as<Hasher>(bytes);
+    assert(back && std::get<BasicInternalNode<Hasher>>(*back).hash() == internal.hash());
+
+    BasicLeafNode<Hasher> leaf;
+    leaf.account_key.fill(0x22);
+    leaf.value_hash.fill(0x33);
+    auto leaf_bytes = serialize_node_with_prefix(BasicNode<Hasher>(leaf));
+    assert(leaf_bytes.size() == Layout::LEAF_SERIALIZED_SIZE);
+    auto leaf_back = deserialize_node_from_bytes_as<Hasher>(leaf_bytes);
+    assert(leaf_back && std::get<BasicLeafNode<Hasher>>(*leaf_back).hash() == leaf.hash());
+
+    // Bytes of one width are rejected by another
+    leaf_bytes.push_back(0);
+    assert(!deserialize_node_from_bytes_as<Hasher>(leaf_bytes));
+
+    std::cout << "  ✅ " << name << ": child record " << Layout::CHILD_RECORD_SIZE
+              << "B, leaf " << Layout::LEAF_SERIALIZED_SIZE << "B" << std::endl;
+}
+
+void test_serde_roundtrip_per_policy() {
+    std::cout << "[TEST] Serde round trip per policy..." << std::endl;
+
+    check_roundtrip<Blake3_512>("BLAKE3-512");
+    check_roundtrip<Blake3_256>("BLAKE3-256");
+    check_roundtrip<Sha3_512>("SHA3-512");
+    check_roundtrip<FastBenchHasher<32>>("FastBench-256");
+
+    static_assert(InternalNode256::CHILD_RECORD_SIZE == 40);
+    static_assert(std::is_same_v<InternalNode, BasicInternalNode<Blake3_512>>);
+    static_assert(!FastBenchHasher<>::CRYPTOGRAPHIC);
+}
+
+void test_default_policy_unchanged() {
+    std::cout << "[TEST] Default policy keeps the production format..." << std::endl;
+
+    LeafNode leaf;
+    leaf.account_key.fill(0x44);
+    leaf.value_hash.fill(0x55);
+    auto bytes = serialize_node_with_prefix(Node(leaf));
+    assert(bytes.size() == 129);
+    assert(deserialize_node_from_bytes(bytes).has_value());
+
+    // Same algorithm, different width: different root
+    LeafNode256 narrow;
+    narrow.account_key.fill(0x44);
+    narrow.value_hash.fill(0x55);
+    auto narrow_hash = narrow.hash();
+    auto wide_hash = leaf.hash();
+    assert(!std::equal(narrow_hash.begin(), narrow_hash.end(), wide_hash.begin()));
+    std::cout << "  ✅ 129-byte leaves, BLAKE3-512 hashes" << std::endl;
+}
+
+int main() {
+    test_sha3_512_vectors();
+    test_blake3_256_is_prefix();
+    test_serde_roundtrip_per_policy();
+    test_default_policy_unchanged();
+
+    std::cout << "\nALL HASHER POLICY TESTS PASSED" << std::endl;
+    return 0;
+}
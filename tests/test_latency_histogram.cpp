@@ -0,0 +1,110 @@
+// =========================================================
+// FILE: tests/xook/test_latency_histogram.cpp
+// PURPOSE: HDR-style histogram buckets, merging and Prometheus output
+// =========================================================
+
+#include "../../src/xook/xook_stats.hpp"
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+using namespace glofica::xook;
+
+void test_bucket_layout() {
+    std::cout << "[TEST] Bucket layout..." << std::endl;
+
+    // Exact below 16ns
+    for (uint64_t v = 0; v < 16; ++v) {
+        assert(LatencyHistogram::bucket_index(v) == v);
+    }
+
+    // Every value lies inside its bucket bounds, relative error <= 1/16
+    for (uint64_t v = 1; v < (1ULL << 30); v = v * 3 + 1) {
+        size_t idx = LatencyHistogram::bucket_index(v);
+        uint64_t lo = LatencyHistogram::bucket_lower_ns(idx);
+        uint64_t hi = LatencyHistogram::bucket_upper_ns(idx);
+        assert(lo <= v && v <= hi);
+        assert((hi - lo) * 16 <= lo || lo < 16);
+    }
+
+    // Saturation
+    assert(LatencyHistogram::bucket_index(~0ULL) == LatencyHistogram::BUCKETS - 1);
+    std::cout << "  ✅ Buckets monotonic and bounded" << std::endl;
+}
+
+void test_percentiles() {
+    std::cout << "[TEST] Percentiles..." << std::endl;
+
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 1000; ++v) h.record(v * 1000);  // 1us .. 1ms
+
+    auto snap = h.snapshot();
+    assert(snap.count == 1000);
+    assert(snap.max_ns == 1000000);
+
+    uint64_t p50 = snap.percentile_ns(0.5);
+    uint64_t p99 = snap.percentile_ns(0.99);
+    assert(p50 >= 500000 && p50 <= 500000 + 500000 / 16);
+    assert(p99 >= 990000 && p99 <= 1000000);
+    assert(snap.percentile_ns(1.0) == 1000000);
+
+    // Nearest rank is ceil(q * n): exact in the linear range (1..10ns)
+    LatencyHistogram small;
+    for (uint64_t v = 1; v <= 10; ++v) small.record(v);
+    auto exact = small.snapshot();
+    assert(exact.percentile_ns(0.5) == 5 && exact.percentile_ns(0.9) == 9 && exact.percentile_ns(0.95) == 10);
+    assert(exact.percentile_ns(0.0) == 1 && exact.percentile_ns(0.01) == 1);
+    LatencyHistogram hundred;
+    for (uint64_t v = 1; v <= 100; ++v) hundred.record(v <= 7 ? 0 : 1);  // Ranks 1-7 are 0ns
+    assert(hundred.snapshot().percentile_ns(0.07) == 0 && hundred.snapshot().percentile_ns(0.08) == 1);
+    std::cout << "  ✅ p50=" << p50 << "ns p99=" << p99 << "ns" << std::endl;
+}
+
+void test_multithreaded_merge() {
+    std::cout << "[TEST] Per-thread stripes merged on read..." << std::endl;
+
+    LatencyHistogram h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 12; ++t) {
+        threads.emplace_back([&h] {
+            for (int i = 0; i < 10000; ++i) h.record(100);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    auto snap = h.snapshot();
+    assert(snap.count == 120000);
+    assert(snap.sum_ns == 120000ULL * 100);
+    std::cout << "  ✅ No lost samples across 12 threads" << std::endl;
+}
+
+void test_prometheus_format() {
+    std::cout << "[TEST] Prometheus exposition..." << std::endl;
+
+    AdapterMetrics metrics;
+    metrics.latency(AdapterOp::CalculateRoot).record(2000000);
+
+    AdapterStats stats;
+    for (size_t i = 0; i < ADAPTER_OP_COUNT; ++i) {
+        stats.latency[i] = metrics.latency(static_cast<AdapterOp>(i)).snapshot();
+    }
+    std::string text = stats.to_prometheus();
+
+    assert(text.find("# TYPE xook_op_latency_seconds summary") != std::string::npos);
+    assert(text.find("xook_op_latency_seconds_count{op=\"calculate_root\"} 1") != std::string::npos);
+    assert(text.find("xook_op_latency_seconds_count{op=\"put\"} 0") != std::string::npos);
+    assert(text.find("op=\"update_batch_with_precomputed_hashes\"") != std::string::npos);
+    assert(text.find("xook_memory_cache_bytes") != std::string::npos);
+    std::cout << "  ✅ Summary + gauges emitted" << std::endl;
+}
+
+int main() {
+    test_bucket_layout();
+    test_percentiles();
+    test_multithreaded_merge();
+    test_prometheus_format();
+
+    std::cout << "\nALL LATENCY HISTOGRAM TESTS PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,146 @@
+// =========================================================
+// FILE: tests/xook/test_memory_governor.cpp
+// PURPOSE: Unified memory budget (cache shrink + speculative backpressure)
+// =========================================================
+
+#include "../../src/xook/memory_governor.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+
+void test_cache_byte_accounting() {
+    std::cout << "[TEST] TreeCache byte accounting..." << std::endl;
+
+    TreeCache cache(1000);
+    assert(cache.approx_bytes() == 0);
+
+    for (int i = 0; i < 100; ++i) {
+        cache.put(make_key(1, static_cast<uint8_t>(i), 2), make_leaf(static_cast<uint8_t>(i)));
+    }
+    size_t full = cache.approx_bytes();
+    assert(full > 0);
+
+    // Overwrite must not double count
+    cache.put(make_key(1, 0, 2), make_leaf(0xEE));
+    assert(cache.approx_bytes() == full);
+
+    size_t freed = cache.shrink_to_bytes(full / 2);
+    assert(freed > 0);
+    assert(cache.approx_bytes() <= full / 2);
+    assert(cache.size() < 100);
+
+    // LRU order preserved: most recent key survives
+    assert(cache.get(make_key(1, 99, 2)).has_value());
+
+    cache.clear();
+    assert(cache.approx_bytes() == 0);
+    std::cout << "  ✅ Byte accounting consistent" << std::endl;
+}
+
+void test_cache_shrinks_first() {
+    std::cout << "[TEST] Cache is shrunk first under pressure..." << std::endl;
+
+    TreeCache cache(1000);
+    for (int i = 0; i < 200; ++i) {
+        cache.put(make_key(1, static_cast<uint8_t>(i), 2), make_leaf(static_cast<uint8_t>(i)));
+    }
+
+    MemoryGovernor governor(&cache);
+    size_t budget = cache.approx_bytes() / 2;
+    governor.set_budget(budget);
+    assert(governor.usage().total() <= budget);
+    assert(governor.cache_shrinks() == 1);
+
+    // Pending updates push the cache further down
+    governor.set_pending_bytes(budget / 2);
+    governor.enforce();
+    assert(governor.usage().total() <= budget);
+    std::cout << "  ✅ Cache shrunk to fit budget" << std::endl;
+}
+
+void test_speculative_backpressure() {
+    std::cout << "[TEST] Speculative backpressure..." << std::endl;
+
+    TreeCache cache(1000);
+    MemoryGovernor governor(&cache, 10000);
+    governor.set_min_cache_bytes(0);
+
+    // A single oversized session is always admitted
+    auto first = governor.admit_speculative();
+    first.charge(20000);
+    assert(governor.usage().speculative_bytes == 20000);
+
+    // A second session waits until the first releases its overlay
+    std::atomic<bool> admitted{false};
+    std::thread waiter([&] {
+        auto second = governor.admit_speculative();
+        admitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(!admitted);
+
+    { auto released = std::move(first); }
+    waiter.join();
+    assert(admitted);
+    assert(governor.backpressure_waits() == 1);
+    assert(governor.usage().speculative_bytes == 0);
+    std::cout << "  ✅ Second session admitted after release" << std::endl;
+}
+
+void test_host_shrink_handler() {
+    std::cout << "[TEST] Host-triggered shrink..." << std::endl;
+
+    TreeCache cache(1000);
+    for (int i = 0; i < 50; ++i) {
+        cache.put(make_key(2, static_cast<uint8_t>(i), 2), make_leaf(static_cast<uint8_t>(i)));
+    }
+
+    MemoryGovernor governor(&cache);
+    auto handler = governor.shrink_handler();
+    size_t freed = handler(0);
+    assert(freed > 0);
+    assert(cache.size() == 0);
+    std::cout << "  ✅ Host callback released " << freed << " bytes" << std::endl;
+}
+
+void test_governor_survives_cache_swap() {
+    std::cout << "[TEST] Cache swap keeps the governor (handlers, budget, counters)..." << std::endl;
+
+    XookAdapter adapter;
+    adapter.set_memory_budget(size_t{64} << 20);
+    auto handler = adapter.memory_pressure_handler();  // Captures the governor
+    glofica::Hash root{};
+    std::vector<std::pair<glofica::Bytes, glofica::Hash>> updates;
+    for (uint8_t i = 0; i < 50; ++i) updates.emplace_back(glofica::Bytes{i, 0x33}, glofica::Hash{});
+    root = adapter.calculate_root(updates, root, 1).new_root_hash;
+    handler(0);
+    uint64_t shrinks = adapter.stats().cache_shrinks;
+    assert(shrinks >= 1);
+
+    adapter.enable_huge_page_cache();  // install_cache()
+    root = adapter.calculate_root(updates, root, 2).new_root_hash;
+    assert(adapter.cache_size() > 0);
+
+    assert(handler(0) > 0);  // Old handler drives the new cache
+    assert(adapter.cache_size() == 0);
+    assert(adapter.stats().cache_shrinks == shrinks + 1);
+    assert(adapter.stats().memory_budget_bytes == size_t{64} << 20);
+    std::cout << "  ✅ Handler from before the swap shrinks the new cache" << std::endl;
+}
+
+int main() {
+    test_cache_byte_accounting();
+    test_cache_shrinks_first();
+    test_speculative_backpressure();
+    test_host_shrink_handler();
+    test_governor_survives_cache_swap();
+
+    std::cout << "\nALL MEMORY GOVERNOR TESTS PASSED" << std::endl;
+    return 0;
+}
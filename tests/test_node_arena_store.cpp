@@ -0,0 +1,148 @@
+// =========================================================
+// FILE: tests/xook/test_node_arena_store.cpp
+// PURPOSE: In-memory node store: lookups, pruning + compaction, adapter test mode
+// =========================================================
+
+#include "../../src/xook/node_arena_store.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+#include <thread>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+using glofica::Hash;
+using glofica::Bytes;
+
+void test_put_get() {
+    std::cout << "[TEST] Arena store round trip..." << std::endl;
+
+    NodeArenaStore store(4096);  // Small chunks: exercise chunk rollover
+    for (uint8_t i = 0; i < 200; ++i) store.put(key_at(1, {static_cast<uint8_t>(i & 0x0F), static_cast<uint8_t>(i >> 4)}), make_leaf(i));
+    assert(store.size() == 200);
+
+    auto bytes = store.get(key_at(1, {3, 2}));
+    assert(bytes);
+    auto node = deserialize_node_from_bytes(*bytes);
+    assert(node && std::get<LeafNode>(*node).account_key[0] == 0x23);
+    assert(!store.get(key_at(2, {3, 2})));
+
+    // Rewrite of a key replaces it (dead bytes stay until compaction)
+    store.put(key_at(1, {3, 2}), make_leaf(0x99));
+    assert(store.size() == 200);
+    assert(std::get<LeafNode>(*deserialize_node_from_bytes(*store.get(key_at(1, {3, 2})))).account_key[0] == 0x99);
+
+    auto stats = store.stats();
+    assert(stats.arena_bytes >= stats.live_bytes && stats.live_bytes > 200 * 129);
+    std::cout << "  ✅ 200 nodes, " << stats.arena_bytes / 4096 << " chunks" << std::endl;
+}
+
+void test_prune_superseded() {
+    std::cout << "[TEST] Pruning superseded versions + compaction..." << std::endl;
+
+    NodeArenaStore store(16 * 1024);
+    store.put(key_at(1, {}), make_leaf(1));
+    store.enable_stale_tracking();  // Indexes what is already stored
+
+    // 50 versions rewriting the same 64 paths
+    for (uint64_t v = 2; v <= 50; ++v) {
+        store.put(key_at(v, {}), make_leaf(static_cast<uint8_t>(v)));
+        for (uint8_t a = 0; a < 16; ++a) {
+            for (uint8_t b = 0; b < 4; ++b) store.put(key_at(v, {a, b}), make_leaf(static_cast<uint8_t>(v + a)));
+        }
+    }
+    assert(store.size() == 50 + 49 * 64);
+
+    size_t removed = store.prune(40);  // Versions >= 40 stay readable
+    assert(removed == 39 + 38 * 64);
+    assert(store.get(key_at(40, {})) && store.get(key_at(40, {7, 3})));
+    assert(!store.get(key_at(39, {})) && !store.get(key_at(39, {7, 3})));
+
+    auto stats = store.stats();
+    assert(stats.compactions >= 1);
+    assert(stats.nodes == 11 + 11 * 64);
+    assert(std::get<LeafNode>(*deserialize_node_from_bytes(*store.get(key_at(50, {15, 3})))).account_key[0] == 65);
+
+    // Tracking survives compaction
+    store.put(key_at(51, {}), make_leaf(51));
+    assert(store.prune(51) == 10 * 65 + 1 && !store.get(key_at(50, {})) && store.get(key_at(51, {})));
+    std::cout << "  ✅ Removed " << removed << " nodes, " << stats.compactions << " compaction(s)" << std::endl;
+}
+
+void test_rewrites_keep_stale_index() {
+    std::cout << "[TEST] Re-persisting stale nodes keeps them prunable..." << std::endl;
+
+    NodeArenaStore store(4096);
+    store.enable_stale_tracking();
+    for (uint64_t v = 1; v <= 30; ++v) {
+        for (uint8_t n = 0; n < 16; ++n) store.put(key_at(v, {n}), make_leaf(n));
+        // Idempotent re-persist of the previous (now stale) version: moves its bytes
+        if (v > 1) {
+            for (uint8_t n = 0; n < 16; ++n) store.put(key_at(v - 1, {n}), make_leaf(n));
+        }
+        if (v % 10 == 0) store.prune(v - 5);  // Compacts along the way
+    }
+    assert(store.stats().stale_pending == 5 * 16);
+    assert(store.prune(30) == 5 * 16 && store.size() == 16 && store.stats().stale_pending == 0);
+    assert(store.get(key_at(30, {9})) && !store.get(key_at(29, {9})));
+    std::cout << "  ✅ " << store.stats().pruned_nodes << " nodes pruned, " << store.stats().compactions
+              << " compaction(s)" << std::endl;
+}
+
+void test_concurrent_readers() {
+    std::cout << "[TEST] Readers concurrent with writer + pruning..." << std::endl;
+
+    NodeArenaStore store(8192);
+    store.enable_stale_tracking();
+    store.put(key_at(0, {}), make_leaf(0));
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                for (uint8_t n = 0; n < 16; ++n) {
+                    if (auto bytes = store.get(key_at(0, {n}))) assert(deserialize_node_from_bytes(*bytes));
+                }
+                (void)store.stats();
+            }
+        });
+    }
+    for (uint64_t v = 1; v <= 200; ++v) {
+        for (uint8_t n = 0; n < 16; ++n) store.put(key_at(v, {n}), make_leaf(n));
+        store.prune(v - 1);
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+    assert(store.size() == 1 + 2 * 16);
+    std::cout << "  ✅ No torn reads" << std::endl;
+}
+
+void test_adapter_test_mode() {
+    std::cout << "[TEST] XookAdapter without KVStore keeps committed nodes..." << std::endl;
+
+    XookAdapter adapter;
+    assert(adapter.in_memory_store());
+    adapter.set_in_memory_retention(2);
+
+    Hash root{};
+    for (uint64_t v = 1; v <= 10; ++v) {
+        Hash value;
+        value.fill(static_cast<uint8_t>(v));
+        root = adapter.calculate_root({{Bytes{1, 2, 3}, value}}, root, v).new_root_hash;
+    }
+    assert(adapter.in_memory_store()->size() > 0);
+    assert(adapter.in_memory_store()->stats().pruned_nodes > 0);
+    std::cout << "  ✅ " << adapter.in_memory_store()->size() << " nodes retained" << std::endl;
+}
+
+int main() {
+    test_put_get();
+    test_prune_superseded();
+    test_rewrites_keep_stale_index();
+    test_concurrent_readers();
+    test_adapter_test_mode();
+
+    std::cout << "\nALL NODE ARENA STORE TESTS PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,109 @@
+// =========================================================
+// FILE: tests/xook/test_numa_tree_cache.cpp
+// PURPOSE: NumaTreeCache routing, budgeting and node-local handle lifetime
+// NOTE: Runs on any machine; single-node hosts exercise one replica + one shard
+// =========================================================
+
+#include "../../src/xook/numa_tree_cache.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+
+void test_topology() {
+    std::cout << "[TEST] Topology discovery..." << std::endl;
+
+    const auto& topo = NumaTopology::system();
+    assert(topo.node_count() >= 1);
+    assert(topo.current_node() < topo.node_count());
+    for (uint8_t nibble = 0; nibble < 16; ++nibble) {
+        assert(topo.home_node_for_nibble(nibble) < topo.node_count());
+    }
+    assert(topo.home_node_for_nibble(0) == 0);
+    assert(topo.home_node_for_nibble(15) == topo.node_count() - 1);
+    std::cout << "  ✅ " << topo.node_count() << " node(s), current node " << topo.current_node() << std::endl;
+}
+
+void test_pinned_and_deep_routing() {
+    std::cout << "[TEST] Pinned levels replicated, deep levels sharded..." << std::endl;
+
+    NumaTreeCache cache(1000, 2);
+    cache.put(make_key(1, 0, 0), make_leaf(1));   // Root: pinned
+    cache.put(make_key(1, 5, 1), make_leaf(2));   // Depth 1: pinned
+    cache.put(make_key(1, 0x35, 2), make_leaf(3));  // Depth 2: shard of nibble 5
+    assert(cache.size() == 3);
+
+    assert(cache.get(make_key(1, 0, 0)).has_value());
+    assert(cache.get(make_key(1, 5, 1)).has_value());
+    auto deep = cache.get_shared(make_key(1, 0x35, 2));
+    assert(deep && std::get<LeafNode>(*deep).account_key[0] == 3);
+    assert(!cache.get_shared(make_key(1, 0x36, 2)));
+
+    cache.clear();
+    assert(cache.size() == 0);
+    assert(cache.approx_bytes() == 0);
+    std::cout << "  ✅ Lookups routed to replica / home shard" << std::endl;
+}
+
+void test_shrink_and_handle_lifetime() {
+    std::cout << "[TEST] Shrink deep shards; handles outlive the cache..." << std::endl;
+
+    NodeHandle survivor;
+    {
+        NumaTreeCache cache(10000, 1);
+        for (uint64_t i = 0; i < 2000; ++i) cache.put(make_key(1, i, 4), make_leaf(static_cast<uint8_t>(i)));
+        size_t before = cache.approx_bytes();
+        size_t released = cache.shrink_to_bytes(before / 4);
+        assert(released > 0);
+        assert(cache.approx_bytes() <= before / 4 + 1024);
+
+        survivor = cache.get_shared(make_key(1, 1999, 4));
+        assert(survivor);
+    }
+    // Node-local pool is kept alive by the handle's allocator
+    assert(std::get<LeafNode>(*survivor).account_key[0] == static_cast<uint8_t>(1999));
+    survivor.reset();
+    std::cout << "  ✅ Budget respected, no dangling node memory" << std::endl;
+}
+
+void test_forwarded_queries() {
+    std::cout << "[TEST] Policy, supersede, listener and index queries reach the partitions..." << std::endl;
+
+    NumaTreeCache cache(8, 1);
+    cache.set_eviction_policy(EvictionPolicy::GreedyDual);
+    cache.set_supersede_policy(SupersedePolicy::Demote);
+    assert(!cache.committed_index_enabled() && !cache.thread_local_l1_enabled());
+    cache.enable_committed_index();
+    cache.enable_thread_local_l1();
+    assert(cache.committed_index_enabled() && cache.thread_local_l1_enabled());
+    assert(cache.eviction_policy() == EvictionPolicy::GreedyDual);
+    assert(cache.supersede_policy() == SupersedePolicy::Demote);
+
+    size_t evicted = 0;
+    cache.set_eviction_listener([&evicted](const NodeKey&, const NodeHandle&, bool) { ++evicted; });
+    cache.put(make_key(1, 0x21, 2), make_leaf(1));
+    cache.publish_committed(1);
+    assert(cache.visit_committed(make_key(1, 0x21, 2), [](const Node& node) {
+        assert(std::get<LeafNode>(node).account_key[0] == 1);
+    }));
+    cache.put(make_key(2, 0x21, 2), make_leaf(2));
+    assert(cache.supersede_backlog() == 1);
+    cache.publish_committed(2);
+    assert(cache.superseded_count() == 1);
+
+    for (uint64_t i = 0; i < 100; ++i) cache.put(make_key(3, i, 3), make_leaf(static_cast<uint8_t>(i)));
+    assert(evicted > 0);
+    std::cout << "  ✅ " << evicted << " evictions reported; superseded and index lookups routed" << std::endl;
+}
+
+int main() {
+    test_topology();
+    test_pinned_and_deep_routing();
+    test_shrink_and_handle_lifetime();
+    test_forwarded_queries();
+
+    std::cout << "\nALL NUMA TREE CACHE TESTS PASSED" << std::endl;
+    return 0;
+}
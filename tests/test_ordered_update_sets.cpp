@@ -0,0 +1,211 @@
+// =========================================================
+// FILE: tests/xook/test_ordered_update_sets.cpp
+// PURPOSE: Partial update sets: order-key resolution, conflicts, serial-equivalent roots
+// =========================================================
+
+#include "../../src/xook/ordered_update_sets.hpp"
+#include "../../src/xook/sharded_state.hpp"
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <random>
+#include <thread>
+
+using namespace glofica::xook;
+using glofica::Hash;
+using glofica::Bytes;
+
+using UpdateList = std::vector<std::pair<Bytes, Hash>>;
+
+static Bytes key_of(uint32_t i) {
+    return Bytes{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x3C};
+}
+
+/// @brief 12 sets over 600 keys; neighbouring sets overlap on ~10% of their keys
+static std::vector<UpdateList> make_sets() {
+    std::mt19937 rng(2024);
+    std::vector<UpdateList> sets(12);
+    for (uint32_t s = 0; s < sets.size(); ++s) {
+        for (uint32_t n = 0; n < 80; ++n) {
+            uint32_t i = (s * 50 + n) % 600;
+            Hash value;
+            value.fill(static_cast<uint8_t>(rng()));
+            sets[s].emplace_back(key_of(i), value);
+        }
+    }
+    return sets;
+}
+
+/// @brief Serial application in order: key hash -> (key, value), last write wins
+static std::map<Hash, std::pair<Bytes, Hash>> apply_serially(const std::vector<UpdateList>& sets) {
+    std::map<Hash, std::pair<Bytes, Hash>> state;
+    for (const auto& set : sets) {
+        for (const auto& [key, value] : set) state[glofica::hash::blake3(key)] = {key, value};
+    }
+    return state;
+}
+
+/// @brief Order keys are sparse and submitted from threads in a scrambled order
+static ResolvedUpdates submit_concurrently(const std::vector<UpdateList>& sets, size_t resolve_threads) {
+    OrderedUpdateSets pending;
+    std::vector<std::thread> producers;
+    for (size_t s = 0; s < sets.size(); ++s) {
+        size_t index = (s * 7) % sets.size();
+        producers.emplace_back([&pending, &sets, index] { pending.submit(100 + index * 10, sets[index]); });
+    }
+    for (auto& p : producers) p.join();
+    assert(pending.size() == sets.size());
+    return pending.resolve(resolve_threads);
+}
+
+void test_resolution_matches_serial() {
+    std::cout << "[TEST] Resolution == serial application in order..." << std::endl;
+
+    auto sets = make_sets();
+    auto serial = apply_serially(sets);
+    ResolvedUpdates one = submit_concurrently(sets, 1);
+    ResolvedUpdates four = submit_concurrently(sets, 4);
+
+    assert(one.sets == sets.size());
+    assert(one.updates == four.updates);
+    assert(one.updates.size() == serial.size());
+    size_t i = 0;
+    for (const auto& [key_hash, entry] : serial) {
+        assert(one.updates[i].first == key_hash && one.updates[i].second == entry.second);
+        ++i;
+    }
+
+    // Conflicts: every key written by two sets, won by the later one
+    std::map<Hash, std::vector<uint64_t>> writers;
+    for (size_t s = 0; s < sets.size(); ++s) {
+        for (const auto& [key, value] : sets[s]) writers[glofica::hash::blake3(key)].push_back(100 + s * 10);
+    }
+    size_t expected = 0;
+    for (const auto& [key_hash, orders] : writers) expected += orders.size() > 1;
+    assert(one.conflicts.size() == expected && expected > 0);
+    for (const auto& conflict : one.conflicts) {
+        const auto& orders = writers[conflict.key_hash];
+        assert(conflict.winner == orders.back());
+        assert(conflict.overridden == std::vector<uint64_t>(orders.begin(), orders.end() - 1));
+    }
+    assert(one.conflicts.size() == four.conflicts.size());
+    std::cout << "  ✅ " << one.updates.size() << " keys, " << one.conflicts.size() << " conflicts resolved" << std::endl;
+}
+
+void test_set_rules() {
+    std::cout << "[TEST] In-set duplicates, duplicate order keys, empty sets..." << std::endl;
+
+    OrderedUpdateSets pending;
+    Hash a, b;
+    a.fill(1);
+    b.fill(2);
+    pending.submit(5, {{key_of(1), a}, {key_of(1), b}});  // Same set: last write wins, no conflict
+    pending.submit(9, {});
+
+    bool rejected = false;
+    try { pending.submit(5, {{key_of(2), a}}); } catch (const std::invalid_argument&) { rejected = true; }
+    assert(rejected);
+
+    ResolvedUpdates resolved = pending.resolve();
+    assert(resolved.updates.size() == 1 && resolved.updates[0].second == b);
+    assert(resolved.conflicts.empty() && resolved.sets == 2);
+
+    pending.clear();
+    assert(pending.size() == 0 && pending.resolve().updates.empty());
+    std::cout << "  ✅ Set rules hold" << std::endl;
+}
+
+/// @brief Serial result as one canonical (key-hash ordered) update list
+static UpdateList canonical_list(const std::map<Hash, std::pair<Bytes, Hash>>& serial) {
+    UpdateList list;
+    for (const auto& [key_hash, entry] : serial) list.push_back(entry);
+    return list;
+}
+
+void test_adapter_roots() {
+    std::cout << "[TEST] XookAdapter: ordered commit root == serial commit root..." << std::endl;
+
+    auto sets = make_sets();
+    XookAdapter ordered, serial;
+    Hash ordered_root{}, serial_root{};
+
+    // A pending put() of a key the sets also write loses to the sets
+    Hash stale;
+    stale.fill(0xEE);
+    ordered.put(sets[3][0].first, stale, 1);
+
+    ordered_root = ordered.calculate_root(submit_concurrently(sets, 4), ordered_root, 1).new_root_hash;
+    serial_root = serial.calculate_root(canonical_list(apply_serially(sets)), serial_root, 1).new_root_hash;
+    assert(ordered_root == serial_root);
+
+    // Second version, sets in a different arrangement
+    std::reverse(sets.begin(), sets.end());
+    ordered_root = ordered.calculate_root(submit_concurrently(sets, 2), ordered_root, 2).new_root_hash;
+    serial_root = serial.calculate_root(canonical_list(apply_serially(sets)), serial_root, 2).new_root_hash;
+    assert(ordered_root == serial_root);
+    std::cout << "  ✅ Roots match over 2 versions" << std::endl;
+}
+
+void test_pending_rule_all_paths() {
+    std::cout << "[TEST] Pending put() vs explicit update: same root on every commit path..." << std::endl;
+
+    Hash stale, fresh, other;
+    stale.fill(0xEE);
+    fresh.fill(0x11);
+    other.fill(0x22);
+    const Bytes key = key_of(7);
+    auto commit = [&](auto&& calculate) {
+        XookAdapter adapter;
+        adapter.put(key, stale, 1);             // Older than the commit's own updates
+        adapter.put(key_of(8), other, 1);       // Not overwritten: committed as is
+        Hash root = calculate(adapter).new_root_hash;
+        assert(adapter.get(key, 1) == glofica::hash::blake3(Bytes(fresh.begin(), fresh.end())));
+        return root;
+    };
+
+    Hash legacy = commit([&](XookAdapter& a) { return a.calculate_root(UpdateList{{key, fresh}}, Hash{}, 1); });
+    Hash resolved = commit([&](XookAdapter& a) {
+        OrderedUpdateSets pending;
+        pending.submit(1, {{key, fresh}});
+        return a.calculate_root(pending.resolve(), Hash{}, 1);
+    });
+    Hash hashed = commit([&](XookAdapter& a) {
+        return a.calculate_root_hashed({{glofica::hash::blake3(key), fresh}}, Hash{}, 1);
+    });
+    assert(legacy == resolved && resolved == hashed);
+
+    XookAdapter plain;
+    Hash expected = plain.calculate_root(UpdateList{{key, fresh}, {key_of(8), other}}, Hash{}, 1).new_root_hash;
+    assert(legacy == expected);
+    std::cout << "  ✅ Explicit update wins on calculate_root(updates / resolved) and calculate_root_hashed" << std::endl;
+}
+
+void test_sharded_parallel_apply() {
+    std::cout << "[TEST] ShardedXookState applies shard slices concurrently..." << std::endl;
+
+    auto sets = make_sets();
+    ShardedXookState ordered(8), serial(8);
+    ShardedCommit a = ordered.calculate_root(submit_concurrently(sets, 4), 1);
+    ShardedCommit b = serial.calculate_root(canonical_list(apply_serially(sets)), 1);
+    assert(a.root == b.root);
+    assert(a.shard_roots == b.shard_roots);
+    assert(a.committed_shards == b.committed_shards && a.committed_shards.size() == 8);
+
+    // The aggregate root is its own state format, not the unsharded tree's root
+    XookAdapter unsharded;
+    assert(unsharded.calculate_root(submit_concurrently(sets, 4), Hash{}, 1).new_root_hash != a.root);
+    std::cout << "  ✅ Same top-level root, " << a.committed_shards.size() << " shards committed" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== ORDERED UPDATE SETS TESTS ===\n" << std::endl;
+
+    test_resolution_matches_serial();
+    test_set_rules();
+    test_adapter_roots();
+    test_pending_rule_all_paths();
+    test_sharded_parallel_apply();
+
+    std::cout << "\n=== ALL ORDERED UPDATE SETS TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,104 @@
+// =========================================================
+// FILE: tests/xook/test_pmr_node_types.cpp
+// PURPOSE: Allocator-aware node types encode, hash and look up identically
+// =========================================================
+
+#include "../../src/xook/node_serde.hpp"
+#include "../../src/xook/node_type_hash.hpp"
+#include "../../src/xook/block_arena.hpp"
+#include <iostream>
+#include <cassert>
+#include <unordered_map>
+
+using namespace glofica::xook;
+
+static InternalNode make_internal() {
+    InternalNode node;
+    for (uint8_t n = 0; n < 16; n += 3) {
+        glofica::Hash h{};
+        h.fill(static_cast<uint8_t>(n + 1));
+        node.set_child(n, h, 100 + n);
+    }
+    return node;
+}
+
+static NodeKey make_key(uint64_t version, size_t depth) {
+    NodeKey key;
+    key.version = version;
+    for (size_t n = 0; n < depth; ++n) key.nibble_path.push(static_cast<uint8_t>((n * 5) & 0x0F));
+    return key;
+}
+
+void test_identical_encoding_and_hash() {
+    std::cout << "[TEST] pmr nodes serialize and hash like heap nodes..." << std::endl;
+
+    BlockArena arena(4096);
+    Node internal = make_internal();
+    LeafNode leaf;
+    leaf.account_key.fill(0x11);
+    leaf.value_hash.fill(0x22);
+
+    pmr::Node pmr_internal = to_pmr(internal, arena.resource());
+    pmr::Node pmr_leaf = to_pmr(Node(leaf), arena.resource());
+
+    assert(pmr::hash_node(pmr_internal) == hash_node(internal));
+    assert(pmr::hash_node(pmr_leaf) == hash_node(Node(leaf)));
+
+    auto heap_bytes = serialize_node_with_prefix(internal);
+    auto arena_bytes = serialize_node_with_prefix(pmr_internal, arena.resource());
+    assert(glofica::Bytes(arena_bytes.begin(), arena_bytes.end()) == heap_bytes);
+
+    // Round trip back to heap types
+    Node back = to_std(pmr_internal);
+    assert(std::get<InternalNode>(back).children.size() == std::get<InternalNode>(internal).children.size());
+    assert(hash_node(back) == hash_node(internal));
+    std::cout << "  ✅ Same bytes, same hashes" << std::endl;
+}
+
+void test_heterogeneous_lookup() {
+    std::cout << "[TEST] NodeKey finds pmr::NodeKey entries..." << std::endl;
+
+    BlockArena arena(1 << 16);
+    std::pmr::unordered_map<pmr::NodeKey, int, NodeKeyHash, NodeKeyEqual> map(arena.resource());
+    for (uint64_t v = 0; v < 50; ++v) map.emplace(to_pmr(make_key(v, v % 20), arena.resource()), static_cast<int>(v));
+
+    for (uint64_t v = 0; v < 50; ++v) {
+        NodeKey key = make_key(v, v % 20);
+        assert(std::hash<NodeKey>{}(key) == std::hash<pmr::NodeKey>{}(to_pmr(key, arena.resource())));
+        auto it = map.find(key);  // No conversion of the probe key
+        assert(it != map.end() && it->second == static_cast<int>(v));
+        assert(to_std(it->first) == key);
+    }
+    assert(map.find(make_key(7, 8)) == map.end());
+    std::cout << "  ✅ 50 lookups without converting the probe key" << std::endl;
+}
+
+void test_arena_growth() {
+    std::cout << "[TEST] BlockArena grows to the block high-water mark..." << std::endl;
+
+    BlockArena arena(1024);
+    for (int i = 0; i < 100; ++i) {
+        auto node = to_pmr(Node(make_internal()), arena.resource());
+        (void)node;
+    }
+    arena.reset();
+    size_t grown = arena.capacity();
+    assert(grown > 1024);
+
+    for (int i = 0; i < 100; ++i) {
+        auto node = to_pmr(Node(make_internal()), arena.resource());
+        (void)node;
+    }
+    arena.reset();
+    assert(arena.capacity() == grown);  // Steady state: no further growth
+    std::cout << "  ✅ Capacity " << grown << " bytes after first block, stable after" << std::endl;
+}
+
+int main() {
+    test_identical_encoding_and_hash();
+    test_heterogeneous_lookup();
+    test_arena_growth();
+
+    std::cout << "\nALL PMR NODE TYPE TESTS PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,302 @@
+// =========================================================
+// FILE: tests/xook/test_shadow_adapter.cpp
+// PURPOSE: Shadow mode: async verdicts, bounded lag, detach, real XookAdapter secondary
+// =========================================================
+
+#include "../../src/xook/shadow_adapter.hpp"
+#include <iostream>
+#include <cassert>
+#include <map>
+
+using namespace glofica::xook;
+using glofica::Hash;
+using glofica::Hash256;
+using glofica::Bytes;
+
+template <typename Updates>
+static void append(Bytes& buf, const Updates& updates) {
+    for (const auto& [k, v] : updates) {
+        buf.insert(buf.end(), k.begin(), k.end());
+        buf.insert(buf.end(), v.begin(), v.end());
+    }
+}
+
+// Legacy stand-in: root = first 32 bytes of blake3(previous root || updates)
+class FakeLegacy {
+public:
+    std::vector<std::pair<Bytes, Hash256>> pending;
+    Hash256 root{};
+
+    void put(const Bytes& key, const Hash256& value, uint64_t) { pending.emplace_back(key, value); }
+
+    Hash256 calculate_root(const std::vector<std::pair<Bytes, Hash256>>& updates, const Hash256&, uint64_t version) {
+        Bytes buf(root.begin(), root.end());
+        buf.push_back(static_cast<uint8_t>(version));
+        append(buf, updates);
+        append(buf, pending);
+        pending.clear();
+        Hash full = glofica::hash::blake3(buf);
+        std::copy(full.begin(), full.begin() + 32, root.begin());
+        return root;
+    }
+
+    // Pending put()s stay pending, as in XMTLegacyAdapter
+    void update_batch_with_precomputed_hashes(const std::vector<std::pair<Bytes, Hash256>>& updates, uint64_t version) {
+        Bytes buf(root.begin(), root.end());
+        buf.push_back(static_cast<uint8_t>(version));
+        append(buf, updates);
+        Hash full = glofica::hash::blake3(buf);
+        std::copy(full.begin(), full.begin() + 32, root.begin());
+    }
+
+    Hash256 get_root_hash(uint64_t) const { return root; }
+};
+
+// XOOK stand-in: deterministic chained root, optionally slow or failing
+class FakeXook {
+public:
+    std::vector<std::pair<Bytes, Hash>> pending;
+    std::chrono::microseconds delay{0};
+    std::optional<uint64_t> throw_at;
+
+    void put(const Bytes& key, const Hash& value, uint64_t) { pending.emplace_back(key, value); }
+
+    Hash calculate_root(const std::vector<std::pair<Bytes, Hash>>& updates, const Hash& base_root, uint64_t version) {
+        if (delay.count() > 0) std::this_thread::sleep_for(delay);
+        if (throw_at && version == *throw_at) throw std::runtime_error("secondary failed");
+        Bytes buf(base_root.begin(), base_root.end());
+        append(buf, updates);
+        append(buf, pending);
+        pending.clear();
+        return glofica::hash::blake3(buf);
+    }
+};
+
+using Shadow = ShadowAdapter<FakeLegacy, FakeXook>;
+
+static std::vector<std::pair<Bytes, Hash256>> block_updates(uint64_t version) {
+    std::vector<std::pair<Bytes, Hash256>> updates;
+    for (uint8_t i = 0; i < 4; ++i) {
+        Hash256 value;
+        value.fill(static_cast<uint8_t>(version * 7 + i));
+        updates.emplace_back(Bytes{static_cast<uint8_t>(version), i}, value);
+    }
+    return updates;
+}
+
+// Expected XOOK roots, produced by a reference secondary driven synchronously
+static std::map<uint64_t, Hash> reference_roots(uint64_t blocks) {
+    FakeXook reference;
+    std::map<uint64_t, Hash> roots;
+    Hash root{};
+    for (uint64_t v = 1; v <= blocks; ++v) {
+        Hash256 extra;
+        extra.fill(0xAA);
+        reference.put(Bytes{0xFF, static_cast<uint8_t>(v)}, Shadow::widen_value_hash(extra), v);
+        std::vector<std::pair<Bytes, Hash>> widened;
+        for (const auto& [k, value] : block_updates(v)) widened.emplace_back(k, Shadow::widen_value_hash(value));
+        root = reference.calculate_root(widened, root, v);
+        roots[v] = root;
+    }
+    return roots;
+}
+
+void test_async_verdicts() {
+    std::cout << "[TEST] Shadow verdicts match expectation, one divergence reported..." << std::endl;
+
+    auto expected = reference_roots(20);
+    expected[13][0] ^= 0x01;  // Corrupted expectation: must surface as a divergence
+
+    FakeLegacy legacy;
+    FakeXook xook;
+    xook.delay = std::chrono::microseconds(200);
+    std::mutex reports_mutex;
+    std::vector<ShadowReport> reports;
+
+    Shadow::Options options;
+    options.max_lag_blocks = 4;
+    {
+        Shadow shadow(&legacy, &xook, options,
+                      [&](uint64_t v, const Hash256&) -> std::optional<Hash> { return expected.at(v); },
+                      [&](const ShadowReport& r) {
+                          std::lock_guard<std::mutex> lock(reports_mutex);
+                          reports.push_back(r);
+                      });
+
+        for (uint64_t v = 1; v <= 20; ++v) {
+            Hash256 extra;
+            extra.fill(0xAA);
+            shadow.put(Bytes{0xFF, static_cast<uint8_t>(v)}, extra, v);
+            Hash256 root = shadow.calculate_root(block_updates(v), Hash256{}, v);
+            assert(root == legacy.root);  // Primary answer, immediately
+        }
+        shadow.drain();
+
+        auto stats = shadow.stats();
+        assert(stats.blocks_submitted == 20 && stats.blocks_checked == 20);
+        assert(stats.divergences == 1 && stats.first_divergence == 13);
+        assert(stats.max_queue_depth <= options.max_lag_blocks);
+        assert(stats.lag.count == 20);
+        assert(!stats.detached);
+    }
+    assert(reports.size() == 1 && reports[0].version == 13 && reports[0].error.empty());
+    std::cout << "  ✅ 20 blocks checked off-thread, divergence at v13 reported" << std::endl;
+}
+
+void test_detach_on_overflow() {
+    std::cout << "[TEST] Detach policy never stalls the primary..." << std::endl;
+
+    FakeLegacy legacy;
+    FakeXook xook;
+    xook.delay = std::chrono::milliseconds(20);
+    std::atomic<int> detach_reports{0};
+    std::atomic<bool> on_committer{false};
+    const std::thread::id committer = std::this_thread::get_id();
+
+    Shadow::Options options;
+    options.max_lag_blocks = 2;
+    options.overflow = ShadowOverflow::Detach;
+    Shadow shadow(&legacy, &xook, options, {}, [&](const ShadowReport& r) {
+        if (!r.error.empty()) ++detach_reports;
+        if (std::this_thread::get_id() == committer) on_committer = true;
+    });
+
+    for (uint64_t v = 1; v <= 10; ++v) shadow.calculate_root(block_updates(v), Hash256{}, v);
+    shadow.drain();
+
+    auto stats = shadow.stats();
+    assert(shadow.detached() && stats.detached);
+    assert(stats.primary_stalls == 0);
+    assert(stats.blocks_submitted <= 3 && detach_reports == 1);
+    assert(!on_committer);  // The detach report comes from the shadow thread too
+    std::cout << "  ✅ Detached after " << stats.blocks_submitted << " queued blocks" << std::endl;
+}
+
+void test_resume_from_initial_root() {
+    std::cout << "[TEST] Shadow started mid-chain from a known secondary root..." << std::endl;
+
+    auto expected = reference_roots(15);
+    FakeLegacy legacy;
+    FakeXook xook;
+    std::vector<ShadowReport> reports;
+    Shadow::Options options;
+    options.initial_root = expected[10];
+    {
+        Shadow shadow(&legacy, &xook, options,
+                      [&](uint64_t v, const Hash256&) -> std::optional<Hash> { return expected.at(v); },
+                      [&](const ShadowReport& r) { reports.push_back(r); });
+        for (uint64_t v = 11; v <= 15; ++v) {
+            Hash256 extra;
+            extra.fill(0xAA);
+            shadow.put(Bytes{0xFF, static_cast<uint8_t>(v)}, extra, v);
+            shadow.calculate_root(block_updates(v), Hash256{}, v);
+        }
+        shadow.drain();
+        assert(shadow.stats().blocks_checked == 5);
+    }
+    assert(reports.empty());  // Every block matched, chained from the v10 root
+    std::cout << "  ✅ Blocks 11-15 verified against the reference" << std::endl;
+}
+
+void test_secondary_failure_is_divergence() {
+    std::cout << "[TEST] Secondary exception becomes a divergence report..." << std::endl;
+
+    FakeLegacy legacy;
+    FakeXook xook;
+    xook.throw_at = 3;
+    std::vector<ShadowReport> reports;
+    {
+        Shadow shadow(&legacy, &xook, {}, {}, [&](const ShadowReport& r) { reports.push_back(r); });
+        for (uint64_t v = 1; v <= 5; ++v) shadow.calculate_root(block_updates(v), Hash256{}, v);
+        shadow.drain();
+        // No expectation to resync from: the shadow chain ends at v3
+        assert(shadow.detached() && shadow.stats().detached);
+        assert(shadow.stats().blocks_checked == 3);
+    }
+    assert(reports.size() == 1 && reports[0].version == 3 && reports[0].error == "secondary failed");
+    std::cout << "  ✅ Reported with error, shadow detached" << std::endl;
+}
+
+void test_failure_resyncs_from_expectation() {
+    std::cout << "[TEST] After a secondary failure the shadow continues from the expected root..." << std::endl;
+
+    FakeXook reference;
+    std::map<uint64_t, Hash> expected;
+    Hash root{};
+    for (uint64_t v = 1; v <= 6; ++v) {
+        std::vector<std::pair<Bytes, Hash>> widened;
+        for (const auto& [k, value] : block_updates(v)) widened.emplace_back(k, Shadow::widen_value_hash(value));
+        root = reference.calculate_root(widened, root, v);
+        expected[v] = root;
+    }
+
+    FakeLegacy legacy;
+    FakeXook xook;
+    xook.throw_at = 3;
+    std::vector<ShadowReport> reports;
+    {
+        Shadow shadow(&legacy, &xook, {},
+                      [&](uint64_t v, const Hash256&) -> std::optional<Hash> { return expected.at(v); },
+                      [&](const ShadowReport& r) { reports.push_back(r); });
+        for (uint64_t v = 1; v <= 6; ++v) shadow.calculate_root(block_updates(v), Hash256{}, v);
+        shadow.drain();
+        assert(!shadow.detached() && shadow.stats().blocks_checked == 6 && shadow.stats().divergences == 1);
+    }
+    assert(reports.size() == 1 && reports[0].version == 3 && reports[0].error == "secondary failed");
+    assert(reports[0].expected == expected[3]);
+    std::cout << "  ✅ Only the failed block reported; v4-v6 verified" << std::endl;
+}
+
+void test_xook_adapter_secondary() {
+    std::cout << "[TEST] XookAdapter as the shadow tree (record-only)..." << std::endl;
+
+    FakeLegacy legacy;
+    XookAdapter xook;
+    XookAdapter reference;
+    std::vector<ShadowReport> reports;
+    ShadowAdapter<FakeLegacy>::Options options;
+    options.report_all = true;
+    {
+        ShadowAdapter<FakeLegacy> shadow(&legacy, &xook, options, {},
+                                         [&](const ShadowReport& r) { reports.push_back(r); });
+        for (uint64_t v = 1; v <= 5; ++v) {
+            if (v == 3) {
+                // Precomputed-hash block: mirrored too; the pending put() waits for v4
+                shadow.put(Bytes{0xFF, 0x03}, Hash256{}, v);
+                shadow.update_batch_with_precomputed_hashes(block_updates(v), v);
+                assert(legacy.pending.size() == 1);
+            } else {
+                shadow.calculate_root(block_updates(v), Hash256{}, v);
+            }
+        }
+    }
+
+    Hash root{};
+    for (uint64_t v = 1; v <= 5; ++v) {
+        std::vector<std::pair<Bytes, Hash>> widened;
+        for (const auto& [k, value] : block_updates(v)) {
+            widened.emplace_back(k, ShadowAdapter<FakeLegacy>::widen_value_hash(value));
+        }
+        if (v == 3) {
+            reference.put(Bytes{0xFF, 0x03}, ShadowAdapter<FakeLegacy>::widen_value_hash(Hash256{}), v);
+            root = reference.update_batch_with_precomputed_hashes(widened, v, root).new_root_hash;
+        } else {
+            root = reference.calculate_root(widened, root, v).new_root_hash;
+        }
+        assert(reports[v - 1].shadow_root == root && !reports[v - 1].diverged);
+    }
+    assert(reports[2].primary_root != reports[1].primary_root);
+    std::cout << "  ✅ Shadow roots equal a synchronously driven XookAdapter (incl. a precomputed block)" << std::endl;
+}
+
+int main() {
+    test_async_verdicts();
+    test_detach_on_overflow();
+    test_resume_from_initial_root();
+    test_secondary_failure_is_divergence();
+    test_failure_resyncs_from_expectation();
+    test_xook_adapter_secondary();
+
+    std::cout << "\nALL SHADOW ADAPTER TESTS PASSED" << std::endl;
+    return 0;
+}
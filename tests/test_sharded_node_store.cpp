@@ -0,0 +1,155 @@
+// =========================================================
+// FILE: tests/xook/test_sharded_node_store.cpp
+// PURPOSE: Key-range node placement over M KVStores: ranges, subtrees, adapter
+// =========================================================
+
+#include "../../src/xook/sharded_node_store.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+using glofica::Hash;
+using glofica::Bytes;
+
+static Hash value_of(uint32_t i, uint64_t version) {
+    Hash v;
+    v.fill(static_cast<uint8_t>(i * 13 + version));
+    return v;
+}
+
+static Bytes key_of(uint32_t i) {
+    return Bytes{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0xA5};
+}
+
+void test_partitioner_ranges() {
+    std::cout << "[TEST] Key ranges are contiguous and cover every prefix..." << std::endl;
+
+    for (size_t stores : {1, 2, 3, 5, 16}) {
+        KeyRangePartitioner p(stores, 1);
+        size_t previous = 0;
+        for (uint8_t n = 0; n < 16; ++n) {
+            size_t s = p.store_of(key_at(0, {n}).nibble_path);
+            assert(s < stores && s >= previous);  // Monotone in the prefix: contiguous ranges
+            if (n > 0) assert(s - previous <= 1);
+            if (s != previous || n == 0) assert(p.range_begin(s) == n);
+            previous = s;
+        }
+        assert(previous == stores - 1);  // Every store owns a range
+    }
+
+    // Deeper partitioning: 100 stores over 256 two-nibble prefixes
+    KeyRangePartitioner deep(100, 2);
+    std::vector<size_t> counts(100, 0);
+    for (uint8_t a = 0; a < 16; ++a) {
+        for (uint8_t b = 0; b < 16; ++b) ++counts[deep.store_of(key_at(0, {a, b}).nibble_path)];
+    }
+    for (size_t c : counts) assert(c == 2 || c == 3);
+
+    bool rejected = false;
+    try { KeyRangePartitioner bad(17, 1); } catch (const std::invalid_argument&) { rejected = true; }
+    assert(rejected);
+    std::cout << "  ✅ Monotone ranges, balanced at depth 2, oversubscription rejected" << std::endl;
+}
+
+void test_subtree_stays_on_one_store() {
+    std::cout << "[TEST] Whole subtree (every version) on one store..." << std::endl;
+
+    KeyRangePartitioner p(4, 1);
+    for (uint8_t n = 0; n < 16; ++n) {
+        size_t home = p.store_of(key_at(1, {n}).nibble_path);
+        for (uint8_t m = 0; m < 16; ++m) {
+            assert(p.store_of(key_at(7, {n, m}).nibble_path) == home);
+            assert(p.store_of(key_at(9, {n, m, 3, 15}).nibble_path) == home);
+        }
+    }
+    // Root is zero-padded: store 0
+    assert(p.store_of(key_at(5, {}).nibble_path) == 0);
+
+    KeyRangePartitioner two(8, 2);
+    // Depth-1 node 0xF pads to 0xF0 → the store whose range starts there
+    assert(two.store_of(key_at(1, {15}).nibble_path) == two.store_of(key_at(1, {15, 0}).nibble_path));
+    std::cout << "  ✅ Placement ignores version and deeper nibbles" << std::endl;
+}
+
+void test_write_batch_and_read() {
+    std::cout << "[TEST] Batch write spreads nodes, reads hit one store..." << std::endl;
+
+    std::vector<glofica::kv::KVStore> dbs(4);
+    ShardedNodeStore store({&dbs[0], &dbs[1], &dbs[2], &dbs[3]});
+
+    std::vector<std::pair<NodeKey, Node>> batch;
+    for (uint8_t n = 0; n < 16; ++n) {
+        LeafNode leaf;
+        leaf.account_key.fill(n);
+        leaf.value_hash.fill(static_cast<uint8_t>(n + 1));
+        batch.emplace_back(key_at(3, {n, 1}), leaf);
+    }
+    store.write_batch(batch);
+
+    for (uint8_t n = 0; n < 16; ++n) {
+        NodeKey key = key_at(3, {n, 1});
+        auto bytes = store.get_node_bytes(key);
+        assert(bytes);
+        assert(std::get<LeafNode>(*deserialize_node_from_bytes(*bytes)).account_key[0] == n);
+        // Only the owning store has it
+        for (size_t s = 0; s < dbs.size(); ++s) assert(dbs[s].get(key.serialize()).has_value() == (s == store.store_of(key)));
+    }
+    assert(!store.get_node_bytes(key_at(4, {0, 1})));
+
+    auto stats = store.stats();
+    assert(stats.batches == 1);
+    for (uint64_t n : stats.nodes_written) assert(n == 4);
+    std::cout << "  ✅ 16 nodes → 4 per store" << std::endl;
+}
+
+void test_adapter_over_sharded_stores() {
+    std::cout << "[TEST] XookAdapter over 4 stores == in-memory adapter..." << std::endl;
+
+    std::vector<glofica::kv::KVStore> dbs(4);
+    auto store = std::make_shared<ShardedNodeStore>(std::vector<glofica::kv::KVStore*>{&dbs[0], &dbs[1], &dbs[2], &dbs[3]});
+    XookAdapter sharded(store);
+    XookAdapter reference;
+
+    Hash sharded_root{}, reference_root{};
+    for (uint64_t v = 1; v <= 5; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 300; ++i) {
+            if ((i + v) % 3 == 0) updates.emplace_back(key_of(i), value_of(i, v));
+        }
+        auto result = sharded.calculate_root(updates, sharded_root, v);
+        store->write_batch(result.node_batch);  // Caller persists, as with one KVStore
+        sharded_root = result.new_root_hash;
+        reference_root = reference.calculate_root(updates, reference_root, v).new_root_hash;
+        assert(sharded_root == reference_root);
+    }
+
+    auto stats = store->stats();
+    for (uint64_t n : stats.nodes_written) assert(n > 0);
+
+    // A fresh adapter has a cold cache: every node comes back from the stores
+    XookAdapter cold(store);
+    for (uint32_t i = 0; i < 300; ++i) {
+        auto expected = reference.get(key_of(i), 5);
+        assert(cold.get(key_of(i), 5) == expected);
+    }
+
+    bool rejected = false;
+    try { XookAdapter bad(std::shared_ptr<TreeReader>{}); } catch (const std::invalid_argument&) { rejected = true; }
+    assert(rejected);
+    std::cout << "  ✅ Same roots over 5 versions; cold reads served by the shards" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== SHARDED NODE STORE TESTS ===\n" << std::endl;
+
+    test_partitioner_ranges();
+    test_subtree_stays_on_one_store();
+    test_write_batch_and_read();
+    test_adapter_over_sharded_stores();
+
+    std::cout << "\n=== ALL SHARDED NODE STORE TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,173 @@
+// =========================================================
+// FILE: tests/xook/test_sharded_state.cpp
+// PURPOSE: Sharded state: routing, parallel commit, aggregated root, shard proofs
+// =========================================================
+
+#include "../../src/xook/sharded_state.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+
+using namespace glofica::xook;
+using glofica::Hash;
+using glofica::Bytes;
+
+static Bytes key_of(uint32_t i) {
+    return Bytes{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i >> 16), 0x5A};
+}
+
+static Hash value_of(uint32_t i, uint64_t version) {
+    Hash v;
+    v.fill(static_cast<uint8_t>(i * 31 + version));
+    return v;
+}
+
+void test_routing() {
+    std::cout << "[TEST] Routing by leading key-hash bits..." << std::endl;
+
+    ShardedXookState state(8);
+    std::vector<size_t> counts(8, 0);
+    for (uint32_t i = 0; i < 4000; ++i) {
+        Hash h = glofica::hash::blake3(key_of(i));
+        size_t s = state.shard_of(key_of(i));
+        assert(s == static_cast<size_t>(h[0] >> 5));
+        ++counts[s];
+    }
+    for (size_t c : counts) assert(c > 350 && c < 650);  // Uniform within noise
+
+    ShardedXookState single(1);
+    assert(single.shard_of(key_of(7)) == 0);
+
+    bool rejected = false;
+    try { ShardedXookState bad(6); } catch (const std::invalid_argument&) { rejected = true; }
+    assert(rejected);
+    std::cout << "  ✅ 8 shards, balanced; non-power-of-two rejected" << std::endl;
+}
+
+void test_parallel_commit_matches_independent_shards() {
+    std::cout << "[TEST] Parallel commit == independent per-shard commits..." << std::endl;
+
+    constexpr size_t K = 4;
+    ShardedXookState state(K);
+    state.enable_numa_binding();  // Workers bind to each shard's home node (no effect on roots)
+    std::vector<std::unique_ptr<XookAdapter>> reference;
+    for (size_t s = 0; s < K; ++s) reference.push_back(std::make_unique<XookAdapter>());
+    std::vector<Hash> ref_roots(K, Hash{});
+    std::vector<std::optional<uint64_t>> ref_versions(K);
+
+    for (uint64_t version = 1; version <= 5; ++version) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 50; ++i) updates.emplace_back(key_of(i * 5 + static_cast<uint32_t>(version)), value_of(i, version));
+        state.put(key_of(100000 + static_cast<uint32_t>(version)), value_of(1, version), version);
+        auto commit = state.calculate_root(updates, version);
+
+        // Same routing applied by hand
+        std::vector<std::vector<std::pair<Bytes, Hash>>> routed(K);
+        for (const auto& u : updates) routed[state.shard_of(u.first)].push_back(u);
+        size_t put_shard = state.shard_of(key_of(100000 + static_cast<uint32_t>(version)));
+        reference[put_shard]->put(key_of(100000 + static_cast<uint32_t>(version)), value_of(1, version), version);
+        for (size_t s = 0; s < K; ++s) {
+            if (routed[s].empty() && s != put_shard) continue;
+            ref_roots[s] = reference[s]->calculate_root(routed[s], ref_roots[s], version, ref_versions[s]).new_root_hash;
+            ref_versions[s] = version;
+        }
+        assert(commit.shard_roots == ref_roots);
+        assert(state.get_root_hash(version) == commit.root);
+    }
+
+    // Aggregation: domain || K || roots
+    Bytes buf(XOOK_SHARDED_ROOT_DOMAIN.begin(), XOOK_SHARDED_ROOT_DOMAIN.end());
+    buf.insert(buf.end(), {static_cast<uint8_t>(K), 0, 0, 0});
+    for (const auto& r : ref_roots) buf.insert(buf.end(), r.begin(), r.end());
+    assert(state.get_root_hash(5) == glofica::hash::blake3(buf));
+    assert(!state.get_root_hash(0));
+    std::cout << "  ✅ 5 versions, shard roots and top-level root match" << std::endl;
+}
+
+void test_untouched_shards_and_proofs() {
+    std::cout << "[TEST] Untouched shards keep roots; proofs carry the shard index..." << std::endl;
+
+    ShardedXookState state(16);
+    Bytes key = key_of(42);
+    auto first = state.calculate_root({{key, value_of(42, 1)}}, 1);
+    assert(first.committed_shards.size() == 1 && first.committed_shards[0] == state.shard_of(key));
+
+    // Only another shard changes at version 2
+    Bytes other;
+    for (uint32_t i = 0; ; ++i) {
+        if (state.shard_of(key_of(i)) != state.shard_of(key)) { other = key_of(i); break; }
+    }
+    auto second = state.calculate_root({{other, value_of(1, 2)}}, 2);
+    assert(second.shard_roots[state.shard_of(key)] == first.shard_roots[state.shard_of(key)]);
+    assert(second.root != first.root);
+
+    auto proof = state.shard_proof(key, 2);
+    assert(proof && proof->shard_index == state.shard_of(key) && proof->shard_count == 16);
+    auto shard_root = ShardedXookState::verify_shard_proof(*proof, second.root, key);
+    assert(shard_root && *shard_root == first.shard_roots[proof->shard_index]);
+
+    // Wrong top root, wrong key routing and tampered shard root all fail
+    assert(!ShardedXookState::verify_shard_proof(*proof, first.root, key));
+    assert(!ShardedXookState::verify_shard_proof(*proof, second.root, other));
+    auto tampered = *proof;
+    tampered.shard_roots[(proof->shard_index + 1) % 16][0] ^= 1;
+    assert(!ShardedXookState::verify_shard_proof(tampered, second.root, key));
+
+    // Facade version with no commit resolves to the latest one below it
+    assert(state.get_root_hash(7) == second.root);
+    std::cout << "  ✅ Shard binding verified, tampering rejected" << std::endl;
+}
+
+void test_partial_failure_is_fatal() {
+    std::cout << "[TEST] A failing shard leaves the facade at its last complete version..." << std::endl;
+
+    // Node reader that can be made to fail (e.g. a KVStore I/O error)
+    struct FlakyReader : TreeReader {
+        std::atomic<bool> fail{false};
+        std::optional<Bytes> get_node_bytes(const NodeKey&) override {
+            if (fail) throw std::runtime_error("node store unavailable");
+            return std::nullopt;
+        }
+    };
+    std::vector<std::shared_ptr<FlakyReader>> flaky;
+    std::vector<std::shared_ptr<TreeReader>> readers;
+    for (size_t s = 0; s < 4; ++s) {
+        flaky.push_back(std::make_shared<FlakyReader>());
+        readers.push_back(flaky.back());
+    }
+    ShardedXookState state(readers);
+
+    std::vector<std::pair<Bytes, Hash>> updates;
+    for (uint32_t i = 0; i < 64; ++i) updates.emplace_back(key_of(i), value_of(i, 1));
+    auto first = state.calculate_root(updates, 1);
+    assert(first.committed_shards.size() == 4);
+
+    flaky[2]->fail = true;
+    for (auto& [key, value] : updates) value = value_of(0, 2);
+    bool thrown = false;
+    try { state.calculate_root(updates, 2); } catch (const std::runtime_error&) { thrown = true; }
+    assert(thrown && state.failed());
+
+    // No history entry, no half-updated heads
+    assert(state.get_root_hash(2) == first.root);
+    auto proof = state.shard_proof(key_of(0), 2);
+    assert(proof && proof->version == 1 && proof->shard_roots == first.shard_roots);
+
+    bool refused = false;
+    try { state.calculate_root(updates, 3); } catch (const std::logic_error&) { refused = true; }
+    assert(refused);
+    refused = false;
+    try { state.put(key_of(1), value_of(1, 3), 3); } catch (const std::logic_error&) { refused = true; }
+    assert(refused);
+    std::cout << "  ✅ Failure surfaced, facade pinned at version 1, writes refused" << std::endl;
+}
+
+int main() {
+    test_routing();
+    test_parallel_commit_matches_independent_shards();
+    test_untouched_shards_and_proofs();
+    test_partial_failure_is_fatal();
+
+    std::cout << "\nALL SHARDED STATE TESTS PASSED" << std::endl;
+    return 0;
+}
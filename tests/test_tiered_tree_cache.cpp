@@ -0,0 +1,225 @@
+// =========================================================
+// FILE: tests/xook/test_tiered_tree_cache.cpp
+// PURPOSE: Two-tier cache: codec round trip, demotion/promotion, budgets, adapter
+// =========================================================
+
+#include "../../src/xook/tiered_tree_cache.hpp"
+#include "../../src/xook/xook_adapter.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+#include <thread>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+using glofica::Hash;
+using glofica::Bytes;
+
+static InternalNode make_internal(uint64_t version, uint8_t seed) {
+    InternalNode node;
+    for (uint8_t n = 0; n < 16; ++n) {
+        Hash h;
+        h.fill(static_cast<uint8_t>(seed + n));
+        node.set_child(n, h, version - (n % 4) * 100);
+    }
+    return node;
+}
+
+static bool same_node(const Node& a, const Node& b) {
+    return serialize_node_with_prefix(a) == serialize_node_with_prefix(b);
+}
+
+void test_codec_round_trip() {
+    std::cout << "[TEST] Cold codec round trip..." << std::endl;
+
+    Node internal = make_internal(1000, 7);
+    std::string compact, plain;
+    ColdNodeCodec::encode(ColdCodec::Compact, 1000, internal, compact);
+    ColdNodeCodec::encode(ColdCodec::Serialized, 1000, internal, plain);
+    assert(plain.size() == 3 + 16 * 72);
+    assert(compact.size() < plain.size() - 16 * 6);  // 8-byte versions → 1-2 byte deltas
+    assert(same_node(*ColdNodeCodec::decode(1000, compact), internal));
+    assert(same_node(*ColdNodeCodec::decode(1000, plain), internal));
+
+    // Child newer than the key version: falls back to the plain encoding
+    std::string fallback;
+    ColdNodeCodec::encode(ColdCodec::Compact, 50, internal, fallback);
+    assert(fallback.size() == plain.size());
+    assert(same_node(*ColdNodeCodec::decode(50, fallback), internal));
+
+    LeafNode leaf;
+    leaf.account_key.fill(1);
+    leaf.value_hash.fill(2);
+    std::string leaf_bytes;
+    ColdNodeCodec::encode(ColdCodec::Compact, 3, leaf, leaf_bytes);
+    assert(same_node(*ColdNodeCodec::decode(3, leaf_bytes), leaf));
+
+    // Truncated input is rejected
+    assert(!ColdNodeCodec::decode(1000, std::string_view(compact).substr(0, compact.size() - 1)));
+    std::cout << "  ✅ 16-child node: " << plain.size() << " → " << compact.size() << " bytes" << std::endl;
+}
+
+void test_demote_and_promote() {
+    std::cout << "[TEST] Hot evictions demote, cold hits promote..." << std::endl;
+
+    TieredTreeCache cache(32, size_t{8} << 20);
+    for (uint64_t i = 0; i < 200; ++i) cache.put(make_key(500, i, 4), make_internal(500, static_cast<uint8_t>(i)));
+
+    assert(cache.hot().size() == 32);
+    assert(cache.cold().size() == 168);
+    assert(cache.size() == 200);
+
+    // Every node is still served: cold ones are decoded and promoted
+    for (uint64_t i = 0; i < 200; ++i) {
+        auto node = cache.get_shared(make_key(500, i, 4));
+        assert(node && same_node(*node, make_internal(500, static_cast<uint8_t>(i))));
+    }
+    assert(cache.promotions() >= 168);
+    assert(cache.size() == 200);  // Tiers stay exclusive
+
+    // A replaced node never comes back stale from the cold tier
+    cache.put(make_key(500, 0, 4), make_internal(500, 0xEE));
+    for (uint64_t i = 1; i < 100; ++i) cache.get_shared(make_key(500, i, 4));  // Push key 0 cold
+    assert(same_node(*cache.get_shared(make_key(500, 0, 4)), make_internal(500, 0xEE)));
+
+    auto stats = cache.cold().stats();
+    assert(stats.demotions > 0 && stats.hits >= 168);
+    assert(stats.bytes < stats.decoded_equivalent);
+    std::cout << "  ✅ " << stats.entries << " cold entries: " << stats.bytes << " bytes vs "
+              << stats.decoded_equivalent << " decoded" << std::endl;
+}
+
+void test_budgets() {
+    std::cout << "[TEST] Cold budget and governor shrink..." << std::endl;
+
+    TieredTreeCache cache(16, 64 * 1024);
+    for (uint64_t i = 0; i < 500; ++i) cache.put(make_key(900, i, 5), make_internal(900, static_cast<uint8_t>(i)));
+    assert(cache.cold().bytes() <= 64 * 1024);
+    assert(cache.cold().stats().evictions > 0);
+
+    // Same budget holds more nodes cold than hot
+    size_t hot_per_node = cache.hot().approx_bytes() / cache.hot().size();
+    size_t cold_per_node = cache.cold().bytes() / cache.cold().size();
+    assert(cold_per_node < hot_per_node);
+
+    size_t target = cache.approx_bytes() / 2;
+    cache.shrink_to_bytes(target);
+    assert(cache.approx_bytes() <= target);
+
+    cache.clear();
+    assert(cache.size() == 0 && cache.approx_bytes() == 0);
+    std::cout << "  ✅ " << cold_per_node << " B/node cold vs " << hot_per_node << " B/node hot" << std::endl;
+}
+
+void test_concurrent_access() {
+    std::cout << "[TEST] Concurrent readers across both tiers..." << std::endl;
+
+    TieredTreeCache cache(64, size_t{16} << 20);
+    cache.enable_thread_local_l1();
+    for (uint64_t i = 0; i < 1000; ++i) cache.put(make_key(77, i, 4), make_internal(77, static_cast<uint8_t>(i)));
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&cache, t] {
+            for (uint64_t round = 0; round < 3; ++round) {
+                for (uint64_t i = t; i < 1000; i += 3) {
+                    // Concurrent promotion of the same key may miss (caller falls back to the store)
+                    auto node = cache.get_shared(make_key(77, i, 4));
+                    if (node) assert(same_node(*node, make_internal(77, static_cast<uint8_t>(i))));
+                }
+            }
+        });
+    }
+    for (auto& th : readers) th.join();
+    assert(cache.size() <= 1000);
+    std::cout << "  ✅ 4 readers, " << cache.promotions() << " promotions" << std::endl;
+}
+
+void test_adapter_cold_tier() {
+    std::cout << "[TEST] XookAdapter with a cold tier: same roots, same reads..." << std::endl;
+
+    XookAdapter tiered;
+    tiered.enable_cold_tier(size_t{4} << 20);
+    XookAdapter plain;
+
+    Hash tiered_root{}, plain_root{};
+    for (uint64_t v = 1; v <= 4; ++v) {
+        std::vector<std::pair<Bytes, Hash>> updates;
+        for (uint32_t i = 0; i < 400; ++i) {
+            Hash value;
+            value.fill(static_cast<uint8_t>(i + v));
+            updates.emplace_back(Bytes{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x11}, value);
+        }
+        tiered_root = tiered.calculate_root(updates, tiered_root, v).new_root_hash;
+        plain_root = plain.calculate_root(updates, plain_root, v).new_root_hash;
+        assert(tiered_root == plain_root);
+    }
+    for (uint32_t i = 0; i < 400; i += 7) {
+        Bytes key{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x11};
+        assert(tiered.get(key, 4) == plain.get(key, 4));
+    }
+    std::cout << "  ✅ Roots and reads match over 4 versions" << std::endl;
+}
+
+void test_forwarded_queries() {
+    std::cout << "[TEST] Policy, supersede, listener and index queries reach the hot tier..." << std::endl;
+
+    TieredTreeCache cache(4, size_t{1} << 20);
+    cache.set_eviction_policy(EvictionPolicy::GreedyDual);
+    cache.set_supersede_policy(SupersedePolicy::Demote);
+    cache.enable_committed_index();
+    assert(cache.committed_index_enabled() && !cache.thread_local_l1_enabled());
+    assert(cache.eviction_policy() == EvictionPolicy::GreedyDual);
+    assert(cache.supersede_policy() == SupersedePolicy::Demote);
+
+    std::vector<NodeKey> evicted;
+    cache.set_eviction_listener([&evicted](const NodeKey& key, const NodeHandle&, bool) { evicted.push_back(key); });
+    cache.put(make_key(1, 7, 2), make_internal(1, 7));
+    cache.publish_committed(1);
+    assert(cache.visit_committed(make_key(1, 7, 2), [](const Node&) {}));
+    cache.put(make_key(2, 7, 2), make_internal(2, 7));
+    cache.publish_committed(2);
+    assert(cache.superseded_count() == 1 && cache.supersede_backlog() == 0);
+
+    for (uint64_t i = 0; i < 10; ++i) cache.put(make_key(3, i, 3), make_internal(3, static_cast<uint8_t>(i)));
+    assert(!evicted.empty() && cache.cold().size() > 0);  // Demoted, and the caller was told
+    std::cout << "  ✅ " << evicted.size() << " hot evictions reported after demotion" << std::endl;
+}
+
+void test_superseded_skip_cold_tier() {
+    std::cout << "[TEST] Superseded versions are not demoted into the cold tier..." << std::endl;
+
+    TieredTreeCache cache(4, size_t{1} << 20);
+    cache.set_supersede_policy(SupersedePolicy::Demote);
+    size_t superseded_evictions = 0;
+    cache.set_eviction_listener([&](const NodeKey&, const NodeHandle&, bool superseded) {
+        superseded_evictions += superseded;
+    });
+    for (uint64_t i : {1, 2, 3, 0}) cache.put(make_key(1, i, 2), make_internal(1, static_cast<uint8_t>(i)));
+    cache.publish_committed(1);
+    cache.put(make_key(2, 0, 2), make_internal(2, 0xA0));  // Supersedes path 0 at v1 (v1 path 1 goes cold)
+    cache.publish_committed(2);
+
+    for (uint64_t i = 4; i < 8; ++i) cache.put(make_key(3, i, 2), make_internal(3, static_cast<uint8_t>(i)));
+    assert(superseded_evictions == 1);
+    assert(cache.cold().size() == 4);  // v1 paths 1..3 and v2 path 0, not v1 path 0
+    assert(!cache.get_shared(make_key(1, 0, 2)));
+    for (uint64_t i = 1; i < 4; ++i) assert(cache.get_shared(make_key(1, i, 2)));
+    assert(cache.get_shared(make_key(2, 0, 2)));
+    std::cout << "  ✅ Dead version dropped at eviction, live ones demoted" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== TIERED TREE CACHE TESTS ===\n" << std::endl;
+
+    test_codec_round_trip();
+    test_demote_and_promote();
+    test_budgets();
+    test_concurrent_access();
+    test_adapter_cold_tier();
+    test_forwarded_queries();
+    test_superseded_skip_cold_tier();
+
+    std::cout << "\n=== ALL TIERED TREE CACHE TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+// =========================================================
+// FILE: tests/xook/test_tree_verifier.cpp
+// PURPOSE: Parallel integrity verifier detects missing/corrupt/mismatched nodes
+// =========================================================
+
+#include "../../src/xook/tree_verifier.hpp"
+#include "node_fixtures.hpp"
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+using namespace glofica::xook;
+using namespace glofica::xook::test;
+using glofica::Hash;
+using glofica::Bytes;
+
+// Map-backed reader (persisted node store stand-in)
+class MapReader : public TreeReader {
+public:
+    std::map<Bytes, Bytes> nodes;
+    std::mutex mutex;
+
+    std::optional<Bytes> get_node_bytes(const NodeKey& key) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = nodes.find(key.serialize());
+        if (it == nodes.end()) return std::nullopt;
+        return it->second;
+    }
+
+    Hash store(const NodeKey& key, const Node& node) {
+        nodes[key.serialize()] = serialize_node_with_prefix(node);
+        return hash_node(node);
+    }
+};
+
+// Root (v2) -> [0]: leaf (v1), [3]: internal (v2) -> [3,1]: leaf, [3,9]: leaf
+//           -> [15]: leaf (v2)
+static Hash build_tree(MapReader& reader) {
+    InternalNode sub;
+    sub.set_child(1, reader.store(key_at(2, {3, 1}), make_leaf(0x31)), 2);
+    sub.set_child(9, reader.store(key_at(2, {3, 9}), make_leaf(0x39)), 2);
+
+    InternalNode root;
+    root.set_child(0, reader.store(key_at(1, {0}), make_leaf(0x00)), 1);
+    root.set_child(3, reader.store(key_at(2, {3}), sub), 2);
+    root.set_child(15, reader.store(key_at(2, {15}), make_leaf(0xF0)), 2);
+    return reader.store(key_at(2, {}), root);
+}
+
+void test_healthy_tree() {
+    std::cout << "[TEST] Healthy tree verifies..." << std::endl;
+
+    MapReader reader;
+    Hash root = build_tree(reader);
+
+    TreeVerifier verifier(&reader, {4, false});
+    auto report = verifier.verify(2, root);
+    assert(report.ok());
+    assert(report.nodes_verified == 6);
+    assert(report.internal_nodes == 2);
+    assert(report.leaf_nodes == 4);
+    assert(report.bytes_read > 0);
+    std::cout << "  ✅ 6 nodes verified (" << static_cast<uint64_t>(report.nodes_per_sec()) << " nodes/s)" << std::endl;
+}
+
+void test_wrong_root() {
+    std::cout << "[TEST] Wrong expected root..." << std::endl;
+
+    MapReader reader;
+    build_tree(reader);
+    Hash bogus{};
+    bogus.fill(0x42);
+
+    auto report = TreeVerifier(&reader).verify(2, bogus);
+    assert(!report.ok());
+    assert(report.first_error->kind == VerifyErrorKind::HashMismatch);
+    assert(report.first_error->key == key_at(2, {}));
+    std::cout << "  ✅ Root mismatch reported at root key" << std::endl;
+}
+
+void test_corrupted_leaf() {
+    std::cout << "[TEST] Corrupted leaf deep in tree..." << std::endl;
+
+    MapReader reader;
+    Hash root = build_tree(reader);
+
+    // Flip one byte of the value hash of [3,9] (still deserializes)
+    auto& bytes = reader.nodes[key_at(2, {3, 9}).serialize()];
+    bytes[100] ^= 0xFF;
+
+    auto report = TreeVerifier(&reader, {2, false}).verify(2, root);
+    assert(report.error_count == 1);
+    assert(report.first_error->kind == VerifyErrorKind::HashMismatch);
+    assert(report.first_error->key == key_at(2, {3, 9}));
+    std::cout << "  ✅ Mismatch at NodeKey v2 path " << report.first_error->key.nibble_path.to_hex() << std::endl;
+}
+
+void test_missing_and_truncated() {
+    std::cout << "[TEST] Missing and truncated nodes..." << std::endl;
+
+    MapReader reader;
+    Hash root = build_tree(reader);
+    reader.nodes.erase(key_at(1, {0}).serialize());
+    reader.nodes[key_at(2, {15}).serialize()].pop_back();
+
+    auto report = TreeVerifier(&reader).verify(2, root);
+    assert(report.error_count == 2);
+    // Canonical order: nibble 0 comes before nibble 15
+    assert(report.first_error->kind == VerifyErrorKind::Missing);
+    assert(report.first_error->key == key_at(1, {0}));
+    std::cout << "  ✅ Missing + corrupt nodes reported in nibble order" << std::endl;
+}
+
+// Reader whose backing store fails below the root (e.g. an I/O error): every subtree task throws
+class FailingReader : public MapReader {
+public:
+    std::optional<Bytes> get_node_bytes(const NodeKey& key) override {
+        if (key.nibble_path.size() > 0) throw std::runtime_error("read failed");
+        return MapReader::get_node_bytes(key);
+    }
+};
+
+void test_reader_exception_propagates() {
+    std::cout << "[TEST] Reader exception on a pool thread reaches the caller..." << std::endl;
+
+    FailingReader reader;
+    Hash root = build_tree(reader);
+
+    bool thrown = false;
+    try {
+        TreeVerifier(&reader, {4, false}).verify(2, root);
+    } catch (const std::runtime_error& e) {
+        thrown = std::string(e.what()) == "read failed";
+    }
+    assert(thrown);
+    std::cout << "  ✅ Rethrown from verify(), no std::terminate" << std::endl;
+}
+
+int main() {
+    test_healthy_tree();
+    test_wrong_root();
+    test_corrupted_leaf();
+    test_missing_and_truncated();
+    test_reader_exception_propagates();
+
+    std::cout << "\nALL TREE VERIFIER TESTS PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,440 @@
+// =========================================================
+// FILE: src/xook/tiered_tree_cache.hpp
+// PURPOSE: Two-tier node cache: decoded hot LRU + compact serialized cold tier
+// CRITICAL: A decoded 16-child InternalNode costs ~1.4KB resident; its cold
+//           form is ~1.05KB plus ~100B bookkeeping, and leaves shrink the
+//           same way, so one EPC budget holds more of the tree
+// =========================================================
+
+#pragma once
+
+#include "tree_cache.hpp"
+#include "node_serde.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace glofica::xook {
+
+/// @brief Cold-tier encoding
+enum class ColdCodec : uint8_t {
+    Serialized,   // serialize_node_with_prefix() bytes as-is
+    Compact       // Internal nodes: child versions as varint deltas from the node's version
+};
+
+/// @brief Node ↔ cold bytes
+///
+/// Hashes are incompressible, so general-purpose compression buys nothing on
+/// tree nodes. What does compress is the 8-byte child version: a child is
+/// never newer than its parent, and most were written a few versions earlier,
+/// so (parent version - child version) as a LEB128 varint is 1-2 bytes.
+/// Leaves are stored serialized. Internal nodes with a child newer than the
+/// key's version (never produced by the tree) fall back to Serialized.
+struct ColdNodeCodec {
+    static constexpr uint8_t COMPACT_INTERNAL_PREFIX = 0x81;  // Not a valid node type byte
+
+    static void encode(ColdCodec codec, uint64_t version, const Node& node, std::string& out) {
+        const auto* internal = std::get_if<InternalNode>(&node);
+        bool compact = codec == ColdCodec::Compact && internal;
+        if (compact) {
+            for (const auto& child : internal->children) compact = compact && child.version <= version;
+        }
+        if (!compact) {
+            glofica::Bytes bytes = serialize_node_with_prefix(node);
+            out.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            return;
+        }
+
+        uint16_t mask = internal->bitmap.raw_mask();
+        out.push_back(static_cast<char>(COMPACT_INTERNAL_PREFIX));
+        out.push_back(static_cast<char>(mask & 0xFF));
+        out.push_back(static_cast<char>(mask >> 8));
+        for (const auto& child : internal->children) {
+            out.append(reinterpret_cast<const char*>(child.hash.data()), child.hash.size());
+            uint64_t delta = version - child.version;
+            do {
+                uint8_t b = delta & 0x7F;
+                delta >>= 7;
+                out.push_back(static_cast<char>(delta ? (b | 0x80) : b));
+            } while (delta);
+        }
+    }
+
+    [[nodiscard]] static std::optional<Node> decode(uint64_t version, std::string_view in) {
+        if (in.empty()) return std::nullopt;
+        if (static_cast<uint8_t>(in[0]) != COMPACT_INTERNAL_PREFIX) {
+            return deserialize_node_from_bytes(glofica::Bytes(in.begin(), in.end()));
+        }
+        if (in.size() < 3) return std::nullopt;
+
+        const auto* p = reinterpret_cast<const uint8_t*>(in.data());
+        const uint8_t* end = p + in.size();
+        InternalNode internal;
+        internal.bitmap = SparseBitmap(static_cast<uint16_t>(p[1] | (p[2] << 8)));
+        p += 3;
+        size_t count = internal.bitmap.total_children();
+        internal.children.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            ChildInfo child;
+            if (end - p < static_cast<ptrdiff_t>(child.hash.size())) return std::nullopt;
+            std::copy(p, p + child.hash.size(), child.hash.begin());
+            p += child.hash.size();
+
+            uint64_t delta = 0;
+            for (int shift = 0;; shift += 7) {
+                if (p == end || shift > 63) return std::nullopt;
+                uint8_t b = *p++;
+                delta |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) break;
+            }
+            if (delta > version) return std::nullopt;
+            child.version = version - delta;
+            internal.children.push_back(child);
+        }
+        if (p != end) return std::nullopt;
+        return Node(std::move(internal));
+    }
+};
+
+/// @brief Byte-budgeted LRU of encoded nodes (the cold tier)
+///
+/// One allocation per entry: key and encoded node share a string; the index
+/// holds a view of the key part. Entries are exclusive with the hot tier:
+/// take() removes the entry it returns.
+class ColdNodeTier {
+public:
+    struct Stats {
+        size_t entries = 0;
+        size_t bytes = 0;              // Resident, including per-entry overhead
+        size_t decoded_equivalent = 0; // estimate_node_bytes() of the same nodes
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t demotions = 0;
+        uint64_t evictions = 0;        // Dropped for the byte budget
+    };
+
+private:
+    // List node + map node + string header
+    static constexpr size_t ENTRY_OVERHEAD = 96;
+
+    struct Entry {
+        std::string data;        // Key bytes, then encoded node
+        uint32_t key_size;
+        uint32_t decoded_bytes;  // For Stats::decoded_equivalent
+    };
+
+    ColdCodec codec_;
+    std::atomic<size_t> budget_;
+    std::list<Entry> lru_;  // MRU at front
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    std::atomic<size_t> bytes_{0};
+    std::atomic<size_t> entries_{0};
+    size_t decoded_bytes_ = 0;
+    Stats counters_;
+    mutable std::mutex mutex_;
+
+    static void append_key(std::string& out, const NodeKey& key) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(key.version >> (8 * i)));
+        size_t nibbles = key.nibble_path.size();
+        out.push_back(static_cast<char>(nibbles & 0xFF));
+        out.push_back(static_cast<char>(nibbles >> 8));
+        const auto& path = key.nibble_path.bytes();
+        out.append(reinterpret_cast<const char*>(path.data()), path.size());
+    }
+
+    [[nodiscard]] static size_t entry_bytes(const Entry& e) noexcept {
+        return ENTRY_OVERHEAD + e.data.capacity();
+    }
+
+    void erase_locked(std::list<Entry>::iterator it) {
+        index_.erase(std::string_view(it->data.data(), it->key_size));
+        bytes_.fetch_sub(entry_bytes(*it), std::memory_order_relaxed);
+        decoded_bytes_ -= it->decoded_bytes;
+        lru_.erase(it);
+        entries_.store(index_.size(), std::memory_order_relaxed);
+    }
+
+    void trim_locked(size_t target_bytes) {
+        while (!lru_.empty() && bytes_.load(std::memory_order_relaxed) > target_bytes) {
+            erase_locked(std::prev(lru_.end()));
+            ++counters_.evictions;
+        }
+    }
+
+public:
+    explicit ColdNodeTier(size_t budget_bytes, ColdCodec codec = ColdCodec::Compact)
+        : codec_(codec), budget_(budget_bytes) {}
+
+    /// @brief Store a node demoted from the hot tier (drops cold LRU entries over budget)
+    void insert(const NodeKey& key, const Node& node) {
+        if (budget_.load(std::memory_order_relaxed) == 0) return;
+        Entry entry;
+        append_key(entry.data, key);
+        entry.key_size = static_cast<uint32_t>(entry.data.size());
+        ColdNodeCodec::encode(codec_, key.version, node, entry.data);
+        entry.data.shrink_to_fit();
+        entry.decoded_bytes = static_cast<uint32_t>(estimate_node_bytes(key, node));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto existing = index_.find(std::string_view(entry.data.data(), entry.key_size));
+        if (existing != index_.end()) erase_locked(existing->second);
+
+        lru_.push_front(std::move(entry));
+        auto it = lru_.begin();
+        index_.emplace(std::string_view(it->data.data(), it->key_size), it);
+        bytes_.fetch_add(entry_bytes(*it), std::memory_order_relaxed);
+        decoded_bytes_ += it->decoded_bytes;
+        entries_.store(index_.size(), std::memory_order_relaxed);
+        ++counters_.demotions;
+        trim_locked(budget_.load(std::memory_order_relaxed));
+    }
+
+    /// @brief Remove and decode `key` (promotion to the hot tier)
+    [[nodiscard]] std::optional<Node> take(const NodeKey& key) {
+        if (entries_.load(std::memory_order_relaxed) == 0) return std::nullopt;
+        thread_local std::string probe;
+        probe.clear();
+        append_key(probe, key);
+
+        Entry entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(probe);
+            if (it == index_.end()) {
+                ++counters_.misses;
+                return std::nullopt;
+            }
+            ++counters_.hits;
+            auto list_it = it->second;
+            index_.erase(it);
+            bytes_.fetch_sub(entry_bytes(*list_it), std::memory_order_relaxed);
+            decoded_bytes_ -= list_it->decoded_bytes;
+            entry = std::move(*list_it);
+            lru_.erase(list_it);
+            entries_.store(index_.size(), std::memory_order_relaxed);
+        }
+        // Decode outside the lock
+        return ColdNodeCodec::decode(key.version, std::string_view(entry.data).substr(entry.key_size));
+    }
+
+    /// @brief Drop `key` if present (its node was replaced in the hot tier)
+    void erase(const NodeKey& key) {
+        if (entries_.load(std::memory_order_relaxed) == 0) return;
+        thread_local std::string probe;
+        probe.clear();
+        append_key(probe, key);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(probe);
+        if (it != index_.end()) erase_locked(it->second);
+    }
+
+    /// @brief Evict cold LRU entries until bytes() <= target_bytes
+    size_t shrink_to_bytes(size_t target_bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t before = bytes_.load(std::memory_order_relaxed);
+        trim_locked(target_bytes);
+        return before - bytes_.load(std::memory_order_relaxed);
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.clear();
+        lru_.clear();
+        bytes_.store(0, std::memory_order_relaxed);
+        entries_.store(0, std::memory_order_relaxed);
+        decoded_bytes_ = 0;
+    }
+
+    void set_budget(size_t budget_bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_.store(budget_bytes, std::memory_order_relaxed);
+        trim_locked(budget_bytes);
+    }
+
+    [[nodiscard]] size_t bytes() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+    [[nodiscard]] size_t size() const noexcept { return entries_.load(std::memory_order_relaxed); }
+    [[nodiscard]] size_t budget() const noexcept { return budget_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats s = counters_;
+        s.entries = index_.size();
+        s.bytes = bytes_.load(std::memory_order_relaxed);
+        s.decoded_equivalent = decoded_bytes_;
+        return s;
+    }
+};
+
+/// @brief TreeCache with a cold tier below the decoded LRU
+///
+/// The hot tier is a plain TreeCache (L1, committed index and handles all
+/// unchanged). Its LRU evictions are demoted into a ColdNodeTier; a hot miss
+/// that hits the cold tier decodes the node and promotes it back (which may
+/// demote another). Cold overflow is dropped: the node is re-read from the
+/// KVStore as before.
+///
+/// Memory governance: approx_bytes() covers both tiers. shrink_to_bytes()
+/// first demotes from the hot tier, then trims the cold tier, so under
+/// pressure more of the working set survives in compact form.
+class TieredTreeCache : public TreeCache {
+private:
+    std::unique_ptr<TreeCache> hot_;
+    ColdNodeTier cold_;
+    std::atomic<uint64_t> promotions_{0};
+    EvictionListener listener_;  // Caller's: hot-tier evictions after demotion
+
+public:
+    /// @param hot_capacity Decoded entries (as TreeCache capacity)
+    /// @param cold_budget_bytes Cold tier byte budget
+    /// @param resource Optional allocator for the hot tier (e.g. HugePageSlabResource)
+    TieredTreeCache(size_t hot_capacity, size_t cold_budget_bytes, ColdCodec codec = ColdCodec::Compact,
+                    std::shared_ptr<std::pmr::memory_resource> resource = nullptr)
+        : TreeCache(hot_capacity),  // Base storage unused; capacity() reports the hot tier
+          hot_(std::make_unique<TreeCache>(hot_capacity, std::move(resource))),
+          cold_(cold_budget_bytes, codec) {
+        hot_->set_eviction_listener([this](const NodeKey& key, const NodeHandle& node, bool superseded) {
+            if (!superseded) cold_.insert(key, *node);  // A newer version is live: not worth a cold slot
+            if (listener_) listener_(key, node, superseded);
+        });
+    }
+
+    std::optional<Node> get(const NodeKey& key) override {
+        auto handle = get_shared(key);
+        if (!handle) return std::nullopt;
+        return *handle;
+    }
+
+    NodeHandle get_shared(const NodeKey& key) override {
+        if (auto handle = hot_->get_shared(key)) return handle;
+
+        auto node = cold_.take(key);
+        if (!node) return nullptr;
+        promotions_.fetch_add(1, std::memory_order_relaxed);
+        hot_->put(key, *node);
+        if (auto handle = hot_->get_shared(key)) return handle;
+        return std::make_shared<const Node>(std::move(*node));  // Hot capacity 0
+    }
+
+    void put(const NodeKey& key, const Node& node) override {
+        cold_.erase(key);  // Never promote a stale copy later
+        hot_->put(key, node);
+    }
+
+    void put_many(const std::vector<std::pair<NodeKey, Node>>& nodes) override {
+        for (const auto& [key, node] : nodes) cold_.erase(key);
+        hot_->put_many(nodes);
+    }
+
+    void clear() override {
+        hot_->clear();
+        cold_.clear();
+    }
+
+    [[nodiscard]] size_t size() const override {
+        return hot_->size() + cold_.size();
+    }
+
+    [[nodiscard]] size_t approx_bytes() const noexcept override {
+        return hot_->approx_bytes() + cold_.bytes();
+    }
+
+    size_t shrink_to_bytes(size_t target_bytes) override {
+        size_t before = approx_bytes();
+        size_t cold_bytes = cold_.bytes();
+        hot_->shrink_to_bytes(target_bytes > cold_bytes ? target_bytes - cold_bytes : 0);  // Demotes
+        size_t hot_bytes = hot_->approx_bytes();
+        cold_.shrink_to_bytes(target_bytes > hot_bytes ? target_bytes - hot_bytes : 0);
+        size_t after = approx_bytes();
+        return before > after ? before - after : 0;
+    }
+
+    void set_eviction_policy(EvictionPolicy policy, GreedyDualCost cost = {}) override {
+        hot_->set_eviction_policy(policy, cost);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept override {
+        return hot_->capacity();
+    }
+
+    /// @brief Resizes the hot tier (the cold tier keeps its byte budget)
+    void set_capacity(size_t capacity) override {
+        hot_->set_capacity(capacity);
+    }
+
+    void set_ghost_capacity(size_t entries) override {
+        hot_->set_ghost_capacity(entries);
+    }
+
+    /// @brief Hot-tier feedback; misses exclude cold hits, but ghost hits
+    /// still include keys the cold tier served (growth value is overstated)
+    [[nodiscard]] CacheFeedback feedback() const override {
+        CacheFeedback f = hot_->feedback();
+        uint64_t promoted = promotions_.load(std::memory_order_relaxed);
+        f.misses = f.misses > promoted ? f.misses - promoted : 0;
+        return f;
+    }
+
+    /// @brief Applies to the hot tier; superseded nodes are evicted past the cold tier
+    void set_supersede_policy(SupersedePolicy policy) override {
+        hot_->set_supersede_policy(policy);
+    }
+
+    [[nodiscard]] EvictionPolicy eviction_policy() const override {
+        return hot_->eviction_policy();
+    }
+
+    [[nodiscard]] SupersedePolicy supersede_policy() const override {
+        return hot_->supersede_policy();
+    }
+
+    [[nodiscard]] uint64_t superseded_count() const override {
+        return hot_->superseded_count();
+    }
+
+    [[nodiscard]] size_t supersede_backlog() const override {
+        return hot_->supersede_backlog();
+    }
+
+    /// @brief Told of each hot-tier eviction, after it was demoted into the cold tier (unless superseded)
+    /// CRITICAL: Call before concurrent use.
+    void set_eviction_listener(EvictionListener listener) override {
+        listener_ = std::move(listener);
+    }
+
+    bool visit_committed_node(const NodeKey& key, CommittedVisitor visit) const override {
+        return hot_->visit_committed_node(key, visit);
+    }
+
+    void enable_thread_local_l1(bool enabled = true) noexcept override {
+        hot_->enable_thread_local_l1(enabled);
+    }
+
+    [[nodiscard]] bool thread_local_l1_enabled() const noexcept override {
+        return hot_->thread_local_l1_enabled();
+    }
+
+    void enable_committed_index() override {
+        hot_->enable_committed_index();
+    }
+
+    [[nodiscard]] bool committed_index_enabled() const noexcept override {
+        return hot_->committed_index_enabled();
+    }
+
+    size_t publish_committed(uint64_t committed_version) override {
+        return hot_->publish_committed(committed_version);
+    }
+
+    [[nodiscard]] TreeCache& hot() noexcept { return *hot_; }
+    [[nodiscard]] ColdNodeTier& cold() noexcept { return cold_; }
+    [[nodiscard]] uint64_t promotions() const noexcept { return promotions_.load(std::memory_order_relaxed); }
+};
+
+} // namespace glofica::xook
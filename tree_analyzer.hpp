@@ -0,0 +1,212 @@
+// =========================================================
+// FILE: src/xook/tree_analyzer.hpp
+// PURPOSE: Tree shape statistics (depth, fanout, version spread, bytes/level)
+// USE: Input for cache pinning, top-level prefetch and compression decisions
+// =========================================================
+
+#pragma once
+
+#include "xook_merkle_tree.hpp"
+#include "node_serde.hpp"
+#include "tree_cache.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Distributions collected over all nodes reachable from one version
+struct TreeShapeReport {
+    static constexpr size_t MAX_LEVELS = 129;  // depth 0..128 (64-byte keys)
+
+    uint64_t version = 0;
+    uint64_t live_internal_nodes = 0;
+    uint64_t live_leaf_nodes = 0;
+    uint64_t missing_nodes = 0;  // Referenced but unreadable (see TreeVerifier)
+    std::chrono::nanoseconds elapsed{0};
+
+    // Leaf count by depth (nibbles from root)
+    std::array<uint64_t, MAX_LEVELS> leaf_depth{};
+
+    // SparseBitmap popcount (0..16) by level, internal nodes only
+    std::array<std::array<uint64_t, 17>, MAX_LEVELS> popcount_by_level{};
+
+    // max(child.version) - min(child.version) per internal node, log2 buckets:
+    // bucket 0 = spread 0, bucket k = spread in [2^(k-1), 2^k)
+    std::array<uint64_t, 65> version_spread{};
+
+    // Bytes by level: serialized (KVStore) and estimated resident (TreeCache)
+    std::array<uint64_t, MAX_LEVELS> serialized_bytes_by_level{};
+    std::array<uint64_t, MAX_LEVELS> cache_bytes_by_level{};
+    std::array<uint64_t, MAX_LEVELS> nodes_by_level{};
+
+    // Total node count in the store (optional, from KVStore stats) for stale ratio
+    std::optional<uint64_t> persisted_nodes;
+
+    [[nodiscard]] uint64_t live_nodes() const noexcept {
+        return live_internal_nodes + live_leaf_nodes;
+    }
+
+    /// @brief Stale (superseded, prunable) nodes per live node; nullopt if store size unknown
+    [[nodiscard]] std::optional<double> stale_to_live_ratio() const noexcept {
+        if (!persisted_nodes || live_nodes() == 0) return std::nullopt;
+        uint64_t stale = *persisted_nodes > live_nodes() ? *persisted_nodes - live_nodes() : 0;
+        return static_cast<double>(stale) / static_cast<double>(live_nodes());
+    }
+
+    /// @brief Deepest level that holds any node
+    [[nodiscard]] size_t max_depth() const noexcept {
+        for (size_t d = MAX_LEVELS; d-- > 0;) {
+            if (nodes_by_level[d] != 0) return d;
+        }
+        return 0;
+    }
+
+    /// @brief Mean leaf depth (expected nodes per lookup - 1)
+    [[nodiscard]] double mean_leaf_depth() const noexcept {
+        uint64_t total = 0, weighted = 0;
+        for (size_t d = 0; d < MAX_LEVELS; ++d) {
+            total += leaf_depth[d];
+            weighted += leaf_depth[d] * d;
+        }
+        return total == 0 ? 0.0 : static_cast<double>(weighted) / static_cast<double>(total);
+    }
+
+    /// @brief Resident bytes needed to pin levels [0, depth] in TreeCache
+    [[nodiscard]] uint64_t cache_bytes_through_level(size_t depth) const noexcept {
+        uint64_t sum = 0;
+        for (size_t d = 0; d <= depth && d < MAX_LEVELS; ++d) sum += cache_bytes_by_level[d];
+        return sum;
+    }
+
+    /// @brief Human-readable per-level table
+    [[nodiscard]] std::string to_string() const {
+        std::ostringstream out;
+        out << "XOOK tree shape @ version " << version << "\n";
+        out << "  live nodes: " << live_nodes() << " (" << live_internal_nodes << " internal, "
+            << live_leaf_nodes << " leaf), missing: " << missing_nodes << "\n";
+        out << "  mean leaf depth: " << mean_leaf_depth() << "\n";
+        if (auto ratio = stale_to_live_ratio()) out << "  stale/live: " << *ratio << "\n";
+        out << "  level\tnodes\tleaves\tavg_fanout\tserialized_B\tcache_B\n";
+        for (size_t d = 0; d <= max_depth(); ++d) {
+            uint64_t internal = 0, children = 0;
+            for (size_t p = 0; p <= 16; ++p) {
+                internal += popcount_by_level[d][p];
+                children += popcount_by_level[d][p] * p;
+            }
+            double fanout = internal == 0 ? 0.0 : static_cast<double>(children) / static_cast<double>(internal);
+            out << "  " << d << "\t" << nodes_by_level[d] << "\t" << leaf_depth[d] << "\t" << fanout
+                << "\t" << serialized_bytes_by_level[d] << "\t" << cache_bytes_by_level[d] << "\n";
+        }
+        return out.str();
+    }
+};
+
+/// @brief Streams over every node of one version on a dedicated walk thread
+///
+/// Memory footprint is bounded: fixed-size histograms plus an explicit DFS
+/// stack of at most depth × 16 keys. Nodes are not cached (the walk must not
+/// evict the working set of the live TreeCache).
+///
+/// CRITICAL: TreeReader::get_node_bytes must be safe to call from the walk
+/// thread concurrently with the committing thread.
+class TreeShapeAnalyzer {
+private:
+    TreeReader* reader_;
+    std::future<TreeShapeReport> pending_;
+
+    static size_t spread_bucket(uint64_t spread) noexcept {
+        return static_cast<size_t>(std::bit_width(spread));
+    }
+
+    TreeShapeReport walk(uint64_t version, std::optional<uint64_t> persisted_nodes) {
+        auto started = std::chrono::steady_clock::now();
+        TreeShapeReport report;
+        report.version = version;
+        report.persisted_nodes = persisted_nodes;
+
+        std::vector<NodeKey> stack;
+        stack.reserve((TreeShapeReport::MAX_LEVELS - 1) * 16);
+        stack.push_back(NodeKey{version, NibblePath()});
+
+        while (!stack.empty()) {
+            NodeKey key = std::move(stack.back());
+            stack.pop_back();
+
+            size_t depth = key.nibble_path.size();
+            if (depth >= TreeShapeReport::MAX_LEVELS) {
+                ++report.missing_nodes;  // Structurally impossible: treat as unreadable
+                continue;
+            }
+
+            auto bytes = reader_->get_node_bytes(key);
+            std::optional<Node> node = bytes ? deserialize_node_from_bytes(*bytes) : std::nullopt;
+            if (!node) {
+                ++report.missing_nodes;
+                continue;
+            }
+
+            ++report.nodes_by_level[depth];
+            report.serialized_bytes_by_level[depth] += bytes->size();
+            report.cache_bytes_by_level[depth] += estimate_node_bytes(key, *node);
+
+            if (const auto* internal = std::get_if<InternalNode>(&*node)) {
+                ++report.live_internal_nodes;
+                ++report.popcount_by_level[depth][internal->child_count()];
+
+                uint64_t min_v = UINT64_MAX, max_v = 0;
+                for (int nibble = 15; nibble >= 0; --nibble) {
+                    auto child = internal->get_child(static_cast<uint8_t>(nibble));
+                    if (!child) continue;
+                    min_v = std::min(min_v, child->version);
+                    max_v = std::max(max_v, child->version);
+                    NodeKey next{child->version, key.nibble_path};
+                    next.nibble_path.push(static_cast<uint8_t>(nibble));
+                    stack.push_back(std::move(next));
+                }
+                if (max_v >= min_v) ++report.version_spread[spread_bucket(max_v - min_v)];
+            } else {
+                ++report.live_leaf_nodes;
+                ++report.leaf_depth[depth];
+            }
+        }
+
+        report.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started);
+        return report;
+    }
+
+public:
+    explicit TreeShapeAnalyzer(TreeReader* reader) : reader_(reader) {}
+
+    /// @brief Start analysis of `version` on the walk thread
+    /// @param persisted_nodes Total nodes in the store, if known (enables stale/live ratio)
+    void start(uint64_t version, std::optional<uint64_t> persisted_nodes = std::nullopt) {
+        pending_ = std::async(std::launch::async, [this, version, persisted_nodes] {
+            return walk(version, persisted_nodes);
+        });
+    }
+
+    [[nodiscard]] bool running() const {
+        return pending_.valid() &&
+               pending_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    }
+
+    /// @brief Block until the walk started by start() finishes
+    TreeShapeReport wait() {
+        return pending_.get();
+    }
+
+    /// @brief Synchronous analysis on the calling thread
+    TreeShapeReport analyze(uint64_t version, std::optional<uint64_t> persisted_nodes = std::nullopt) {
+        return walk(version, persisted_nodes);
+    }
+};
+
+} // namespace glofica::xook
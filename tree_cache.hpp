@@ -8,50 +8,510 @@
 
 #include "node_type.hpp"
 #include "node_type_hash.hpp"
+#include "l1_node_cache.hpp"
+#include "committed_node_index.hpp"
 #include <unordered_map>
+#include <unordered_set>
+#include <deque>
 #include <list>
 #include <mutex>
+#include <set>
 #include <shared_mutex>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <vector>
 
 namespace glofica::xook {
 
+/// @brief Approximate resident size of one cached node (key + payload + container overhead)
+///
+/// Used for memory budgeting only. Counts heap storage behind the NibblePath
+/// and the child vector, plus a fixed per-entry overhead for the map bucket,
+/// LRU list node and shared node handle.
+[[nodiscard]] inline size_t estimate_node_bytes(const NodeKey& key, const Node& node) noexcept {
+    constexpr size_t ENTRY_OVERHEAD = 80;  // map node + bucket + list node + shared_ptr control block
+    size_t bytes = ENTRY_OVERHEAD + sizeof(NodeKey) + sizeof(Node) + key.nibble_path.bytes().size();
+    if (const auto* internal = std::get_if<InternalNode>(&node)) {
+        bytes += internal->children.size() * sizeof(ChildInfo);
+    }
+    return bytes;
+}
+
+/// @brief Shared, immutable handle to a cached node
+using NodeHandle = std::shared_ptr<const Node>;
+
+/// @brief Allocator that keeps its memory resource alive
+///
+/// Stored in each handle's control block, so a handle that outlives its
+/// cache (thread-local L1 slot, committed index, caller copy) can still be
+/// freed into the right resource.
+template <typename T>
+class SharedResourceAllocator {
+public:
+    using value_type = T;
+    
+    std::shared_ptr<std::pmr::memory_resource> resource;
+    
+    explicit SharedResourceAllocator(std::shared_ptr<std::pmr::memory_resource> r) noexcept
+        : resource(std::move(r)) {}
+    
+    template <typename U>
+    SharedResourceAllocator(const SharedResourceAllocator<U>& other) noexcept : resource(other.resource) {}
+    
+    [[nodiscard]] T* allocate(size_t n) {
+        return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+    }
+    
+    void deallocate(T* p, size_t n) noexcept {
+        resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+    
+    template <typename U>
+    bool operator==(const SharedResourceAllocator<U>& other) const noexcept {
+        return resource == other.resource;
+    }
+};
+
+/// @brief How TreeCache picks eviction victims
+enum class EvictionPolicy : uint8_t {
+    LRU,          // Least recently used, every node alike
+    GreedyDual    // Cost-aware (GreedyDual-Size-Frequency, depth-weighted)
+};
+
+/// @brief GreedyDual depth weights: a node at depth d < weighted_depth costs
+/// 2^(level_shift * (weighted_depth - d)), deeper nodes cost 1
+///
+/// Hit counts already credit upper nodes for every traversal through them;
+/// the depth weight additionally protects the top levels right after a
+/// cache reset, when counts are still low. Defaults measured with
+/// tests/xook/benchmark_cache_eviction.cpp.
+struct GreedyDualCost {
+    size_t weighted_depth = 4;
+    unsigned level_shift = 1;
+};
+
+/// @brief What TreeCache does with a node once a newer version of its path is committed
+enum class SupersedePolicy : uint8_t {
+    Off,      // Superseded nodes age out like any other
+    Demote,   // Move to the eviction front (historical reads still hit until pressure)
+    Drop      // Evict at once (historical reads disabled)
+};
+
+/// @brief Miss-side counters for capacity tuning (AdaptiveCacheSizer)
+struct CacheFeedback {
+    uint64_t misses = 0;       // Lookups that fell through to the TreeReader
+    uint64_t ghost_hits = 0;   // ... of which were evicted recently (hits for a larger cache)
+    size_t ghost_entries = 0;
+};
+
+/// @brief Non-owning view of a visit_committed callback (no allocation)
+class CommittedVisitor {
+private:
+    void* fn_;
+    void (*call_)(void*, const Node&);
+
+public:
+    template <typename Fn>
+    explicit CommittedVisitor(Fn& fn) noexcept
+        : fn_(const_cast<void*>(static_cast<const void*>(std::addressof(fn)))),
+          call_([](void* f, const Node& node) { (*static_cast<Fn*>(f))(node); }) {}
+
+    void operator()(const Node& node) const { call_(fn_, node); }
+};
+
 /// @brief LRU cache for tree nodes
 /// 
 /// In TEE environments (SGX), EPC memory is limited (~128MB).
 /// TreeCache keeps hot paths in memory while evicting cold nodes.
+///
+/// Nodes are stored behind NodeHandle so a hit via get_shared() is a
+/// reference-count bump instead of a deep copy of the child vector.
+///
+/// Optional thread-local L1 (enable_thread_local_l1): hits are served from a
+/// per-thread direct-mapped cache without taking mutex_. L1 entries are
+/// invalidated by epoch_, bumped whenever a key's node is replaced or the
+/// cache is cleared/shrunk. L1 hits do not refresh LRU position; upper levels
+/// that live in L1 are re-promoted on every L1 miss.
+///
+/// Optional committed-node index (enable_committed_index): after each commit
+/// the writer calls publish_committed(version), which pushes nodes of
+/// versions <= version (and evictions since the last publish) into an
+/// RCU-published CommittedNodeIndex. Lookups that hit the index take no lock;
+/// only puts, evictions and publishing go through mutex_.
+///
+/// Optional cost-aware eviction (set_eviction_policy(GreedyDual)): each entry
+/// has priority H = L + hits * cost(depth) / bytes, recomputed on every hit;
+/// the victim is the smallest H and the inflation L rises to it, so entries
+/// that stop being hit age out however costly. An upper internal node is
+/// hit by every lookup below it and a 300-byte leaf outranks a 1.4KB node
+/// per byte; plain LRU sees neither. Priorities live in an ordered set
+/// updated by node extraction: O(log n) per hit, no allocation.
+///
+/// Optional supersede tracking (set_supersede_policy): the cache remembers
+/// the newest committed version cached per nibble path. publish_committed()
+/// compares the nodes put since the last publish against it; the older
+/// node at a path that gained a newer version is demoted to the eviction
+/// front or dropped, so after a few blocks the cache holds mostly live
+/// nodes. Assumes a linear committed history (no forks in the main cache).
+///
+/// Optional ghost tracking (set_ghost_capacity): fingerprints of the last N
+/// evicted keys are kept without their nodes. A miss on one is a ghost hit,
+/// i.e. a hit the cache would have had with N more entries; that marginal
+/// gain drives AdaptiveCacheSizer.
+///
+/// Optional eviction listener (set_eviction_listener): LRU evictions are
+/// handed to it after mutex_ is released, e.g. to demote them into a
+/// compressed cold tier (TieredTreeCache). Nodes demoted by supersede
+/// tracking are flagged, so a tier can skip dead versions.
 class TreeCache {
+public:
+    /// (key, node, superseded): superseded = demoted as an older version of its path
+    using EvictionListener = std::function<void(const NodeKey&, const NodeHandle&, bool)>;
+    
 private:
-    size_t capacity_;
+    std::atomic<size_t> capacity_;  // Written under mutex_, read lock-free by capacity()
+    
+    // Identity + invalidation epoch for thread-local L1 slots
+    const uint64_t id_ = next_cache_id();
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<bool> l1_enabled_{false};
+    
+    static uint64_t next_cache_id() noexcept {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Backing memory for node handles, map entries and LRU nodes; nullptr = global heap
+    // Declared before the containers that are constructed from it
+    std::shared_ptr<std::pmr::memory_resource> node_resource_;
     
     // LRU list (most recent at front)
-    std::list<NodeKey> lru_list_;
+    std::pmr::list<NodeKey> lru_list_;
+    
+    using ListIter = std::pmr::list<NodeKey>::iterator;
+    
+    // GreedyDual order: smallest (priority, seq) is the next victim
+    struct GdSlot {
+        uint64_t priority;
+        uint64_t seq;  // Tie-break: older first
+        NodeKey key;
+        
+        bool operator<(const GdSlot& other) const noexcept {
+            return priority != other.priority ? priority < other.priority : seq < other.seq;
+        }
+    };
+    using GdIter = std::pmr::set<GdSlot>::iterator;
+    
+    struct CacheEntry {
+        NodeHandle node;
+        ListIter lru;
+        GdIter gd;          // Valid under GreedyDual only
+        uint32_t hits = 1;
+        bool superseded = false;  // Demoted by supersede tracking
+    };
+    
+    // Map: NodeKey → (Node handle, LRU position, GreedyDual position)
+    std::pmr::unordered_map<NodeKey, CacheEntry> cache_map_;
+    
+    // Eviction policy (the LRU list is kept under both, so switching back is free)
+    static constexpr uint32_t GD_MAX_HITS = 1u << 20;
+    EvictionPolicy policy_ = EvictionPolicy::LRU;
+    GreedyDualCost gd_cost_;
+    std::pmr::set<GdSlot> gd_order_;
+    uint64_t gd_inflation_ = 0;  // L: priority of the last victim
+    uint64_t gd_seq_ = 0;
     
-    // Map: NodeKey → (Node, Iterator to LRU list)
-    using ListIter = std::list<NodeKey>::iterator;
-    std::unordered_map<NodeKey, std::pair<Node, ListIter>> cache_map_;
+    // Supersede tracking: newest cached committed version per path; puts
+    // are queued until publish_committed() confirms their version (compacted
+    // to resident keys once it outgrows the cache, if nobody publishes)
+    SupersedePolicy supersede_ = SupersedePolicy::Off;
+    std::unordered_map<NibblePath, uint64_t, NibblePathHash> latest_version_;
+    std::vector<NodeKey> supersede_pending_;
+    uint64_t superseded_ = 0;
+    
+    // Ghost list: key fingerprints of recent evictions, FIFO-bounded
+    size_t ghost_capacity_ = 0;
+    std::unordered_set<uint64_t> ghost_keys_;
+    std::deque<uint64_t> ghost_fifo_;
+    uint64_t misses_ = 0;
+    uint64_t ghost_hits_ = 0;
+    
+    // Approximate resident bytes (readable without the lock for memory governance)
+    std::atomic<size_t> bytes_{0};
+    
+    // RCU index of committed nodes; changes are queued under mutex_ and
+    // published by publish_committed()
+    std::unique_ptr<CommittedNodeIndex> index_;
+    std::atomic<const CommittedNodeIndex*> index_view_{nullptr};
+    std::vector<NodeKey> index_pending_;
+    std::vector<NodeKey> index_evicted_;
+    // Index writers (publish_committed, clear): taken before mutex_, so a
+    // publish applying its upserts unlocked cannot interleave with a clear
+    std::mutex publish_mutex_;
+    
+    // Evictions queued under mutex_ for the listener (delivered unlocked)
+    struct Eviction {
+        NodeKey key;
+        NodeHandle node;
+        bool superseded;
+    };
+    EvictionListener eviction_listener_;
+    std::vector<Eviction> evicted_out_;
     
     // Thread-safety for Parallel VM
     mutable std::shared_mutex mutex_;
     
+    /// @brief Copy a node into a fresh handle (from node_resource_ when set)
+    [[nodiscard]] NodeHandle make_handle(const Node& node) const {
+        if (node_resource_) {
+            return std::allocate_shared<Node>(SharedResourceAllocator<Node>(node_resource_), node);
+        }
+        return std::make_shared<const Node>(node);
+    }
+    
+    /// @brief GreedyDual credit per hit: cost(depth) / bytes (16.16 fixed point)
+    [[nodiscard]] uint64_t gd_credit(const NodeKey& key, const Node& node) const noexcept {
+        size_t depth = key.nibble_path.size();
+        size_t levels = depth < gd_cost_.weighted_depth ? gd_cost_.weighted_depth - depth : 0;
+        uint64_t cost = uint64_t{1} << std::min<size_t>(levels * gd_cost_.level_shift, 24);
+        return (cost << 16) / estimate_node_bytes(key, node);
+    }
+    
+    /// @brief (Re)insert an entry into the GreedyDual order at L + hits * credit
+    void gd_place_locked(const NodeKey& key, CacheEntry& entry, const Node& node) {
+        GdSlot slot{gd_inflation_ + entry.hits * gd_credit(key, node), ++gd_seq_, key};
+        entry.gd = gd_order_.insert(std::move(slot)).first;
+    }
+    
+    /// @brief Record a hit (or replacement): MRU position, GreedyDual priority
+    void touch_locked(const NodeKey& key, CacheEntry& entry, const Node& node) {
+        lru_list_.splice(lru_list_.begin(), lru_list_, entry.lru);
+        if (policy_ != EvictionPolicy::GreedyDual) return;
+        if (entry.hits < GD_MAX_HITS) ++entry.hits;
+        // Re-key the existing set node: no allocation
+        auto handle = gd_order_.extract(entry.gd);
+        handle.value().priority = gd_inflation_ + entry.hits * gd_credit(key, node);
+        handle.value().seq = ++gd_seq_;
+        entry.gd = gd_order_.insert(std::move(handle)).position;
+    }
+    
+    /// @brief Fill a just-emplaced entry and place it at the front
+    void insert_locked(const NodeKey& key, CacheEntry& entry, const Node& node) {
+        entry.node = make_handle(node);
+        lru_list_.push_front(key);
+        entry.lru = lru_list_.begin();
+        if (policy_ == EvictionPolicy::GreedyDual) gd_place_locked(key, entry, node);
+        if (supersede_ != SupersedePolicy::Off) {
+            supersede_pending_.push_back(key);
+            if (supersede_pending_.size() > 2 * capacity_.load(std::memory_order_relaxed) + 1024) {
+                compact_supersede_pending_locked();
+            }
+        }
+        bytes_.fetch_add(estimate_node_bytes(key, node), std::memory_order_relaxed);
+        if (index_) index_pending_.push_back(key);
+    }
+    
+    /// @brief Swap in a new node for a resident key and move it to front (caller bumps epoch_)
+    void replace_locked(const NodeKey& key, CacheEntry& entry, const Node& node) {
+        touch_locked(key, entry, node);
+        bytes_.fetch_sub(estimate_node_bytes(key, *entry.node), std::memory_order_relaxed);
+        entry.node = make_handle(node);
+        bytes_.fetch_add(estimate_node_bytes(key, node), std::memory_order_relaxed);
+        if (index_) index_pending_.push_back(key);
+    }
+    
+    /// @brief Remove an entry without notifying the listener (dead node)
+    void drop_locked(std::pmr::unordered_map<NodeKey, CacheEntry>::iterator it) {
+        bytes_.fetch_sub(estimate_node_bytes(it->first, *it->second.node), std::memory_order_relaxed);
+        if (index_) index_evicted_.push_back(it->first);
+        if (policy_ == EvictionPolicy::GreedyDual) gd_order_.erase(it->second.gd);
+        lru_list_.erase(it->second.lru);
+        cache_map_.erase(it);
+    }
+    
+    /// @brief Forget the newest-version record of a path whose newest node leaves the cache
+    void forget_latest_locked(const NodeKey& key) {
+        if (supersede_ == SupersedePolicy::Off) return;
+        auto latest = latest_version_.find(key.nibble_path);
+        if (latest != latest_version_.end() && latest->second == key.version) latest_version_.erase(latest);
+    }
+    
+    /// @brief Demote or drop `stale` (an older version of a path that has a newer one)
+    void supersede_locked(const NodeKey& stale) {
+        auto it = cache_map_.find(stale);
+        if (it == cache_map_.end()) return;
+        ++superseded_;
+        if (supersede_ == SupersedePolicy::Drop) {
+            drop_locked(it);
+            return;
+        }
+        it->second.superseded = true;
+        lru_list_.splice(lru_list_.end(), lru_list_, it->second.lru);
+        if (policy_ == EvictionPolicy::GreedyDual) {
+            // Below any live priority (>= L): next victim, unless hit again first
+            auto handle = gd_order_.extract(it->second.gd);
+            handle.value().priority = 0;
+            handle.value().seq = ++gd_seq_;
+            it->second.gd = gd_order_.insert(std::move(handle)).position;
+            it->second.hits = 1;
+        }
+    }
+    
+    /// @brief Drop queued keys that were evicted since, and repeats of re-inserted ones
+    void compact_supersede_pending_locked() {
+        std::unordered_set<NodeKey> seen;
+        std::erase_if(supersede_pending_, [&](const NodeKey& key) {
+            return !cache_map_.contains(key) || !seen.insert(key).second;
+        });
+    }
+    
+    /// @brief Settle queued puts of versions <= committed_version against latest_version_
+    void apply_supersede_locked(uint64_t committed_version) {
+        std::vector<NodeKey> deferred;
+        for (auto& key : supersede_pending_) {
+            if (key.version > committed_version) {
+                deferred.push_back(std::move(key));
+                continue;
+            }
+            // Evicted between put and publish: nothing to track or demote
+            if (!cache_map_.contains(key)) continue;
+            auto [latest, inserted] = latest_version_.try_emplace(key.nibble_path, key.version);
+            if (inserted || latest->second == key.version) continue;
+            // Older of the two loses (a late historical read loses to the live node)
+            uint64_t stale_version = std::min(latest->second, key.version);
+            latest->second = std::max(latest->second, key.version);
+            key.version = stale_version;
+            supersede_locked(key);
+        }
+        supersede_pending_ = std::move(deferred);
+    }
+    
+    /// @brief Remember an evicted key (stale FIFO slots of re-read keys just expire early)
+    void remember_ghost_locked(const NodeKey& key) {
+        if (ghost_capacity_ == 0) return;
+        uint64_t fingerprint = std::hash<NodeKey>{}(key);
+        if (!ghost_keys_.insert(fingerprint).second) return;
+        ghost_fifo_.push_back(fingerprint);
+        trim_ghosts_locked();
+    }
+    
+    void trim_ghosts_locked() {
+        while (ghost_fifo_.size() > ghost_capacity_) {
+            ghost_keys_.erase(ghost_fifo_.front());
+            ghost_fifo_.pop_front();
+        }
+    }
+    
+    /// @brief Evict the policy's victim (caller holds exclusive lock, cache non-empty)
+    void evict_lru_locked() {
+        auto it = cache_map_.end();
+        if (policy_ == EvictionPolicy::GreedyDual) {
+            gd_inflation_ = gd_order_.begin()->priority;
+            it = cache_map_.find(gd_order_.begin()->key);
+            gd_order_.erase(gd_order_.begin());
+        } else {
+            it = cache_map_.find(lru_list_.back());
+        }
+        bytes_.fetch_sub(estimate_node_bytes(it->first, *it->second.node), std::memory_order_relaxed);
+        if (index_) index_evicted_.push_back(it->first);
+        forget_latest_locked(it->first);
+        remember_ghost_locked(it->first);
+        if (eviction_listener_) evicted_out_.push_back({it->first, std::move(it->second.node), it->second.superseded});
+        lru_list_.erase(it->second.lru);
+        cache_map_.erase(it);
+    }
+    
+    /// @brief Release `lock` and hand queued evictions to the listener
+    void deliver_evictions(std::unique_lock<std::shared_mutex>& lock) {
+        if (evicted_out_.empty()) return;
+        std::vector<Eviction> evicted;
+        evicted.swap(evicted_out_);
+        lock.unlock();
+        for (const auto& e : evicted) eviction_listener_(e.key, e.node, e.superseded);
+    }
+    
+    /// @brief Occasionally refresh LRU position of an index hit
+    /// Index hits skip mutex_; without this, hot committed nodes would age out
+    /// of the LRU (and then out of the index). try_lock keeps readers lock-free.
+    void promote_sampled(const NodeKey& key) {
+        thread_local uint32_t tick = 0;
+        if ((++tick & 63) != 0) return;
+        std::unique_lock<std::shared_mutex> lock(mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) return;
+        auto it = cache_map_.find(key);
+        if (it != cache_map_.end()) {
+            touch_locked(it->first, it->second, *it->second.node);
+        }
+    }
+    
 public:
-    explicit TreeCache(size_t capacity = 100000) : capacity_(capacity) {}
+    /// @param resource Optional allocator for handles + map/list entries
+    ///        (e.g. HugePageSlabResource); handles share its ownership.
+    ///        NibblePath bytes and InternalNode child arrays still use the global heap.
+    explicit TreeCache(size_t capacity = 100000, std::shared_ptr<std::pmr::memory_resource> resource = nullptr)
+        : capacity_(capacity),
+          node_resource_(std::move(resource)),
+          lru_list_(node_resource_ ? node_resource_.get() : std::pmr::get_default_resource()),
+          cache_map_(node_resource_ ? node_resource_.get() : std::pmr::get_default_resource()),
+          gd_order_(node_resource_ ? node_resource_.get() : std::pmr::get_default_resource()) {}
     
     virtual ~TreeCache() = default;
 
     /// @brief Get node (promotes to MRU)
     virtual std::optional<Node> get(const NodeKey& key) {
-        // LRU requires list modification, so we need exclusive lock
-        std::unique_lock<std::shared_mutex> lock(mutex_);
-        
-        auto it = cache_map_.find(key);
-        if (it == cache_map_.end()) {
+        auto handle = get_shared(key);
+        if (!handle) {
             return std::nullopt;
         }
+        return *handle;
+    }
+    
+    /// @brief Get shared handle to node (promotes to MRU, no node copy)
+    /// PERF: Zero heap allocations on hit; lock-free on L1 and committed-index hits
+    virtual NodeHandle get_shared(const NodeKey& key) {
+        const bool use_l1 = l1_enabled_.load(std::memory_order_relaxed);
+        uint64_t epoch = 0;
+        if (use_l1) {
+            epoch = epoch_.load(std::memory_order_acquire);
+            if (auto hit = ThreadLocalNodeCache::instance().get(id_, epoch, key)) {
+                return hit;
+            }
+        }
         
-        // Move to front (O(1) splice)
-        lru_list_.splice(lru_list_.begin(), lru_list_, it->second.second);
+        NodeHandle handle;
+        if (const auto* index = index_view_.load(std::memory_order_acquire)) {
+            handle = index->find_shared(key);
+            if (handle) promote_sampled(key);
+        }
+        if (!handle) {
+            // LRU requires list modification, so we need exclusive lock
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            
+            auto it = cache_map_.find(key);
+            if (it == cache_map_.end()) {
+                ++misses_;
+                if (ghost_capacity_ && ghost_keys_.erase(std::hash<NodeKey>{}(key))) ++ghost_hits_;
+                return nullptr;
+            }
+            
+            // Move to front (O(1) splice; O(log n) under GreedyDual)
+            touch_locked(it->first, it->second, *it->second.node);
+            
+            handle = it->second.node;
+            
+            // Resident but not indexed (e.g. evicted from the index and re-read)
+            if (index_ && index_pending_.size() < capacity_.load(std::memory_order_relaxed)) index_pending_.push_back(key);
+        }
         
-        return it->second.first;
+        // Tagged with the epoch read before the lookup: a concurrent replace
+        // bumps the epoch after publishing, so a stale fill is never served
+        if (use_l1) {
+            ThreadLocalNodeCache::instance().put(id_, epoch, key, handle);
+        }
+        return handle;
     }
     
     /// @brief Put node (evicts LRU if at capacity)
@@ -61,28 +521,100 @@ public:
         auto it = cache_map_.find(key);
         if (it != cache_map_.end()) {
             // Update existing and move to front
-            lru_list_.splice(lru_list_.begin(), lru_list_, it->second.second);
-            it->second.first = node;
+            replace_locked(it->first, it->second, node);
+            epoch_.fetch_add(1, std::memory_order_release);  // Invalidate L1 copies
             return;
         }
         
         // Evict LRU if at capacity
-        if (cache_map_.size() >= capacity_) {
-            NodeKey last = lru_list_.back();
-            lru_list_.pop_back();
-            cache_map_.erase(last);
+        if (cache_map_.size() >= capacity_.load(std::memory_order_relaxed) && !lru_list_.empty()) {
+            evict_lru_locked();
         }
         
         // Insert new at front
-        lru_list_.push_front(key);
-        cache_map_.emplace(key, std::make_pair(node, lru_list_.begin()));
+        auto inserted = cache_map_.try_emplace(key).first;
+        insert_locked(inserted->first, inserted->second, node);
+        deliver_evictions(lock);
+    }
+    
+    /// @brief Put a commit's nodes (TreeUpdateBatch::node_batch) under one lock
+    /// Same contents and LRU order as put() per node in batch order, but the
+    /// table is pre-sized, room for the new entries is evicted up front, and
+    /// L1 invalidation and the eviction listener run once per batch. Under
+    /// GreedyDual the up-front victims are the lowest priorities before the batch.
+    /// PERF: One exclusive lock per batch instead of one per node
+    virtual void put_many(const std::vector<std::pair<NodeKey, Node>>& nodes) {
+        put_many_if(nodes, [](const NodeKey&) { return true; });
+    }
+    
+    /// @brief put_many() restricted to the nodes whose key satisfies `keep`
+    /// Lets a partitioned cache hand each partition the whole batch without
+    /// copying it into per-partition groups.
+    template <typename KeyPredicate>
+    void put_many_if(const std::vector<std::pair<NodeKey, Node>>& nodes, KeyPredicate&& keep) {
+        if (nodes.empty()) return;
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        
+        // Resident batch keys go to the front first so the bulk eviction
+        // below takes the same LRU victims as per-node puts would
+        size_t fresh = 0;
+        bool replaced = false;  // Set even if the bulk eviction takes the old node
+        for (const auto& [key, node] : nodes) {
+            if (!keep(key)) continue;
+            auto it = cache_map_.find(key);
+            if (it == cache_map_.end()) {
+                ++fresh;
+            } else {
+                lru_list_.splice(lru_list_.begin(), lru_list_, it->second.lru);
+                replaced = true;
+            }
+        }
+        
+        // Bulk eviction: make room for the new entries (the whole cache at most)
+        const size_t capacity = capacity_.load(std::memory_order_relaxed);
+        size_t room = capacity > fresh ? capacity - fresh : 0;
+        while (cache_map_.size() > room && !lru_list_.empty()) {
+            evict_lru_locked();
+        }
+        cache_map_.reserve(cache_map_.size() + std::min(fresh, capacity));
+        if (index_) index_pending_.reserve(index_pending_.size() + fresh);
+        
+        for (const auto& [key, node] : nodes) {
+            if (!keep(key)) continue;
+            auto [it, inserted] = cache_map_.try_emplace(key);
+            if (!inserted) {
+                replace_locked(it->first, it->second, node);
+                continue;
+            }
+            // Batch larger than the cache: its oldest nodes make way, as with put()
+            if (cache_map_.size() > capacity && !lru_list_.empty()) {
+                evict_lru_locked();
+            }
+            insert_locked(it->first, it->second, node);
+        }
+        if (replaced) epoch_.fetch_add(1, std::memory_order_release);  // Invalidate L1 copies
+        deliver_evictions(lock);
     }
     
     /// @brief Clear cache (useful between blocks)
     virtual void clear() {
+        std::lock_guard<std::mutex> publishing(publish_mutex_);
         std::unique_lock<std::shared_mutex> lock(mutex_);
         cache_map_.clear();
         lru_list_.clear();
+        gd_order_.clear();
+        gd_inflation_ = 0;
+        latest_version_.clear();
+        supersede_pending_.clear();
+        ghost_keys_.clear();
+        ghost_fifo_.clear();
+        bytes_.store(0, std::memory_order_relaxed);
+        epoch_.fetch_add(1, std::memory_order_release);
+        if (index_) {
+            index_pending_.clear();
+            index_evicted_.clear();
+            index_->clear();
+        }
     }
     
     /// @brief Get cache size
@@ -91,8 +623,193 @@ public:
         return cache_map_.size();
     }
     
+    /// @brief Approximate resident bytes (lock-free, may lag a concurrent put)
+    [[nodiscard]] virtual size_t approx_bytes() const noexcept {
+        return bytes_.load(std::memory_order_relaxed);
+    }
+    
+    /// @brief Evict LRU entries until approx_bytes() <= target_bytes
+    /// @return Number of bytes released
+    virtual size_t shrink_to_bytes(size_t target_bytes) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        size_t before = bytes_.load(std::memory_order_relaxed);
+        while (!lru_list_.empty() && bytes_.load(std::memory_order_relaxed) > target_bytes) {
+            evict_lru_locked();
+        }
+        // Stop serving evicted nodes from L1 (slots release them on reuse)
+        epoch_.fetch_add(1, std::memory_order_release);
+        size_t released = before - bytes_.load(std::memory_order_relaxed);
+        deliver_evictions(lock);
+        return released;
+    }
+    
+    /// @brief Change capacity (evicts immediately when shrinking)
+    virtual void set_capacity(size_t capacity) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        capacity_.store(capacity, std::memory_order_relaxed);
+        if (cache_map_.size() > capacity) {
+            while (cache_map_.size() > capacity && !lru_list_.empty()) {
+                evict_lru_locked();
+            }
+            epoch_.fetch_add(1, std::memory_order_release);  // Let L1 release the evicted nodes
+        }
+        deliver_evictions(lock);
+    }
+    
+    /// @brief Keep fingerprints of the last `entries` evicted keys (0 = off)
+    virtual void set_ghost_capacity(size_t entries) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        ghost_capacity_ = entries;
+        trim_ghosts_locked();
+    }
+    
+    /// @brief Cumulative miss / ghost-hit counts (lookups served lock-free are hits)
+    [[nodiscard]] virtual CacheFeedback feedback() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return {misses_, ghost_hits_, ghost_keys_.size()};
+    }
+    
+    /// @brief Demote / drop older node versions once a newer one is committed at their path
+    /// Takes effect from the next publish_committed(); nodes already cached are not tracked.
+    virtual void set_supersede_policy(SupersedePolicy policy) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        supersede_ = policy;
+        if (policy == SupersedePolicy::Off) {
+            latest_version_.clear();
+            supersede_pending_.clear();
+        }
+    }
+    
+    [[nodiscard]] virtual SupersedePolicy supersede_policy() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return supersede_;
+    }
+    
+    /// @brief Puts queued for the next publish_committed() (bounded by ~2x capacity)
+    [[nodiscard]] virtual size_t supersede_backlog() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return supersede_pending_.size();
+    }
+    
+    /// @brief Cached nodes demoted or dropped as superseded (since construction)
+    [[nodiscard]] virtual uint64_t superseded_count() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return superseded_;
+    }
+    
+    /// @brief Receive every LRU eviction (node handle included), outside the cache lock
+    /// CRITICAL: Call before concurrent use. clear() drops entries without notifying.
+    virtual void set_eviction_listener(EvictionListener listener) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        eviction_listener_ = std::move(listener);
+    }
+    
+    /// @brief Switch eviction policy; resident entries are kept
+    /// Switching to GreedyDual seeds priorities from recency (hit counts restart at 1).
+    virtual void set_eviction_policy(EvictionPolicy policy, GreedyDualCost cost = {}) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        policy_ = policy;
+        gd_cost_ = cost;
+        gd_order_.clear();
+        gd_inflation_ = 0;
+        if (policy_ != EvictionPolicy::GreedyDual) return;
+        for (auto key = lru_list_.rbegin(); key != lru_list_.rend(); ++key) {  // Oldest first
+            auto& entry = cache_map_.find(*key)->second;
+            entry.hits = 1;
+            gd_place_locked(*key, entry, *entry.node);
+        }
+    }
+    
+    [[nodiscard]] virtual EvictionPolicy eviction_policy() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return policy_;
+    }
+    
+    /// @brief Enable the per-thread L1 in front of this cache (read-heavy threads)
+    virtual void enable_thread_local_l1(bool enabled = true) noexcept {
+        epoch_.fetch_add(1, std::memory_order_release);  // Drop entries from a previous enablement
+        l1_enabled_.store(enabled, std::memory_order_relaxed);
+    }
+    
+    [[nodiscard]] virtual bool thread_local_l1_enabled() const noexcept {
+        return l1_enabled_.load(std::memory_order_relaxed);
+    }
+    
+    /// @brief Enable the RCU committed-node index
+    /// CRITICAL: Call before concurrent use; the index lives until destruction
+    virtual void enable_committed_index() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (index_) return;
+        index_ = std::make_unique<CommittedNodeIndex>();
+        index_pending_.reserve(cache_map_.size());
+        for (const auto& entry : cache_map_) index_pending_.push_back(entry.first);
+        index_view_.store(index_.get(), std::memory_order_release);
+    }
+    
+    [[nodiscard]] virtual bool committed_index_enabled() const noexcept {
+        return index_view_.load(std::memory_order_relaxed) != nullptr;
+    }
+    
+    /// @brief Publish nodes of versions <= committed_version to the index
+    ///
+    /// Writer only (the committing thread); serialized with clear(). Newer versions stay queued until
+    /// a later publish. Evicted keys are removed unless re-inserted since;
+    /// until then the index keeps them alive (and servable, they are immutable).
+    /// Also settles supersede tracking (set_supersede_policy) for the version.
+    /// @return Number of nodes published
+    virtual size_t publish_committed(uint64_t committed_version) {
+        std::lock_guard<std::mutex> publishing(publish_mutex_);
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            if (supersede_ != SupersedePolicy::Off) apply_supersede_locked(committed_version);
+        }
+        if (!index_) return 0;
+        std::vector<std::pair<NodeKey, NodeHandle>> upserts;
+        std::vector<NodeKey> removals;
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            std::vector<NodeKey> deferred;
+            for (auto& key : index_pending_) {
+                if (key.version > committed_version) {
+                    deferred.push_back(std::move(key));
+                    continue;
+                }
+                auto it = cache_map_.find(key);
+                if (it != cache_map_.end()) upserts.emplace_back(std::move(key), it->second.node);
+            }
+            index_pending_ = std::move(deferred);
+            for (auto& key : index_evicted_) {
+                if (!cache_map_.count(key)) removals.push_back(std::move(key));
+            }
+            index_evicted_.clear();
+        }
+        // Apply outside mutex_: readers and puts proceed while entries are relinked
+        index_->apply(upserts, removals);
+        return upserts.size();
+    }
+    
+    /// @brief Lock-free lookup in the committed index (no refcount traffic)
+    ///
+    /// Calls fn(const Node&) while pinned. Only nodes published by
+    /// publish_committed() are visible; returns false on miss.
+    template <typename Fn>
+    bool visit_committed(const NodeKey& key, Fn&& fn) const {
+        return visit_committed_node(key, CommittedVisitor(fn));
+    }
+    
+    /// @brief visit_committed() behind one virtual call (partitioned caches route it)
+    virtual bool visit_committed_node(const NodeKey& key, CommittedVisitor visit) const {
+        const auto* index = index_view_.load(std::memory_order_acquire);
+        if (!index) return false;
+        auto guard = index->pin();
+        const Node* node = index->find(key, guard);
+        if (!node) return false;
+        visit(*node);
+        return true;
+    }
+    
     /// @brief Get capacity
-    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] virtual size_t capacity() const noexcept { return capacity_.load(std::memory_order_relaxed); }
 };
 
 } // namespace glofica::xook
@@ -0,0 +1,279 @@
+// =========================================================
+// FILE: src/xook/tree_verifier.hpp
+// PURPOSE: Parallel full-tree integrity verification
+// CRITICAL: Recomputes every node hash reachable from a root and checks it
+//           against the parent's ChildInfo (post-incident disk audits)
+// =========================================================
+
+#pragma once
+
+#include "xook_merkle_tree.hpp"
+#include "node_serde.hpp"
+#include "numa_topology.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief What went wrong at a node
+enum class VerifyErrorKind : uint8_t {
+    Missing,       // TreeReader returned nullopt
+    Corrupt,       // Bytes did not deserialize (non-canonical / truncated)
+    HashMismatch,  // Recomputed hash != parent's ChildInfo (or expected root)
+    TooDeep        // Path longer than a 64-byte key allows (corrupt structure)
+};
+
+struct VerifyError {
+    NodeKey key;
+    VerifyErrorKind kind;
+    glofica::Hash expected{};
+    glofica::Hash actual{};
+};
+
+/// @brief Outcome of a full verification pass
+struct VerificationReport {
+    uint64_t version = 0;
+    uint64_t nodes_verified = 0;
+    uint64_t internal_nodes = 0;
+    uint64_t leaf_nodes = 0;
+    uint64_t bytes_read = 0;
+    uint64_t error_count = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    // First error in canonical (nibble-ordered, depth-first) order among
+    // those found. With stop_on_first_error, other subtrees stop early.
+    std::optional<VerifyError> first_error;
+
+    [[nodiscard]] bool ok() const noexcept { return error_count == 0; }
+
+    [[nodiscard]] double nodes_per_sec() const noexcept {
+        double secs = std::chrono::duration<double>(elapsed).count();
+        return secs > 0 ? static_cast<double>(nodes_verified) / secs : 0.0;
+    }
+};
+
+/// @brief Walks every node reachable from a root through TreeReader
+///
+/// Work is split by top-level nibble: each of the root's (up to 16) children
+/// is one task, pulled by worker threads from an atomic counter. Each worker
+/// runs an iterative depth-first walk (TEE-safe, no recursion) whose stack
+/// is bounded by depth × 16 entries, so memory stays constant regardless of
+/// tree size.
+///
+/// CRITICAL: TreeReader::get_node_bytes must be safe for concurrent calls
+/// (true for ExternalReader over KVStore).
+class TreeVerifier {
+public:
+    struct Options {
+        size_t threads = 0;               // 0 = hardware_concurrency (capped at 16)
+        bool stop_on_first_error = false;
+        bool numa_bind = false;           // Bind pool threads to each subtree's home node
+    };
+
+private:
+    static constexpr size_t MAX_DEPTH = 128;  // 64-byte key = 128 nibbles
+
+    struct PendingNode {
+        NodeKey key;
+        glofica::Hash expected;
+    };
+
+    struct TaskResult {
+        uint64_t nodes = 0;
+        uint64_t internal_nodes = 0;
+        uint64_t leaf_nodes = 0;
+        uint64_t bytes_read = 0;
+        uint64_t errors = 0;
+        std::optional<VerifyError> first_error;
+
+        void record(VerifyError err) {
+            ++errors;
+            if (!first_error) first_error = std::move(err);
+        }
+    };
+
+    TreeReader* reader_;
+    Options options_;
+    std::atomic<bool> stop_{false};
+
+    /// @brief Load, check and expand one node; pushes children onto stack
+    /// @return Decoded node or nullopt on error (recorded in result)
+    std::optional<Node> check_node(const PendingNode& pending, TaskResult& result) {
+        if (pending.key.nibble_path.size() > MAX_DEPTH) {
+            result.record({pending.key, VerifyErrorKind::TooDeep, pending.expected, {}});
+            return std::nullopt;
+        }
+
+        auto bytes = reader_->get_node_bytes(pending.key);
+        if (!bytes) {
+            result.record({pending.key, VerifyErrorKind::Missing, pending.expected, {}});
+            return std::nullopt;
+        }
+        result.bytes_read += bytes->size();
+
+        auto node = deserialize_node_from_bytes(*bytes);
+        if (!node) {
+            result.record({pending.key, VerifyErrorKind::Corrupt, pending.expected, {}});
+            return std::nullopt;
+        }
+
+        ++result.nodes;
+        glofica::Hash actual = hash_node(*node);
+        if (actual != pending.expected) {
+            result.record({pending.key, VerifyErrorKind::HashMismatch, pending.expected, actual});
+            return std::nullopt;  // Children of a bad node are not trusted
+        }
+
+        if (std::holds_alternative<InternalNode>(*node)) {
+            ++result.internal_nodes;
+        } else {
+            ++result.leaf_nodes;
+        }
+        return node;
+    }
+
+    /// @brief Push children of an internal node (reverse order: pops ascend)
+    static void push_children(const NodeKey& parent, const InternalNode& internal,
+                              std::vector<PendingNode>& stack) {
+        for (int nibble = 15; nibble >= 0; --nibble) {
+            auto child = internal.get_child(static_cast<uint8_t>(nibble));
+            if (!child) continue;
+            PendingNode next{NodeKey{child->version, parent.nibble_path}, child->hash};
+            next.key.nibble_path.push(static_cast<uint8_t>(nibble));
+            stack.push_back(std::move(next));
+        }
+    }
+
+    void verify_subtree(PendingNode start, TaskResult& result) {
+        std::vector<PendingNode> stack;
+        stack.reserve(MAX_DEPTH * 16);
+        stack.push_back(std::move(start));
+
+        while (!stack.empty()) {
+            if (options_.stop_on_first_error && stop_.load(std::memory_order_relaxed)) return;
+
+            PendingNode pending = std::move(stack.back());
+            stack.pop_back();
+
+            auto node = check_node(pending, result);
+            if (!node) {
+                if (options_.stop_on_first_error) stop_.store(true, std::memory_order_relaxed);
+                continue;
+            }
+            if (const auto* internal = std::get_if<InternalNode>(&*node)) {
+                push_children(pending.key, *internal, stack);
+            }
+        }
+    }
+
+public:
+    explicit TreeVerifier(TreeReader* reader) : reader_(reader) {}
+    TreeVerifier(TreeReader* reader, Options options) : reader_(reader), options_(options) {}
+
+    /// @brief Verify the whole tree at `version`
+    /// @param expected_root Root hash to check against (e.g. from block header);
+    ///        if nullopt, only internal consistency is checked
+    VerificationReport verify(uint64_t version, std::optional<glofica::Hash> expected_root = std::nullopt) {
+        auto started = std::chrono::steady_clock::now();
+        stop_.store(false, std::memory_order_relaxed);
+
+        VerificationReport report;
+        report.version = version;
+
+        // 1. Root (single-threaded)
+        TaskResult root_result;
+        NodeKey root_key{version, NibblePath()};
+        std::optional<Node> root;
+
+        auto root_bytes = reader_->get_node_bytes(root_key);
+        if (!root_bytes) {
+            root_result.record({root_key, VerifyErrorKind::Missing, expected_root.value_or(glofica::Hash{}), {}});
+        } else if (auto decoded = deserialize_node_from_bytes(*root_bytes); !decoded) {
+            root_result.bytes_read += root_bytes->size();
+            root_result.record({root_key, VerifyErrorKind::Corrupt, expected_root.value_or(glofica::Hash{}), {}});
+        } else {
+            root_result.bytes_read += root_bytes->size();
+            ++root_result.nodes;
+            glofica::Hash actual = hash_node(*decoded);
+            if (expected_root && actual != *expected_root) {
+                root_result.record({root_key, VerifyErrorKind::HashMismatch, *expected_root, actual});
+            } else {
+                if (std::holds_alternative<InternalNode>(*decoded)) {
+                    ++root_result.internal_nodes;
+                } else {
+                    ++root_result.leaf_nodes;
+                }
+                root = std::move(decoded);
+            }
+        }
+
+        // 2. One task per top-level nibble, in parallel
+        std::vector<PendingNode> tasks;
+        if (root) {
+            if (const auto* internal = std::get_if<InternalNode>(&*root)) {
+                push_children(root_key, *internal, tasks);
+                std::reverse(tasks.begin(), tasks.end());  // Ascending nibble order
+            }
+        }
+
+        std::vector<TaskResult> results(tasks.size());
+        if (!tasks.empty()) {
+            size_t threads = options_.threads != 0
+                ? options_.threads
+                : std::max<size_t>(1, std::thread::hardware_concurrency());
+            threads = std::min({threads, tasks.size(), size_t{16}});
+
+            std::atomic<size_t> next_task{0};
+            std::exception_ptr failure;
+            std::mutex failure_mutex;
+            auto worker = [&](bool bind) {
+                try {
+                    for (size_t i = next_task.fetch_add(1); i < tasks.size(); i = next_task.fetch_add(1)) {
+                        if (bind) {
+                            // Same homing as NumaTreeCache shards: reads stay socket-local
+                            const auto& topo = NumaTopology::system();
+                            numa::bind_current_thread(topo.home_node_for_nibble(tasks[i].key.nibble_path.get_nibble(0)));
+                        }
+                        verify_subtree(std::move(tasks[i]), results[i]);
+                    }
+                } catch (...) {
+                    // Reader failure (e.g. I/O error): rethrown on the caller, not std::terminate
+                    std::lock_guard<std::mutex> lock(failure_mutex);
+                    if (!failure) failure = std::current_exception();
+                    next_task.store(tasks.size());  // Drain other workers
+                }
+            };
+
+            std::vector<std::thread> pool;
+            pool.reserve(threads - 1);
+            for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker, options_.numa_bind);
+            worker(false);  // Caller's affinity is left untouched
+            for (auto& th : pool) th.join();
+            if (failure) std::rethrow_exception(failure);
+        }
+
+        // 3. Merge (root first, then subtrees in nibble order)
+        auto merge = [&report](TaskResult& r) {
+            report.nodes_verified += r.nodes;
+            report.internal_nodes += r.internal_nodes;
+            report.leaf_nodes += r.leaf_nodes;
+            report.bytes_read += r.bytes_read;
+            report.error_count += r.errors;
+            if (!report.first_error && r.first_error) report.first_error = std::move(r.first_error);
+        };
+        merge(root_result);
+        for (auto& r : results) merge(r);
+
+        report.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started);
+        return report;
+    }
+};
+
+} // namespace glofica::xook
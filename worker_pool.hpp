@@ -0,0 +1,98 @@
+// =========================================================
+// FILE: src/xook/worker_pool.hpp
+// PURPOSE: Persistent fork-join pool for per-commit parallel work
+// CRITICAL: Threads are started once and reused: a commit hands out jobs
+//           instead of paying thread creation on the commit path
+// =========================================================
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace glofica::xook {
+
+/// @brief Fixed set of workers that run one batch of jobs at a time
+///
+/// run() publishes the jobs as a new generation, takes part in running them
+/// on the calling thread, and returns when all of them finished. Jobs must
+/// not throw (capture failures into an exception_ptr). One caller at a time.
+class WorkerPool {
+private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::vector<std::function<void()>> jobs_;
+    size_t next_job_ = 0;
+    size_t jobs_done_ = 0;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+
+    /// @brief Claim and run jobs of the current generation until none are left
+    void run_jobs(std::unique_lock<std::mutex>& lock) {
+        while (next_job_ < jobs_.size()) {
+            auto& job = jobs_[next_job_++];
+            lock.unlock();
+            job();
+            lock.lock();
+            if (++jobs_done_ == jobs_.size()) done_cv_.notify_all();
+        }
+    }
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t seen = 0;
+        while (true) {
+            work_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            run_jobs(lock);
+        }
+    }
+
+public:
+    /// @param threads Total parallelism including the caller (workers started: threads - 1)
+    explicit WorkerPool(size_t threads) {
+        for (size_t t = 1; t < threads; ++t) workers_.emplace_back([this] { worker_loop(); });
+    }
+
+    /// @brief Parallelism for `jobs` independent jobs, capped at the hardware threads
+    [[nodiscard]] static size_t threads_for(size_t jobs) noexcept {
+        return std::min<size_t>(std::max<size_t>(1, jobs), std::max<size_t>(1, std::thread::hardware_concurrency()));
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// @brief Run all jobs on the pool + calling thread, return when every job finished
+    void run(std::vector<std::function<void()>> jobs) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        jobs_ = std::move(jobs);
+        next_job_ = 0;
+        jobs_done_ = 0;
+        ++generation_;
+        work_cv_.notify_all();
+        run_jobs(lock);
+        done_cv_.wait(lock, [&] { return jobs_done_ == jobs_.size(); });
+        jobs_.clear();
+    }
+
+    [[nodiscard]] size_t thread_count() const noexcept { return workers_.size() + 1; }
+};
+
+} // namespace glofica::xook
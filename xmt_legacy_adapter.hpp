@@ -8,8 +8,10 @@
 #pragma once
 
 #include "jellyfish_merkle_tree.hpp"
+#include "node_arena_store.hpp"
 #include "../common/hash.hpp"
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 namespace glofica::state {
@@ -26,11 +28,25 @@ private:
     std::unique_ptr<jmt::TreeCache> cache_;
     std::unique_ptr<jmt::JellyfishMerkleTree> tree_;
     
-    /// @brief In-memory reader (TODO: Connect to RocksDB in production)
+    /// @brief In-memory reader over committed nodes (TODO: Connect to RocksDB in production)
+    /// Nodes evicted from the 100K-node cache are served from the arena store.
     class InMemoryReader : public jmt::TreeReader {
     public:
+        xook::NodeArenaStore store;
+        std::optional<uint64_t> retention;  // Versions kept readable (nullopt = all)
+        
         std::optional<glofica::Bytes> get_node_bytes(const jmt::NodeKey& key) override {
-            return std::nullopt;  // All nodes in cache for now
+            return store.get_raw(key.serialize());
+        }
+        
+        /// @brief Keep a committed batch (same key/value layout as the KVStore),
+        /// then drop nodes superseded outside the retention window
+        template <typename NodeBatch>
+        void persist(const NodeBatch& batch, uint64_t version) {
+            for (const auto& [key, node] : batch) {
+                store.put_raw(key.serialize(), jmt::serialize_node_with_prefix(node));
+            }
+            if (retention && version > *retention) store.prune(version - *retention);
         }
     };
     
@@ -127,6 +143,7 @@ public:
         
         // CRITICAL: Apply batch to JMT (deterministic sorting happens here)
         auto result = tree_->put_value_set(jmt_updates, version);
+        reader_->persist(result.node_batch, version);
         
         // Clear pending updates
         pending_updates_.clear();
@@ -196,6 +213,7 @@ public:
         
         // Apply batch
         auto result = tree_->put_value_set(jmt_updates, version);
+        reader_->persist(result.node_batch, version);
         last_root_ = result.new_root_hash;
         current_version_ = version;
     }
@@ -204,6 +222,17 @@ public:
     size_t cache_size() const {
         return cache_->size();
     }
+    
+    /// @brief Node store behind the reader (committed nodes evicted from the cache)
+    [[nodiscard]] xook::NodeArenaStore& in_memory_store() noexcept { return reader_->store; }
+    
+    /// @brief Keep only the last `versions` versions readable (nullopt = keep all)
+    /// Same window as XookAdapter::set_in_memory_retention; get() older than it
+    /// may find nodes missing.
+    void set_in_memory_retention(std::optional<uint64_t> versions) {
+        reader_->retention = versions;
+        if (versions) reader_->store.enable_stale_tracking();
+    }
 };
 
 } // namespace glofica::state
@@ -7,10 +7,27 @@
 #pragma once
 
 #include "xook_merkle_tree.hpp"
+#include "memory_governor.hpp"
+#include "numa_tree_cache.hpp"
+#include "tiered_tree_cache.hpp"
+#include "huge_page_resource.hpp"
+#include "block_arena.hpp"
+#include "node_arena_store.hpp"
+#include "xook_stats.hpp"
+#include "epoch_reclamation.hpp"
+#include "adaptive_cache_sizer.hpp"
+#include "ordered_update_sets.hpp"
+#include "change_feed.hpp"
 #include "../common/hash.hpp"
 #include "../kv/kv_store.hpp" // Added dependency
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 
 namespace glofica::xook {
 
@@ -25,44 +42,183 @@ namespace glofica::xook {
 class SpeculativeTreeCache : public TreeCache {
 private:
     TreeCache* base_cache_;
-    std::unordered_map<NodeKey, Node> overlay_;
-    std::unordered_map<NodeKey, Node> injected_;
+    
+    // Overlay entries (keys, paths, child arrays, map nodes) live entirely in
+    // resource_; with a per-block monotonic arena they are freed in O(1)
+    std::pmr::memory_resource* resource_;
+    using OverlayMap = std::pmr::unordered_map<pmr::NodeKey, pmr::Node, NodeKeyHash, NodeKeyEqual>;
+    OverlayMap overlay_;
+    OverlayMap injected_;
+    
+    // Memory accounting (overlays are charged to the adapter's MemoryGovernor)
+    MemoryGovernor::SpeculativeLease* lease_;
+    size_t bytes_ = 0;
+    
+    void charge(const NodeKey& key, const Node& node) {
+        size_t bytes = estimate_node_bytes(key, node);
+        bytes_ += bytes;
+        if (lease_) lease_->charge(bytes);
+    }
 
 public:
-    explicit SpeculativeTreeCache(TreeCache* base) : TreeCache(0), base_cache_(base) {}
+    /// @param resource Allocator for overlay entries (e.g. the adapter's huge-page slab)
+    explicit SpeculativeTreeCache(TreeCache* base, MemoryGovernor::SpeculativeLease* lease = nullptr,
+                                  std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : TreeCache(0), base_cache_(base), resource_(resource),
+          overlay_(resource), injected_(resource), lease_(lease) {}
     
     void inject_node(const NodeKey& key, const Node& node) {
-        injected_[key] = node;
+        auto [it, inserted] = injected_.insert_or_assign(to_pmr(key, resource_), to_pmr(node, resource_));
+        if (inserted) charge(key, node);
     }
 
     std::optional<Node> get(const NodeKey& key) override {
         auto it = overlay_.find(key);
-        if (it != overlay_.end()) return it->second;
+        if (it != overlay_.end()) return to_std(it->second);
         
         auto it_inj = injected_.find(key);
-        if (it_inj != injected_.end()) return it_inj->second;
+        if (it_inj != injected_.end()) return to_std(it_inj->second);
 
         return base_cache_ ? base_cache_->get(key) : std::nullopt;
     }
+    
+    NodeHandle get_shared(const NodeKey& key) override {
+        auto it = overlay_.find(key);
+        if (it != overlay_.end()) return std::make_shared<const Node>(to_std(it->second));
+        
+        auto it_inj = injected_.find(key);
+        if (it_inj != injected_.end()) return std::make_shared<const Node>(to_std(it_inj->second));
+        
+        return base_cache_ ? base_cache_->get_shared(key) : nullptr;
+    }
 
     void put(const NodeKey& key, const Node& node) override {
-        overlay_[key] = node;
+        auto [it, inserted] = overlay_.insert_or_assign(to_pmr(key, resource_), to_pmr(node, resource_));
+        if (inserted) charge(key, node);
+    }
+
+    void put_many(const std::vector<std::pair<NodeKey, Node>>& nodes) override {
+        for (const auto& [key, node] : nodes) put(key, node);
     }
 
     void clear() override {
         overlay_.clear();
         injected_.clear();
+        bytes_ = 0;
     }
     
     size_t size() const override {
         return overlay_.size() + injected_.size();
     }
+    
+    size_t approx_bytes() const noexcept override {
+        return bytes_;
+    }
+    
+    /// @brief Overlays hold uncommitted nodes and cannot be shrunk
+    size_t shrink_to_bytes(size_t) override {
+        return 0;
+    }
+};
+
+/// @brief Commit write buffer in front of the main cache (the adapter's tree_ uses it)
+///
+/// Between begin() and flush() the committing thread's node puts are
+/// collected without locking (with read-your-writes) and handed to the main
+/// cache by flush() in one put_many(). Every other thread, and the writer
+/// outside a commit, reads and writes the main cache directly, so readers
+/// never see a half-built version.
+class CommitBufferCache : public TreeCache {
+private:
+    TreeCache* base_cache_;
+    std::atomic<std::thread::id> writer_{};             // Buffering thread; none when idle
+    std::vector<std::pair<NodeKey, Node>> nodes_;      // Batch order (LRU order after flush)
+    std::unordered_map<NodeKey, size_t> position_;     // Key -> index in nodes_
+    
+    /// @brief Only the writer can match its own id, so relaxed suffices
+    [[nodiscard]] bool buffering() const noexcept {
+        return writer_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+public:
+    explicit CommitBufferCache(TreeCache* base) : TreeCache(0), base_cache_(base) {}
+    
+    /// @brief Follow a replaced main cache (not during a commit)
+    void rebind(TreeCache* base) noexcept { base_cache_ = base; }
+    
+    /// @brief Buffer this thread's puts until flush() or discard()
+    void begin() { writer_.store(std::this_thread::get_id(), std::memory_order_relaxed); }
+    
+    std::optional<Node> get(const NodeKey& key) override {
+        if (buffering()) {
+            auto it = position_.find(key);
+            if (it != position_.end()) return nodes_[it->second].second;
+        }
+        return base_cache_->get(key);
+    }
+    
+    NodeHandle get_shared(const NodeKey& key) override {
+        if (buffering()) {
+            auto it = position_.find(key);
+            if (it != position_.end()) return std::make_shared<const Node>(nodes_[it->second].second);
+        }
+        return base_cache_->get_shared(key);
+    }
+    
+    void put(const NodeKey& key, const Node& node) override {
+        if (!buffering()) {
+            base_cache_->put(key, node);
+            return;
+        }
+        auto [it, inserted] = position_.try_emplace(key, nodes_.size());
+        if (inserted) {
+            nodes_.emplace_back(key, node);
+        } else {
+            nodes_[it->second].second = node;
+        }
+    }
+    
+    void put_many(const std::vector<std::pair<NodeKey, Node>>& nodes) override {
+        if (!buffering()) {
+            base_cache_->put_many(nodes);
+            return;
+        }
+        for (const auto& [key, node] : nodes) put(key, node);
+    }
+    
+    /// @brief Drop buffered nodes (the main cache is untouched)
+    void clear() override {
+        nodes_.clear();
+        position_.clear();
+    }
+    
+    size_t size() const override {
+        return nodes_.size();
+    }
+    
+    /// @brief Buffered nodes are transient and cannot be shrunk
+    size_t shrink_to_bytes(size_t) override {
+        return 0;
+    }
+    
+    /// @brief Move the buffered nodes into the main cache (one lock per partition) and stop buffering
+    void flush() {
+        base_cache_->put_many(nodes_);
+        discard();
+    }
+    
+    /// @brief Abandon a failed commit: its nodes never reach the main cache
+    void discard() {
+        clear();
+        writer_.store(std::thread::id{}, std::memory_order_relaxed);
+    }
 };
 
 class XookAdapter {
 
 private:
     std::unique_ptr<TreeCache> cache_;
+    std::unique_ptr<CommitBufferCache> commit_cache_;  // tree_'s cache: cache_ plus the commit buffer
     std::unique_ptr<XookTree> tree_;
 
 
@@ -85,29 +241,582 @@ private:
         }
     };
     
+    /// @brief Reader over the in-process node store (no KVStore: tests, benchmarks)
+    class InMemoryReader : public TreeReader {
+    private:
+        NodeArenaStore* store_;
+    public:
+        explicit InMemoryReader(NodeArenaStore* store) : store_(store) {}
+
+        std::optional<glofica::Bytes> get_node_bytes(const NodeKey& key) override {
+            return store_->get(key);
+        }
+    };
+    
+    /// @brief Times every read of the wrapped reader (cache misses) into AdapterOp::StoreRead
+    class TimedReader : public TreeReader {
+    private:
+        std::shared_ptr<TreeReader> inner_;
+        LatencyHistogram& latency_;
+    public:
+        TimedReader(std::shared_ptr<TreeReader> inner, LatencyHistogram& latency)
+            : inner_(std::move(inner)), latency_(latency) {}
+        
+        std::optional<glofica::Bytes> get_node_bytes(const NodeKey& key) override {
+            LatencyTimer timer(latency_);
+            return inner_->get_node_bytes(key);
+        }
+    };
+    
     std::shared_ptr<TreeReader> reader_;
     
+    // Test mode (db == nullptr): committed nodes are kept here so cache
+    // evictions never lose them; retention_ enables pruning of old versions
+    std::unique_ptr<NodeArenaStore> node_store_;
+    std::optional<uint64_t> retention_;
+    
+    /// @brief Persist a committed batch in test mode (KVStore mode: the caller persists)
+    void persist_in_memory(const TreeUpdateBatch& result, uint64_t) {
+        if (!node_store_) return;
+        node_store_->put_batch(result.node_batch);
+    }
+    
+    // Versions held by live ReadSnapshots: retention pruning stops below the oldest
+    mutable std::mutex pins_mutex_;
+    mutable std::multiset<uint64_t> pinned_versions_;
+    
+    /// @brief Apply the retention window (test mode) once `version` is the head
+    void prune_in_memory(uint64_t version) {
+        if (!node_store_ || !retention_ || version <= *retention_) return;
+        uint64_t min_readable = version - *retention_;
+        {
+            std::lock_guard<std::mutex> lock(pins_mutex_);
+            if (!pinned_versions_.empty()) min_readable = std::min(min_readable, *pinned_versions_.begin());
+        }
+        node_store_->prune(min_readable);
+    }
+    
     // Pending updates accumulator
     std::unordered_map<glofica::Hash, glofica::Bytes, hash::HashPtr> pending_updates_;
-    uint64_t current_version_ = 0;
-    glofica::Hash last_root_{};
+    size_t pending_bytes_ = 0;
+    uint64_t current_version_ = 0;  // Writer thread only (latest version seen by put)
+    
+    /// @brief Last committed (root, version), published atomically for readers
+    struct CommittedHead {
+        glofica::Hash root;
+        uint64_t version;
+    };
+    
+    // MVCC: readers load head_ under an epoch guard; the writer swaps in a new
+    // head after each commit and retires the old one through epochs_
+    mutable EpochManager epochs_;
+    std::atomic<const CommittedHead*> head_{nullptr};
+    
+    // Commits of a version at or below the head (rollback recovery); snapshots
+    // of a rewritten version detect it through this counter
+    std::atomic<uint64_t> rewrites_{0};
+    
+    void publish_head(const glofica::Hash& root, uint64_t version) {
+        // Index first: readers that see the new head find its nodes lock-free
+        cache_->publish_committed(version);
+        const CommittedHead* old = head_.exchange(new CommittedHead{root, version}, std::memory_order_seq_cst);
+        if (old) epochs_.retire(old);
+        epochs_.reclaim();
+        prune_in_memory(version);
+        if (sizer_) sizer_->tick();
+    }
+    
+    // Changed-key subscribers (subscribe_changes), fed after each commit
+    ChangeFeed changes_;
+    
+    /// @brief Publish the committed keys to subscribers (after publish_head: a
+    /// subscriber reading get(key, version) sees the new version)
+    /// `jmt_updates` is the canonical batch the tree committed (sorted, one entry per key)
+    void publish_changes(
+        const std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>>& jmt_updates,
+        const glofica::Hash& root,
+        uint64_t version
+    ) {
+        if (!changes_.has_subscribers()) return;
+        auto batch = std::make_shared<ChangeBatch>();
+        batch->version = version;
+        batch->root = root;
+        batch->entries.reserve(jmt_updates.size());
+        for (const auto& [key_hash, value] : jmt_updates) {
+            // What the committed leaf holds (and get() returns): BLAKE3 of the
+            // value bytes; absent (deleted) -> zero hash
+            batch->entries.emplace_back(key_hash, value ? hash::blake3(*value) : glofica::Hash{});
+        }
+        changes_.publish(batch);
+    }
+    
+    /// @brief Commit through tree_ with its CommitBufferCache buffering: the
+    /// new nodes reach cache_ in one put_many() instead of one exclusive lock
+    /// per node, and whatever state tree_ keeps per version is its own
+    TreeUpdateBatch put_value_set_batched(
+        const std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>>& jmt_updates,
+        uint64_t version,
+        std::optional<glofica::Hash> base_root,
+        std::optional<uint64_t> base_version
+    ) {
+        // Before the tree changes: a snapshot reading this version concurrently must notice
+        if (version <= head_.load(std::memory_order_relaxed)->version) {
+            rewrites_.fetch_add(1, std::memory_order_seq_cst);
+        }
+        commit_cache_->begin();
+        TreeUpdateBatch result;
+        try {
+            result = tree_->put_value_set(jmt_updates, version, base_root, base_version);
+        } catch (...) {
+            commit_cache_->discard();
+            throw;
+        }
+        commit_cache_->flush();
+        return result;
+    }
+    
+    /// @brief The batch every commit path applies: pending put()s merged with the
+    /// commit's explicit updates, canonical (sorted, one entry per key)
+    /// Last-writer rule: pending put()s count as older than the explicit
+    /// updates, so a key written by both takes the explicit value; among
+    /// duplicate explicit updates the later one wins.
+    std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>> merge_pending(
+        std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>> explicit_updates
+    ) const {
+        if (pending_updates_.empty()) {
+            canonicalize_updates(explicit_updates);
+            return explicit_updates;
+        }
+        std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>> jmt_updates;
+        jmt_updates.reserve(pending_updates_.size() + explicit_updates.size());
+        for (const auto& [k, v] : pending_updates_) {
+            jmt_updates.emplace_back(k, v);
+        }
+        for (auto& update : explicit_updates) {
+            jmt_updates.push_back(std::move(update));
+        }
+        canonicalize_updates(jmt_updates);  // Stable: the explicit entry (later) wins
+        return jmt_updates;
+    }
+    
+    /// @brief merge_pending() for hashed updates (value hash stored as value bytes)
+    std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>> merge_pending(const HashedUpdates& updates) const {
+        std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>> jmt_updates;
+        jmt_updates.reserve(updates.size());
+        for (const auto& [key_hash, value_hash] : updates) {
+            jmt_updates.emplace_back(key_hash, glofica::Bytes(value_hash.begin(), value_hash.end()));
+        }
+        return merge_pending(std::move(jmt_updates));
+    }
+    
+    /// @brief Apply a merge_pending() batch, then clear pending updates and publish the head
+    /// The tree and the change feed see the same canonical batch
+    TreeUpdateBatch commit_updates(
+        const std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>>& jmt_updates,
+        const glofica::Hash& base_root,
+        uint64_t version,
+        std::optional<uint64_t> base_version
+    ) {
+        // If no updates, return base root
+        if (jmt_updates.empty()) {
+            TreeUpdateBatch empty;
+            empty.new_root_hash = base_root;
+            return empty;
+        }
+        
+        // CRITICAL: Apply batch to JMT (deterministic sorting happens here)
+        // Passes base_root and base_version to support correct speculative execution
+        auto result = put_value_set_batched(jmt_updates, version, base_root, base_version);
+        
+        // Clear pending updates
+        pending_updates_.clear();
+        pending_bytes_ = 0;
+        governor_->set_pending_bytes(0);
+        governor_->enforce();
+        current_version_ = version;
+        persist_in_memory(result, version);
+        publish_head(result.new_root_hash, version);
+        publish_changes(jmt_updates, result.new_root_hash, version);
+        
+        return result;
+    }
+    
+    /// @brief Value lookup shared by get() and ReadSnapshot::get()
+    std::optional<glofica::Hash> lookup(const glofica::Hash& key_hash, uint64_t version) const {
+        auto result = tree_->get(key_hash, version);
+        if (!result.has_value()) {
+            return std::nullopt;
+        }
+        
+        // Convert bytes back to Hash (Full 64B)
+        glofica::Hash value_hash;
+        if (result->size() >= 64) {
+            std::copy(result->begin(), result->begin() + 64, value_hash.begin());
+        } else {
+            std::fill(value_hash.begin(), value_hash.end(), 0);
+            std::copy(result->begin(), result->end(), value_hash.begin());
+        }
+        
+        return value_hash;
+    }
+    
+    // Unified byte budget (cache -> speculative overlays -> pending updates)
+    std::unique_ptr<MemoryGovernor> governor_;
+    
+    // Huge-page slab shared by the cache and speculative overlays (enable_huge_page_cache)
+    std::shared_ptr<HugePageSlabResource> slab_;
+    
+    // Cache eviction / supersede policies (re-applied when the cache is swapped)
+    EvictionPolicy eviction_policy_ = EvictionPolicy::LRU;
+    GreedyDualCost eviction_cost_;
+    SupersedePolicy supersede_policy_ = SupersedePolicy::Off;
+    
+    // Capacity controller (enable_adaptive_cache_sizing), ticked after each commit.
+    // The writer uses it unlocked; sizer_mutex_ orders replacement against stats().
+    std::unique_ptr<AdaptiveCacheSizer> sizer_;
+    mutable std::mutex sizer_mutex_;
+    
+    /// @brief Swap in a new cache (rebinds commit buffer and governor; budget and policy preserved)
+    /// The governor is kept, so memory_pressure_handler() callables, live
+    /// SpeculativeLeases, pending bytes and shrink counters stay valid.
+    void install_cache(std::unique_ptr<TreeCache> cache) {
+        std::unique_ptr<TreeCache> old = std::exchange(cache_, std::move(cache));
+        if (eviction_policy_ != EvictionPolicy::LRU) cache_->set_eviction_policy(eviction_policy_, eviction_cost_);
+        cache_->set_supersede_policy(supersede_policy_);
+        cache_->enable_thread_local_l1();
+        cache_->enable_committed_index();
+        commit_cache_->rebind(cache_.get());
+        governor_->set_cache(cache_.get());  // Before `old` is destroyed
+        if (sizer_) sizer_->rebind(cache_.get());
+    }
+    
+    // Approximate bytes per pending entry: map node + key + value vector header
+    static constexpr size_t PENDING_ENTRY_OVERHEAD =
+        32 + sizeof(glofica::Hash) + sizeof(glofica::Bytes);
+    
+    // Latency histograms (~227KB = 6 ops x 8 stripes x 592 buckets x 8B: heap-allocated to keep enclave stacks small;
+    // pointer indirection also lets const readers record)
+    std::unique_ptr<AdapterMetrics> metrics_ = std::make_unique<AdapterMetrics>();
     
 public:
     // Accepts pointer to global KVStore
     explicit XookAdapter(kv::KVStore* db = nullptr) {
-        // Use ExternalReader if DB provided, otherwise fallback to InMemory (test mode)
-        // If db is null (default), ExternalReader handles it by returning nullopt safely.
-        reader_ = std::make_shared<ExternalReader>(db);
+        // Use ExternalReader if DB provided, otherwise the in-process node store (test mode)
+        if (db) {
+            reader_ = std::make_shared<ExternalReader>(db);
+        } else {
+            node_store_ = std::make_unique<NodeArenaStore>();
+            reader_ = std::make_shared<InMemoryReader>(node_store_.get());
+        }
+        init();
+    }
+    
+    /// @brief Read nodes through a caller-supplied reader (e.g. ShardedNodeStore over M disks)
+    /// As with a KVStore, the caller persists each TreeUpdateBatch::node_batch.
+    explicit XookAdapter(std::shared_ptr<TreeReader> reader) : reader_(std::move(reader)) {
+        if (!reader_) throw std::invalid_argument("XookAdapter: null TreeReader");
+        init();
+    }
+    
+private:
+    void init() {
+        // Cache misses are timed (AdapterOp::StoreRead): miss cost for adaptive sizing
+        reader_ = std::make_shared<TimedReader>(std::move(reader_), metrics_->latency(AdapterOp::StoreRead));
         
-        // Configure cache (100K nodes)
+        // Configure cache (100K nodes; enable_adaptive_cache_sizing lets it move)
         cache_ = std::make_unique<TreeCache>(100000);
         
+        // Per-thread L1 for upper levels (RPC readers skip the cache mutex)
+        cache_->enable_thread_local_l1();
+        
+        // Committed nodes are immutable: serve them from the RCU index (L1 misses skip the mutex too)
+        cache_->enable_committed_index();
+        
+        // Supersede tracking is opt-in (set_cache_supersede_policy)
+        cache_->set_supersede_policy(supersede_policy_);
+        
+        commit_cache_ = std::make_unique<CommitBufferCache>(cache_.get());
         tree_ = std::make_unique<XookTree>(
             reader_.get(), 
-            cache_.get()
+            commit_cache_.get()
         );
         
-        last_root_.fill(0);
+        // Unlimited until the host sets a budget (set_memory_budget)
+        governor_ = std::make_unique<MemoryGovernor>(cache_.get());
+        
+        // Initialize with zero root
+        glofica::Hash zero_root;
+        zero_root.fill(0);
+        head_.store(new CommittedHead{zero_root, 0}, std::memory_order_release);
+    }
+    
+public:
+    /// @brief Outstanding ReadSnapshots must be destroyed before the adapter
+    ~XookAdapter() {
+        delete head_.load(std::memory_order_acquire);
+    }
+    
+    XookAdapter(const XookAdapter&) = delete;
+    XookAdapter& operator=(const XookAdapter&) = delete;
+    
+    // ===== MVCC READ SNAPSHOTS =====
+    
+    /// @brief Read view bound to one (root, version), stable across concurrent commits
+    ///
+    /// What keeps the view readable while the writer moves on:
+    /// - The head it was taken from is EBR-protected (epoch guard held for its lifetime).
+    /// - Nodes are shared_ptr handles: a cache eviction or a Drop supersede
+    ///   never frees a node a lookup is using, and a node no longer cached
+    ///   is re-read through the TreeReader.
+    /// - Its version is pinned: the in-memory store's retention pruning stops
+    ///   below the oldest pinned version (KVStore mode: callers that prune
+    ///   the store use oldest_pinned_version()).
+    /// - Lookups go by version; if that version is re-committed (rollback
+    ///   recovery) with a different root, get() throws instead of mixing trees.
+    ///
+    /// Locking: taking a snapshot locks pins_mutex_ for an O(log n) insert
+    /// (the writer holds it only to read the oldest pin). Lookups that hit
+    /// the thread-local L1 or the committed-node index take no lock; other
+    /// lookups take TreeCache's mutex like any cache read.
+    ///
+    /// CRITICAL: Nodes of committed versions are immutable, so reading
+    /// `version` while the writer commits `version + 1` is safe provided
+    /// XookTree::get only reads (never rewrites) existing NodeKeys.
+    class ReadSnapshot {
+    private:
+        const XookAdapter* adapter_;
+        EpochManager::Guard guard_;
+        glofica::Hash root_;
+        uint64_t version_;
+        uint64_t rewrites_;
+        
+        void unpin() noexcept {
+            if (!adapter_) return;
+            std::lock_guard<std::mutex> lock(adapter_->pins_mutex_);
+            adapter_->pinned_versions_.erase(adapter_->pinned_versions_.find(version_));
+            adapter_ = nullptr;
+        }
+        
+    public:
+        /// @brief Takes over a pin already registered for `version`
+        ReadSnapshot(const XookAdapter* adapter, EpochManager::Guard guard,
+                     const glofica::Hash& root, uint64_t version, uint64_t rewrites)
+            : adapter_(adapter), guard_(std::move(guard)), root_(root), version_(version), rewrites_(rewrites) {}
+        
+        ReadSnapshot(ReadSnapshot&& other) noexcept
+            : adapter_(std::exchange(other.adapter_, nullptr)), guard_(std::move(other.guard_)),
+              root_(other.root_), version_(other.version_), rewrites_(other.rewrites_) {}
+        
+        ReadSnapshot& operator=(ReadSnapshot&& other) noexcept {
+            if (this != &other) {
+                unpin();
+                adapter_ = std::exchange(other.adapter_, nullptr);
+                guard_ = std::move(other.guard_);
+                root_ = other.root_;
+                version_ = other.version_;
+                rewrites_ = other.rewrites_;
+            }
+            return *this;
+        }
+        
+        ReadSnapshot(const ReadSnapshot&) = delete;
+        ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+        
+        ~ReadSnapshot() { unpin(); }
+        
+        [[nodiscard]] const glofica::Hash& root() const noexcept { return root_; }
+        [[nodiscard]] uint64_t version() const noexcept { return version_; }
+        
+        /// @brief Value at key as of this snapshot's (root, version)
+        /// @throws std::runtime_error if the version was re-committed with another root
+        std::optional<glofica::Hash> get(const glofica::Bytes& key) const {
+            LatencyTimer timer(adapter_->metrics_->latency(AdapterOp::Get));
+            auto value = adapter_->lookup(hash::blake3(key), version_);
+            // Checked after the read: a rewrite that overlapped it is caught too
+            if (adapter_->rewrites_.load(std::memory_order_seq_cst) != rewrites_ &&
+                adapter_->tree_->get_root_hash(version_) != root_) {
+                throw std::runtime_error("ReadSnapshot: version re-committed with a different root");
+            }
+            return value;
+        }
+    };
+    
+    /// @brief Snapshot of the latest committed version
+    [[nodiscard]] ReadSnapshot snapshot() const {
+        auto guard = epochs_.pin();
+        uint64_t rewrites = rewrites_.load(std::memory_order_seq_cst);
+        std::lock_guard<std::mutex> lock(pins_mutex_);
+        const CommittedHead* head = head_.load(std::memory_order_seq_cst);
+        pinned_versions_.insert(head->version);
+        return ReadSnapshot(this, std::move(guard), head->root, head->version, rewrites);
+    }
+    
+    /// @brief Snapshot of a historical version
+    /// Pinned from here on; a version already outside the retention window stays unreadable.
+    [[nodiscard]] ReadSnapshot snapshot_at(uint64_t version) const {
+        auto guard = epochs_.pin();
+        uint64_t rewrites = rewrites_.load(std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(pins_mutex_);
+            pinned_versions_.insert(version);
+        }
+        const CommittedHead* head = head_.load(std::memory_order_seq_cst);
+        glofica::Hash root = head->version == version ? head->root : tree_->get_root_hash(version);
+        return ReadSnapshot(this, std::move(guard), root, version, rewrites);
+    }
+    
+    /// @brief Oldest version a live ReadSnapshot reads (KVStore pruning must keep it)
+    [[nodiscard]] std::optional<uint64_t> oldest_pinned_version() const {
+        std::lock_guard<std::mutex> lock(pins_mutex_);
+        if (pinned_versions_.empty()) return std::nullopt;
+        return *pinned_versions_.begin();
+    }
+    
+    // ===== NUMA =====
+    
+    /// @brief Switch to a NumaTreeCache (per-socket top-level replicas + homed shards)
+    /// CRITICAL: Call right after construction, before any put/commit or snapshot
+    /// @param pinned_depth Levels replicated on every NUMA node
+    void enable_numa_cache(size_t pinned_depth = 3) {
+        if (dynamic_cast<NumaTreeCache*>(cache_.get())) return;
+        install_cache(std::make_unique<NumaTreeCache>(cache_->capacity(), pinned_depth));
+    }
+    
+    /// @brief Back cached nodes, map entries and speculative overlays with 2MB pages
+    /// CRITICAL: Call right after construction, before any put/commit or snapshot.
+    /// Falls back to transparent huge pages, then regular pages, transparently.
+    void enable_huge_page_cache() {
+        if (slab_) return;
+        slab_ = std::make_shared<HugePageSlabResource>();
+        if (dynamic_cast<NumaTreeCache*>(cache_.get())) return;  // Already node-local huge-page slabs
+        install_cache(std::make_unique<TreeCache>(cache_->capacity(), slab_));
+    }
+    
+    // ===== EVICTION POLICY =====
+    
+    /// @brief Cost-aware eviction (GreedyDual) or plain LRU for the node cache
+    /// GreedyDual trades an O(log n) priority update per cache hit for fewer
+    /// KVStore reads under memory pressure (see benchmark_cache_eviction).
+    void set_cache_eviction_policy(EvictionPolicy policy, GreedyDualCost cost = {}) {
+        eviction_policy_ = policy;
+        eviction_cost_ = cost;
+        cache_->set_eviction_policy(policy, cost);
+    }
+    
+    /// @brief Demote, drop or keep (Off, the default) nodes superseded by a newer committed version
+    /// Demote suits head-only readers; Drop only when nothing reads older versions (no historical get() / old snapshots):
+    /// dropped nodes must be re-read from the store.
+    void set_cache_supersede_policy(SupersedePolicy policy) {
+        supersede_policy_ = policy;
+        cache_->set_supersede_policy(policy);
+    }
+    
+    // ===== COLD TIER =====
+    
+    /// @brief Keep nodes evicted from the decoded cache as compact bytes (TieredTreeCache)
+    /// CRITICAL: Call right after construction (after enable_huge_page_cache, if used),
+    /// before any put/commit or snapshot. Not combined with the NUMA cache.
+    /// @param cold_budget_bytes Cold tier budget; counted by the memory governor
+    void enable_cold_tier(size_t cold_budget_bytes, ColdCodec codec = ColdCodec::Compact) {
+        if (auto* tiered = dynamic_cast<TieredTreeCache*>(cache_.get())) {
+            tiered->cold().set_budget(cold_budget_bytes);
+            return;
+        }
+        if (dynamic_cast<NumaTreeCache*>(cache_.get())) return;
+        install_cache(std::make_unique<TieredTreeCache>(cache_->capacity(), cold_budget_bytes, codec, slab_));
+    }
+    
+    /// @brief Let cache capacity follow the workload within [min, max]
+    /// Grows while recently evicted nodes keep being re-read at a cost worth
+    /// the memory, shrinks when idle; decisions appear in stats().cache_sizing.
+    void enable_adaptive_cache_sizing(AdaptiveSizingConfig config = {}) {
+        auto sizer = std::make_unique<AdaptiveCacheSizer>(cache_.get(), &metrics_->latency(AdapterOp::StoreRead), config);
+        std::lock_guard<std::mutex> lock(sizer_mutex_);
+        sizer_ = std::move(sizer);
+    }
+    
+    /// @brief Back to a fixed capacity (the current one); ghosts off
+    void disable_adaptive_cache_sizing() {
+        {
+            std::lock_guard<std::mutex> lock(sizer_mutex_);
+            sizer_.reset();
+        }
+        cache_->set_ghost_capacity(0);
+    }
+    
+    // ===== CHANGE NOTIFICATIONS =====
+    
+    /// @brief Receive the keys each committed version changed, instead of polling get()
+    /// Called on the writer thread right after the version becomes readable;
+    /// keep the callback short (queue notification.batch for another thread).
+    /// @return Id for unsubscribe_changes() (any thread)
+    uint64_t subscribe_changes(ChangeFilter filter, ChangeFeed::Callback callback) {
+        return changes_.subscribe(std::move(filter), std::move(callback));
+    }
+    
+    bool unsubscribe_changes(uint64_t id) {
+        return changes_.unsubscribe(id);
+    }
+    
+    // ===== IN-MEMORY NODE STORE (db == nullptr) =====
+    
+    /// @brief Node store backing test mode (nullptr when a KVStore is attached)
+    [[nodiscard]] NodeArenaStore* in_memory_store() noexcept { return node_store_.get(); }
+    
+    /// @brief Keep only the last `versions` versions readable in test mode (nullopt = keep all)
+    /// Versions held by live ReadSnapshots stay readable; plain get() older than
+    /// the window may find nodes missing.
+    void set_in_memory_retention(std::optional<uint64_t> versions) {
+        retention_ = versions;
+        if (node_store_ && retention_) node_store_->enable_stale_tracking();
+    }
+    
+    // ===== MEMORY GOVERNANCE =====
+    
+    /// @brief Set total byte budget for cache + speculative overlays + pending updates
+    /// @param budget_bytes Total budget (e.g. usable EPC minus enclave heap reserve)
+    void set_memory_budget(size_t budget_bytes) {
+        governor_->set_budget(budget_bytes);
+    }
+    
+    /// @brief Current memory usage per structure
+    MemoryUsage memory_usage() const {
+        return governor_->usage();
+    }
+    
+    /// @brief Callback for the host's pressure hook: shrink to a total byte target
+    /// @return Callable(target_total_bytes) -> bytes released
+    std::function<size_t(size_t)> memory_pressure_handler() {
+        return governor_->shrink_handler();
+    }
+    
+    // ===== METRICS =====
+    
+    /// @brief Pull-based metrics snapshot (histograms merged across threads)
+    /// Use stats().to_prometheus() for a scrape endpoint.
+    AdapterStats stats() const {
+        AdapterStats s;
+        for (size_t i = 0; i < ADAPTER_OP_COUNT; ++i) {
+            s.latency[i] = metrics_->latency(static_cast<AdapterOp>(i)).snapshot();
+        }
+        s.memory = governor_->usage();
+        s.memory_budget_bytes = governor_->budget();
+        s.cache_entries = cache_->size();
+        s.cache_capacity = cache_->capacity();
+        s.cache_shrinks = governor_->cache_shrinks();
+        s.cache_feedback = cache_->feedback();
+        {
+            std::lock_guard<std::mutex> lock(sizer_mutex_);
+            if (sizer_) s.cache_sizing = sizer_->stats();
+        }
+        s.changes = changes_.stats();
+        s.speculative_backpressure_waits = governor_->backpressure_waits();
+        return s;
+    }
+    
+    /// @brief Reset latency histograms (e.g. after warm-up)
+    void reset_stats() {
+        metrics_->reset();
     }
     
     // ===== LEGACY API IMPLEMENTATION =====
@@ -117,26 +826,43 @@ public:
     /// @param value_hash Hash of the account value
     /// @param version Version number (tracked but batched later)
     void put(const glofica::Bytes& key, const glofica::Hash& value_hash, uint64_t version) {
+        LatencyTimer timer(metrics_->latency(AdapterOp::Put));
+        
         // FIXED: Use BLAKE3-512 for deterministic key hashing (Story 22.1)
         // Manual splicing was non-deterministic for 33-byte keys
         glofica::Hash key_hash = hash::blake3(key);
         
         // Store value_hash as bytes (JMT stores values, not hashes)
         glofica::Bytes value_bytes(value_hash.begin(), value_hash.end());
-        pending_updates_[key_hash] = value_bytes;
+        auto [it, inserted] = pending_updates_.insert_or_assign(key_hash, std::move(value_bytes));
+        if (inserted) {
+            pending_bytes_ += PENDING_ENTRY_OVERHEAD + it->second.capacity();
+            governor_->set_pending_bytes(pending_bytes_);
+            governor_->enforce();
+        }
         current_version_ = version;
     }
     
     /// @brief Calculate root purely speculatively (no cache pollution)
+    /// @param transient Resource for the overlay (nodes, keys, map entries), e.g. a
+    ///        BlockArena reset after the block; nullptr = huge-page slab / heap
     TreeUpdateBatch calculate_root_speculative(
         const std::vector<std::pair<glofica::Bytes, glofica::Hash>>& updates,
         const glofica::Hash& base_root,
         uint64_t version,
         std::optional<uint64_t> base_version = std::nullopt,
-        const std::vector<std::pair<glofica::Bytes, glofica::Bytes>>* parent_nodes = nullptr
+        const std::vector<std::pair<glofica::Bytes, glofica::Bytes>>* parent_nodes = nullptr,
+        std::pmr::memory_resource* transient = nullptr
     ) {
-         // Speculative cache
-         SpeculativeTreeCache spec_cache(cache_.get());
+         LatencyTimer timer(metrics_->latency(AdapterOp::CalculateRootSpeculative));
+         
+         // Backpressure: waits while other sessions hold the budget
+         auto lease = governor_->admit_speculative();
+         
+         // Speculative cache (overlay charged to the lease)
+         std::pmr::memory_resource* overlay_resource = transient ? transient
+             : slab_ ? static_cast<std::pmr::memory_resource*>(slab_.get()) : std::pmr::get_default_resource();
+         SpeculativeTreeCache spec_cache(cache_.get(), &lease, overlay_resource);
          
          // Inject parent speculative nodes (if any)
          if (parent_nodes) {
@@ -176,77 +902,70 @@ public:
         uint64_t version,
         std::optional<uint64_t> base_version = std::nullopt
     ) {
-        // Merge explicit updates with pending updates
-        std::vector<std::pair<glofica::Hash, glofica::Bytes>> batch;
-        batch.reserve(updates.size() + pending_updates_.size());
+        LatencyTimer timer(metrics_->latency(AdapterOp::CalculateRoot));
         
-        // Add explicit updates
+        // Explicit updates straight into the optional format (no deletions in
+        // this path), then merged with pending updates (explicit wins)
+        std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>> jmt_updates;
+        jmt_updates.reserve(updates.size());
         for (const auto& [key, value_hash] : updates) {
             // FIXED: Use BLAKE3-512 (Story 22.1)
             glofica::Hash key_hash = hash::blake3(key);
-            glofica::Bytes value_bytes(value_hash.begin(), value_hash.end());
-            batch.emplace_back(key_hash, value_bytes);
-        }
-        
-        // Add pending updates
-        for (const auto& [k, v] : pending_updates_) {
-            batch.emplace_back(k, v);
-        }
-        
-        // If no updates, return base root
-        if (batch.empty()) {
-            TreeUpdateBatch empty;
-            empty.new_root_hash = base_root;
-            return empty;
+            jmt_updates.emplace_back(key_hash, glofica::Bytes(value_hash.begin(), value_hash.end()));
         }
         
-        // Convert to optional format (no deletions in this path)
-        std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>> jmt_updates;
-        jmt_updates.reserve(batch.size());
-        for (const auto& [k, v] : batch) {
-            jmt_updates.emplace_back(k, v);
-        }
-        
-        // CRITICAL: Apply batch to JMT (deterministic sorting happens here)
-        // Passes base_root and base_version to support correct speculative execution
-        auto result = tree_->put_value_set(jmt_updates, version, base_root, base_version);
-        
-        // Clear pending updates
-        pending_updates_.clear();
-        current_version_ = version;
-        last_root_ = result.new_root_hash;
-        
-        return result;
+        return commit_updates(merge_pending(std::move(jmt_updates)), base_root, version, base_version);
+    }
+    
+    /// @brief Commit partial update sets merged by OrderedUpdateSets::resolve()
+    /// Keys arrive hashed (by the producers). Pending put()s count as older
+    /// than every set (merge_pending(), as in every commit path).
+    /// Only hashing and the merge ran in parallel: the tree update itself is
+    /// one serial put_value_set() over the merged batch, as in calculate_root().
+    /// For concurrent application use ShardedXookState (a different root, see there).
+    /// CRITICAL: Same root as calculate_root() over the sets applied serially in order
+    TreeUpdateBatch calculate_root(
+        const ResolvedUpdates& resolved,
+        const glofica::Hash& base_root,
+        uint64_t version,
+        std::optional<uint64_t> base_version = std::nullopt
+    ) {
+        LatencyTimer timer(metrics_->latency(AdapterOp::CalculateRoot));
+        return commit_updates(merge_pending(resolved.updates), base_root, version, base_version);
+    }
+    
+    /// @brief Commit pre-hashed updates sorted by key hash (one entry per key)
+    /// Used per shard by ShardedXookState; pending put()s lose to `updates` (merge_pending()).
+    TreeUpdateBatch calculate_root_hashed(
+        const HashedUpdates& updates,
+        const glofica::Hash& base_root,
+        uint64_t version,
+        std::optional<uint64_t> base_version = std::nullopt
+    ) {
+        LatencyTimer timer(metrics_->latency(AdapterOp::CalculateRoot));
+        return commit_updates(merge_pending(updates), base_root, version, base_version);
     }
     
-    /// @brief Get root hash at specific version
+    /// @brief Get root hash at specific version (safe from any thread)
     glofica::Hash get_root_hash(uint64_t version) const {
-        if (version == current_version_) {
-            return last_root_;
+        {
+            auto guard = epochs_.pin();
+            const CommittedHead* head = head_.load(std::memory_order_seq_cst);
+            if (version == head->version) {
+                return head->root;
+            }
         }
         return tree_->get_root_hash(version);
     }
     
     /// @brief Get value at specific key and version
     std::optional<glofica::Hash> get(const glofica::Bytes& key, uint64_t version) const {
+        LatencyTimer timer(metrics_->latency(AdapterOp::Get));
+        
         // FIXED: Use BLAKE3-512 for deterministic key hashing (Story 22.1)
         glofica::Hash key_hash = hash::blake3(key);
         
-        auto result = tree_->get(key_hash, version);
-        if (!result.has_value()) {
-            return std::nullopt;
-        }
-        
-        // Convert bytes back to Hash (Full 64B)
-        glofica::Hash value_hash;
-        if (result->size() >= 64) {
-            std::copy(result->begin(), result->begin() + 64, value_hash.begin());
-        } else {
-            std::fill(value_hash.begin(), value_hash.end(), 0);
-            std::copy(result->begin(), result->end(), value_hash.begin());
-        }
-        
-        return value_hash;
+        return lookup(key_hash, version);
     }
 
     /// @brief Batch update with precomputed hashes (legacy optimization path)
@@ -256,6 +975,8 @@ public:
         std::optional<glofica::Hash> base_root = std::nullopt,
         std::optional<uint64_t> base_version = std::nullopt
     ) {
+        LatencyTimer timer(metrics_->latency(AdapterOp::UpdateBatchPrecomputed));
+        
         // Convert to JMT format and apply
         std::vector<std::pair<glofica::Hash, std::optional<glofica::Bytes>>> jmt_updates;
         jmt_updates.reserve(updates.size());
@@ -268,11 +989,15 @@ public:
             glofica::Bytes value_bytes(value_hash.begin(), value_hash.end());
             jmt_updates.emplace_back(key_hash, value_bytes);
         }
+        canonicalize_updates(jmt_updates);  // Committed and published alike
         
         // Apply batch (Fixed: pass base_root and base_version to support rollback recovery)
-        auto result = tree_->put_value_set(jmt_updates, version, base_root, base_version);
-        last_root_ = result.new_root_hash;
+        auto result = put_value_set_batched(jmt_updates, version, base_root, base_version);
+        governor_->enforce();
         current_version_ = version;
+        persist_in_memory(result, version);
+        publish_head(result.new_root_hash, version);
+        publish_changes(jmt_updates, result.new_root_hash, version);
         return result;
     }
     
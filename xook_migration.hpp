@@ -0,0 +1,706 @@
+// =========================================================
+// FILE: src/xook/xook_migration.hpp
+// PURPOSE: Streaming, parallel, resumable migration of account state into XOOK
+// CRITICAL: Produces exactly the nodes XookTree::put_value_set would write
+//           for the same leaves at one version, without replaying history
+// =========================================================
+
+#pragma once
+
+#include "node_serde.hpp"
+#include "../common/hash.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace glofica::xook {
+
+/// @brief One account as the legacy state knows it (pre-hash key bytes)
+struct MigrationRecord {
+    glofica::Bytes key;          // Original account key (XookAdapter hashes it)
+    glofica::Hash value_hash;    // Full 64-byte value hash, as passed to XookAdapter::put
+};
+
+/// @brief Resumable record stream
+///
+/// CRITICAL: XMTLegacyAdapter's JMT leaves hold 32-byte truncated or
+/// zero-padded keys and 32-byte value hashes, so neither the account key
+/// preimage nor the 64-byte value hash can be recovered from them. The
+/// source must iterate the account store the legacy tree was fed from,
+/// in a deterministic order so that `cursor` can seek.
+class MigrationSource {
+public:
+    virtual ~MigrationSource() = default;
+
+    /// @brief Append up to `max` records starting at absolute record offset `cursor`
+    /// @return Number of records appended (0 = end of state)
+    virtual size_t read(uint64_t cursor, size_t max, std::vector<MigrationRecord>& out) = 0;
+};
+
+/// @brief Destination for migrated nodes (e.g. a KVStore write batch)
+///
+/// Bytes are serialize_node_with_prefix() output, stored under
+/// NodeKey::serialize(), the layout XookAdapter's ExternalReader reads.
+/// CRITICAL: Called concurrently from build workers; writes are idempotent
+/// (a resumed bucket rewrites identical nodes).
+class MigrationNodeWriter {
+public:
+    virtual ~MigrationNodeWriter() = default;
+    virtual void write_batch(const std::vector<std::pair<NodeKey, glofica::Bytes>>& nodes) = 0;
+};
+
+/// @brief Outcome of a migration run
+struct MigrationReport {
+    uint64_t records_read = 0;      // Records consumed from the source (all runs)
+    uint64_t unique_leaves = 0;     // After last-write-wins dedupe (this run's buckets)
+    uint64_t internal_nodes = 0;    // Written by this run
+    uint64_t leaf_nodes = 0;        // Written by this run
+    uint64_t buckets_resumed = 0;   // Buckets skipped thanks to the checkpoint
+    std::optional<glofica::Hash> root;  // nullopt = empty state
+    std::chrono::nanoseconds elapsed{0};
+};
+
+/// @brief Legacy state → XOOK bulk loader
+///
+/// Pipeline:
+/// 1. Partition: stream records in chunks, re-key in parallel
+///    (blake3(key), leaf value hash) and append to 256 spill files keyed by
+///    the first key byte. Each chunk is written out before the next is read,
+///    so memory is bounded by one chunk (chunk_records x 136 bytes, ~9MB at
+///    the default); checkpoints only fsync the spills and the manifest.
+/// 2. Build: workers take one bucket at a time, radix-sort it (bucket file =
+///    byte 0, counting sort on byte 1, comparison sort within), dedupe
+///    (last record wins) and bulk-load its subtree bottom-up with an
+///    iterative stack (TEE-safe, no recursion; depth ≤ 128 nibbles).
+/// 3. Combine: 16 depth-1 nodes and the root from the bucket results.
+///
+/// Tree shape follows XookTree: an internal node exists at every prefix
+/// shared by at least two keys (no path compression), and a leaf sits at the
+/// shortest prefix unique to its key. Every node is stamped with one version.
+///
+/// Checkpoint: `work_dir/manifest` records the source cursor with the spill
+/// file lengths, then each finished bucket's subtree. Spills are fsynced
+/// before the manifest that counts them, and the manifest is fsynced before
+/// it replaces the previous one. Restarting with the same
+/// work_dir truncates spills to the last checkpoint and skips finished
+/// buckets; a completed migration returns its root immediately.
+class XookMigrator {
+public:
+    struct Options {
+        std::filesystem::path work_dir;               // Spill files + manifest
+        uint64_t version = 0;                         // Version stamped on every node
+        size_t threads = 0;                           // 0 = hardware_concurrency
+        size_t chunk_records = size_t{1} << 16;       // Source read / re-key unit
+        uint64_t checkpoint_records = uint64_t{1} << 22;  // Partition checkpoint (fsync) interval
+        size_t write_batch_nodes = 4096;              // Nodes per write_batch() call
+        bool keep_spill_files = false;                // Delete spills after success
+    };
+
+    static constexpr size_t BUCKETS = 256;              // One per first key byte
+    static constexpr size_t BUCKET_DEPTH = 2;           // Nibbles fixed by the bucket
+    static constexpr size_t MAX_DEPTH = 128;            // 64-byte key = 128 nibbles
+    static constexpr size_t SPILL_RECORD_SIZE = 64 + 64 + 8;
+
+    /// @brief XookTree stores hash(value bytes) in the leaf; the value is the adapter's value hash
+    [[nodiscard]] static glofica::Hash leaf_value_hash(const glofica::Hash& value_hash) {
+        return hash::blake3(glofica::Bytes(value_hash.begin(), value_hash.end()));
+    }
+
+private:
+    struct SpillRecord {
+        glofica::Hash key_hash;
+        glofica::Hash leaf_value;
+        uint64_t seq;  // Source offset: later records win
+    };
+
+    /// @brief A finished subtree; a lone leaf is not written until its final depth is known
+    struct Subtree {
+        enum class Kind : uint8_t { Empty, Leaf, Internal };
+        Kind kind = Kind::Empty;
+        glofica::Hash hash{};
+        LeafNode leaf{};
+
+        [[nodiscard]] glofica::Hash child_hash() const { return kind == Kind::Leaf ? leaf.hash() : hash; }
+    };
+
+    /// @brief Per-worker node batching + counters
+    class Emitter {
+    private:
+        MigrationNodeWriter* writer_;
+        size_t batch_limit_;
+        std::vector<std::pair<NodeKey, glofica::Bytes>> batch_;
+
+    public:
+        uint64_t internal_nodes = 0;
+        uint64_t leaf_nodes = 0;
+
+        Emitter(MigrationNodeWriter* writer, size_t batch_limit)
+            : writer_(writer), batch_limit_(std::max<size_t>(1, batch_limit)) {
+            batch_.reserve(batch_limit_);
+        }
+
+        void emit(NodeKey key, const Node& node) {
+            if (std::holds_alternative<InternalNode>(node)) {
+                ++internal_nodes;
+            } else {
+                ++leaf_nodes;
+            }
+            batch_.emplace_back(std::move(key), serialize_node_with_prefix(node));
+            if (batch_.size() >= batch_limit_) flush();
+        }
+
+        void flush() {
+            if (batch_.empty()) return;
+            writer_->write_batch(batch_);
+            batch_.clear();
+        }
+    };
+
+    struct Manifest {
+        uint64_t cursor = 0;
+        bool partitioned = false;
+        std::array<uint64_t, BUCKETS> spill_bytes{};
+        std::array<std::optional<Subtree>, BUCKETS> buckets;
+        std::optional<Subtree> root;
+    };
+
+    MigrationSource* source_;
+    MigrationNodeWriter* writer_;
+    Options options_;
+    Manifest manifest_;
+    std::mutex manifest_mutex_;
+
+    // ===== Key / path helpers =====
+
+    [[nodiscard]] static uint8_t nibble_at(const glofica::Hash& key, size_t index) {
+        uint8_t byte = key[index / 2];
+        return (index % 2 == 0) ? (byte >> 4) : (byte & 0x0F);
+    }
+
+    /// @brief Common prefix length in nibbles
+    [[nodiscard]] static size_t common_nibbles(const glofica::Hash& a, const glofica::Hash& b) {
+        size_t i = 0;
+        while (i < a.size() && a[i] == b[i]) ++i;
+        if (i == a.size()) return MAX_DEPTH;
+        return i * 2 + ((a[i] >> 4) == (b[i] >> 4) ? 1 : 0);
+    }
+
+    [[nodiscard]] static NibblePath path_of(const glofica::Hash& key, size_t nibbles) {
+        NibblePath path;
+        for (size_t i = 0; i < nibbles; ++i) path.push(nibble_at(key, i));
+        return path;
+    }
+
+    // ===== Manifest (text, replaced atomically) =====
+
+    static std::string to_hex(const glofica::Hash& h) {
+        static constexpr char DIGITS[] = "0123456789abcdef";
+        std::string out;
+        out.reserve(h.size() * 2);
+        for (uint8_t b : h) {
+            out.push_back(DIGITS[b >> 4]);
+            out.push_back(DIGITS[b & 0x0F]);
+        }
+        return out;
+    }
+
+    static bool from_hex(const std::string& text, glofica::Hash& out) {
+        if (text.size() != out.size() * 2) return false;
+        auto digit = [](char c) -> int {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            return -1;
+        };
+        for (size_t i = 0; i < out.size(); ++i) {
+            int hi = digit(text[2 * i]), lo = digit(text[2 * i + 1]);
+            if (hi < 0 || lo < 0) return false;
+            out[i] = static_cast<uint8_t>((hi << 4) | lo);
+        }
+        return true;
+    }
+
+    static void write_subtree(std::ostream& out, const Subtree& s) {
+        switch (s.kind) {
+            case Subtree::Kind::Empty:    out << "empty"; break;
+            case Subtree::Kind::Internal: out << "internal " << to_hex(s.hash); break;
+            case Subtree::Kind::Leaf:     out << "leaf " << to_hex(s.leaf.account_key) << ' ' << to_hex(s.leaf.value_hash); break;
+        }
+    }
+
+    static std::optional<Subtree> read_subtree(std::istream& in) {
+        std::string kind, a, b;
+        in >> kind;
+        Subtree s;
+        if (kind == "empty") return s;
+        if (kind == "internal" && (in >> a) && from_hex(a, s.hash)) {
+            s.kind = Subtree::Kind::Internal;
+            return s;
+        }
+        if (kind == "leaf" && (in >> a >> b) && from_hex(a, s.leaf.account_key) && from_hex(b, s.leaf.value_hash)) {
+            s.kind = Subtree::Kind::Leaf;
+            return s;
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::filesystem::path manifest_path() const { return options_.work_dir / "manifest"; }
+
+    [[nodiscard]] std::filesystem::path spill_path(size_t bucket) const {
+        std::ostringstream name;
+        name << "bucket_" << std::hex << (bucket >> 4) << (bucket & 0x0F) << ".spill";
+        return options_.work_dir / name.str();
+    }
+
+    /// @brief fsync a file (or, for a directory, its entries); no-op where unsupported
+    static void sync_path(const std::filesystem::path& path) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("XookMigrator: cannot open " + path.string() + " to sync");
+        int rc = ::fsync(fd);
+        ::close(fd);
+        if (rc != 0) throw std::runtime_error("XookMigrator: fsync failed on " + path.string());
+#else
+        (void)path;
+#endif
+    }
+
+    /// @brief Persist manifest_ (caller holds manifest_mutex_ or is single-threaded)
+    /// Write-sync-rename-sync: after a crash the manifest is the old or the new one, never torn.
+    void save_manifest() {
+        auto tmp = manifest_path();
+        tmp += ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            out << "xook-migration 1\n";
+            out << "version " << options_.version << '\n';
+            out << "cursor " << manifest_.cursor << '\n';
+            out << "partitioned " << (manifest_.partitioned ? 1 : 0) << '\n';
+            out << "spill";
+            for (uint64_t len : manifest_.spill_bytes) out << ' ' << len;
+            out << '\n';
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                if (!manifest_.buckets[i]) continue;
+                out << "bucket " << i << ' ';
+                write_subtree(out, *manifest_.buckets[i]);
+                out << '\n';
+            }
+            if (manifest_.root) {
+                out << "root ";
+                write_subtree(out, *manifest_.root);
+                out << '\n';
+            }
+            out.flush();
+            if (!out) throw std::runtime_error("XookMigrator: failed to write " + tmp.string());
+        }
+        sync_path(tmp);
+        std::filesystem::rename(tmp, manifest_path());
+        sync_path(options_.work_dir);
+    }
+
+    /// @brief Load an existing manifest; a missing one starts a fresh migration
+    void load_manifest() {
+        std::ifstream in(manifest_path());
+        if (!in) return;
+
+        std::string tag;
+        uint64_t format = 0, version = 0;
+        if (!(in >> tag >> format) || tag != "xook-migration" || format != 1) {
+            throw std::runtime_error("XookMigrator: unrecognized manifest in " + options_.work_dir.string());
+        }
+        while (in >> tag) {
+            if (tag == "version") {
+                in >> version;
+                if (version != options_.version) {
+                    throw std::runtime_error("XookMigrator: work_dir belongs to a migration at another version");
+                }
+            } else if (tag == "cursor") {
+                in >> manifest_.cursor;
+            } else if (tag == "partitioned") {
+                int flag = 0;
+                in >> flag;
+                manifest_.partitioned = flag != 0;
+            } else if (tag == "spill") {
+                for (auto& len : manifest_.spill_bytes) in >> len;
+            } else if (tag == "bucket") {
+                size_t index = BUCKETS;
+                in >> index;
+                auto subtree = read_subtree(in);
+                if (index >= BUCKETS || !subtree) throw std::runtime_error("XookMigrator: corrupt manifest bucket entry");
+                manifest_.buckets[index] = subtree;
+            } else if (tag == "root") {
+                manifest_.root = read_subtree(in);
+                if (!manifest_.root) throw std::runtime_error("XookMigrator: corrupt manifest root entry");
+            } else {
+                throw std::runtime_error("XookMigrator: unknown manifest entry '" + tag + "'");
+            }
+        }
+    }
+
+    [[nodiscard]] size_t thread_count() const {
+        size_t threads = options_.threads != 0
+            ? options_.threads
+            : std::max<size_t>(1, std::thread::hardware_concurrency());
+        return std::max<size_t>(1, threads);
+    }
+
+    /// @brief Run fn(i) for i in [0, count) on the worker pool; rethrows the first failure
+    template <typename Fn>
+    void parallel_for(size_t count, Fn&& fn) {
+        size_t threads = std::min(thread_count(), count);
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        std::atomic<size_t> next{0};
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+        auto worker = [&] {
+            try {
+                for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                if (!failure) failure = std::current_exception();
+                next.store(count);  // Drain other workers
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& th : pool) th.join();
+        if (failure) std::rethrow_exception(failure);
+    }
+
+    // ===== Phase 1: partition =====
+
+    static void encode(const SpillRecord& r, char* out) {
+        std::memcpy(out, r.key_hash.data(), 64);
+        std::memcpy(out + 64, r.leaf_value.data(), 64);
+        for (int i = 0; i < 8; ++i) out[128 + i] = static_cast<char>((r.seq >> (i * 8)) & 0xFF);
+    }
+
+    static void decode(const char* in, SpillRecord& r) {
+        std::memcpy(r.key_hash.data(), in, 64);
+        std::memcpy(r.leaf_value.data(), in + 64, 64);
+        r.seq = 0;
+        for (int i = 0; i < 8; ++i) r.seq |= static_cast<uint64_t>(static_cast<uint8_t>(in[128 + i])) << (i * 8);
+    }
+
+    void partition() {
+        // Drop anything appended after the last checkpoint
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            auto path = spill_path(b);
+            if (!std::filesystem::exists(path)) {
+                std::ofstream(path, std::ios::binary).flush();
+            }
+            std::filesystem::resize_file(path, manifest_.spill_bytes[b]);
+        }
+
+        std::vector<std::ofstream> spills(BUCKETS);
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            spills[b].open(spill_path(b), std::ios::binary | std::ios::app);
+            if (!spills[b]) throw std::runtime_error("XookMigrator: cannot open " + spill_path(b).string());
+        }
+
+        std::vector<MigrationRecord> chunk;
+        std::vector<SpillRecord> rekeyed;
+        std::array<std::vector<char>, BUCKETS> buffers;   // One chunk's records per bucket
+        std::array<uint64_t, BUCKETS> unsynced_bytes{};   // Written since the last checkpoint
+        const size_t chunk_records = std::max<size_t>(1, options_.chunk_records);
+        const size_t slices = thread_count();
+        uint64_t since_checkpoint = 0;
+
+        // Every chunk: hand the buffers to the spill files and reuse them
+        auto write_chunk = [&] {
+            for (size_t b = 0; b < BUCKETS; ++b) {
+                if (buffers[b].empty()) continue;
+                spills[b].write(buffers[b].data(), static_cast<std::streamsize>(buffers[b].size()));
+                spills[b].flush();
+                if (!spills[b]) throw std::runtime_error("XookMigrator: spill write failed");
+                unsynced_bytes[b] += buffers[b].size();
+                buffers[b].clear();
+            }
+        };
+
+        // Every checkpoint_records: make the spills durable, then count them in the manifest
+        auto checkpoint = [&] {
+            for (size_t b = 0; b < BUCKETS; ++b) {
+                if (unsynced_bytes[b] == 0) continue;
+                sync_path(spill_path(b));
+                manifest_.spill_bytes[b] += unsynced_bytes[b];
+                unsynced_bytes[b] = 0;
+            }
+            save_manifest();
+            since_checkpoint = 0;
+        };
+
+        while (true) {
+            chunk.clear();
+            size_t n = source_->read(manifest_.cursor, chunk_records, chunk);
+            if (n == 0) break;
+
+            // Re-key in parallel: two BLAKE3 calls per record dominate this phase
+            rekeyed.resize(n);
+            const uint64_t base_seq = manifest_.cursor;
+            const size_t per_slice = (n + slices - 1) / slices;
+            parallel_for(slices, [&](size_t s) {
+                size_t end = std::min(n, (s + 1) * per_slice);
+                for (size_t i = s * per_slice; i < end; ++i) {
+                    rekeyed[i].key_hash = hash::blake3(chunk[i].key);
+                    rekeyed[i].leaf_value = leaf_value_hash(chunk[i].value_hash);
+                    rekeyed[i].seq = base_seq + i;
+                }
+            });
+
+            for (const auto& r : rekeyed) {
+                auto& buf = buffers[r.key_hash[0]];
+                size_t at = buf.size();
+                buf.resize(at + SPILL_RECORD_SIZE);
+                encode(r, buf.data() + at);
+            }
+
+            write_chunk();
+            manifest_.cursor += n;
+            since_checkpoint += n;
+            if (since_checkpoint >= options_.checkpoint_records) checkpoint();
+        }
+
+        checkpoint();
+        manifest_.partitioned = true;
+        save_manifest();
+    }
+
+    // ===== Phase 2: per-bucket sort + bottom-up build =====
+
+    [[nodiscard]] std::vector<SpillRecord> load_sorted_bucket(size_t bucket) const {
+        std::ifstream in(spill_path(bucket), std::ios::binary);
+        const uint64_t bytes = manifest_.spill_bytes[bucket];
+        if (bytes % SPILL_RECORD_SIZE != 0) throw std::runtime_error("XookMigrator: torn spill file");
+        std::vector<char> raw(bytes);
+        if (bytes > 0 && !in.read(raw.data(), static_cast<std::streamsize>(bytes))) {
+            throw std::runtime_error("XookMigrator: short read on " + spill_path(bucket).string());
+        }
+
+        const size_t n = bytes / SPILL_RECORD_SIZE;
+        std::vector<SpillRecord> records(n);
+        for (size_t i = 0; i < n; ++i) decode(raw.data() + i * SPILL_RECORD_SIZE, records[i]);
+        raw = {};
+
+        // Radix pass on byte 1 (byte 0 is the bucket), then sort each sub-bucket
+        std::array<size_t, 257> offsets{};
+        for (const auto& r : records) ++offsets[r.key_hash[1] + 1];
+        for (size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+        std::vector<SpillRecord> sorted(n);
+        std::array<size_t, 256> fill{};
+        std::copy(offsets.begin(), offsets.end() - 1, fill.begin());
+        for (auto& r : records) sorted[fill[r.key_hash[1]]++] = std::move(r);
+        records = {};
+
+        auto less = [](const SpillRecord& a, const SpillRecord& b) {
+            if (int c = std::memcmp(a.key_hash.data() + 2, b.key_hash.data() + 2, 62); c != 0) return c < 0;
+            return a.seq < b.seq;
+        };
+        for (size_t d = 0; d < 256; ++d) {
+            std::sort(sorted.begin() + offsets[d], sorted.begin() + offsets[d + 1], less);
+        }
+
+        // Last write wins: keep the highest seq of each key
+        size_t out = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (i + 1 < n && sorted[i + 1].key_hash == sorted[i].key_hash) continue;
+            if (out != i) sorted[out] = std::move(sorted[i]);
+            ++out;
+        }
+        sorted.resize(out);
+        return sorted;
+    }
+
+    /// @brief Bottom-up build over sorted unique keys sharing `base_depth` nibbles
+    ///
+    /// One open InternalNode per depth from base_depth down to the current
+    /// key's split point. A leaf's depth is one past its longest common
+    /// prefix with either neighbour; a frame is closed (hashed, written, linked
+    /// into its parent) once the next key diverges above it.
+    Subtree build_sorted(const std::vector<SpillRecord>& keys, size_t base_depth, Emitter& emitter) const {
+        Subtree result;
+        if (keys.empty()) return result;
+        if (keys.size() == 1) {
+            result.kind = Subtree::Kind::Leaf;
+            result.leaf = LeafNode{keys[0].key_hash, keys[0].leaf_value};
+            return result;
+        }
+
+        const uint64_t version = options_.version;
+        std::vector<InternalNode> open;  // open[i] is at depth base_depth + i
+        open.reserve(MAX_DEPTH);
+        auto top_depth = [&] { return static_cast<ptrdiff_t>(base_depth + open.size()) - 1; };
+
+        for (size_t i = 0; i < keys.size(); ++i) {
+            const glofica::Hash& key = keys[i].key_hash;
+            const ptrdiff_t split = i + 1 < keys.size()
+                ? static_cast<ptrdiff_t>(common_nibbles(key, keys[i + 1].key_hash))
+                : static_cast<ptrdiff_t>(base_depth) - 1;
+
+            while (top_depth() < split) open.emplace_back();
+
+            const size_t parent_depth = static_cast<size_t>(top_depth());
+            LeafNode leaf{key, keys[i].leaf_value};
+            open.back().set_child(nibble_at(key, parent_depth), leaf.hash(), version);
+            emitter.emit(NodeKey{version, path_of(key, parent_depth + 1)}, leaf);
+
+            while (!open.empty() && top_depth() > split) {
+                const size_t depth = static_cast<size_t>(top_depth());
+                InternalNode node = std::move(open.back());
+                open.pop_back();
+                glofica::Hash h = node.hash();
+                emitter.emit(NodeKey{version, path_of(key, depth)}, node);
+                if (open.empty()) {
+                    result.kind = Subtree::Kind::Internal;
+                    result.hash = h;
+                } else {
+                    open.back().set_child(nibble_at(key, depth - 1), h, version);
+                }
+            }
+        }
+        return result;
+    }
+
+    /// @brief Join up to 16 child subtrees under `path`; a lone leaf moves up instead
+    Subtree combine(const std::array<Subtree, 16>& children, const NibblePath& path, Emitter& emitter) const {
+        size_t present = 0;
+        const Subtree* only = nullptr;
+        for (const auto& c : children) {
+            if (c.kind != Subtree::Kind::Empty) {
+                ++present;
+                only = &c;
+            }
+        }
+        if (present == 0) return {};
+        if (present == 1 && only->kind == Subtree::Kind::Leaf) return *only;
+
+        InternalNode node;
+        for (uint8_t nibble = 0; nibble < 16; ++nibble) {
+            const auto& c = children[nibble];
+            if (c.kind == Subtree::Kind::Empty) continue;
+            if (c.kind == Subtree::Kind::Leaf) {
+                NodeKey leaf_key{options_.version, path};
+                leaf_key.nibble_path.push(nibble);
+                emitter.emit(std::move(leaf_key), c.leaf);
+            }
+            node.set_child(nibble, c.child_hash(), options_.version);
+        }
+        Subtree result;
+        result.kind = Subtree::Kind::Internal;
+        result.hash = node.hash();
+        emitter.emit(NodeKey{options_.version, path}, node);
+        return result;
+    }
+
+    void build(MigrationReport& report) {
+        std::vector<size_t> pending;
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            if (manifest_.buckets[b]) {
+                ++report.buckets_resumed;
+            } else {
+                pending.push_back(b);
+            }
+        }
+
+        std::mutex report_mutex;
+        parallel_for(pending.size(), [&](size_t i) {
+            const size_t bucket = pending[i];
+            auto keys = load_sorted_bucket(bucket);
+            Emitter emitter(writer_, options_.write_batch_nodes);
+            Subtree subtree = build_sorted(keys, BUCKET_DEPTH, emitter);
+            emitter.flush();  // Nodes durable before the bucket is marked done
+
+            std::lock_guard<std::mutex> lock(manifest_mutex_);
+            manifest_.buckets[bucket] = subtree;
+            save_manifest();
+            report.unique_leaves += keys.size();
+            report.internal_nodes += emitter.internal_nodes;
+            report.leaf_nodes += emitter.leaf_nodes;
+        });
+
+        // Depth 1 and root
+        Emitter emitter(writer_, options_.write_batch_nodes);
+        std::array<Subtree, 16> top;
+        for (uint8_t hi = 0; hi < 16; ++hi) {
+            std::array<Subtree, 16> children;
+            for (uint8_t lo = 0; lo < 16; ++lo) children[lo] = *manifest_.buckets[(hi << 4) | lo];
+            NibblePath path;
+            path.push(hi);
+            top[hi] = combine(children, path, emitter);
+        }
+        Subtree root = combine(top, NibblePath(), emitter);
+        if (root.kind == Subtree::Kind::Leaf) {
+            emitter.emit(NodeKey{options_.version, NibblePath()}, root.leaf);  // Single-account state
+        }
+        emitter.flush();
+        report.internal_nodes += emitter.internal_nodes;
+        report.leaf_nodes += emitter.leaf_nodes;
+
+        manifest_.root = root;
+        save_manifest();
+    }
+
+public:
+    XookMigrator(MigrationSource* source, MigrationNodeWriter* writer, Options options)
+        : source_(source), writer_(writer), options_(std::move(options)) {
+        if (!source_ || !writer_) throw std::invalid_argument("XookMigrator: source and writer are required");
+        if (options_.work_dir.empty()) throw std::invalid_argument("XookMigrator: work_dir is required");
+    }
+
+    /// @brief Run (or resume) the migration
+    /// @return Report; report.root is the XOOK root at options.version
+    /// @throws Whatever the source/writer throw; state up to the last checkpoint is kept
+    MigrationReport run() {
+        auto started = std::chrono::steady_clock::now();
+        MigrationReport report;
+
+        std::filesystem::create_directories(options_.work_dir);
+        manifest_ = Manifest{};
+        load_manifest();
+        report.records_read = manifest_.cursor;
+
+        if (!manifest_.root) {
+            if (!manifest_.partitioned) {
+                partition();
+                report.records_read = manifest_.cursor;
+            }
+            build(report);
+        }
+
+        if (manifest_.root->kind != Subtree::Kind::Empty) report.root = manifest_.root->child_hash();
+
+        if (!options_.keep_spill_files) {
+            for (size_t b = 0; b < BUCKETS; ++b) std::filesystem::remove(spill_path(b));
+        }
+
+        report.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started);
+        return report;
+    }
+};
+
+} // namespace glofica::xook
@@ -0,0 +1,148 @@
+// =========================================================
+// FILE: src/xook/xook_stats.hpp
+// PURPOSE: Pull-based adapter metrics (latency histograms + memory)
+// =========================================================
+
+#pragma once
+
+#include "latency_histogram.hpp"
+#include "memory_governor.hpp"
+#include "adaptive_cache_sizer.hpp"
+#include "change_feed.hpp"
+#include <array>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace glofica::xook {
+
+/// @brief Instrumented XookAdapter operations
+enum class AdapterOp : size_t {
+    Put = 0,
+    Get,
+    CalculateRoot,
+    CalculateRootSpeculative,
+    UpdateBatchPrecomputed,
+    StoreRead,  // TreeReader read on a cache miss (KVStore / node store)
+    Count
+};
+
+inline constexpr size_t ADAPTER_OP_COUNT = static_cast<size_t>(AdapterOp::Count);
+
+/// @brief Metric label for an operation (stable: used by dashboards)
+[[nodiscard]] constexpr std::string_view adapter_op_name(AdapterOp op) noexcept {
+    switch (op) {
+        case AdapterOp::Put:                      return "put";
+        case AdapterOp::Get:                      return "get";
+        case AdapterOp::CalculateRoot:            return "calculate_root";
+        case AdapterOp::CalculateRootSpeculative: return "calculate_root_speculative";
+        case AdapterOp::UpdateBatchPrecomputed:   return "update_batch_with_precomputed_hashes";
+        case AdapterOp::StoreRead:                return "store_read";
+        default:                                  return "unknown";
+    }
+}
+
+/// @brief Live histograms owned by the adapter (recording side)
+class AdapterMetrics {
+private:
+    std::array<LatencyHistogram, ADAPTER_OP_COUNT> latency_{};
+
+public:
+    [[nodiscard]] LatencyHistogram& latency(AdapterOp op) noexcept {
+        return latency_[static_cast<size_t>(op)];
+    }
+
+    [[nodiscard]] const LatencyHistogram& latency(AdapterOp op) const noexcept {
+        return latency_[static_cast<size_t>(op)];
+    }
+
+    void reset() noexcept {
+        for (auto& h : latency_) h.reset();
+    }
+};
+
+/// @brief Point-in-time snapshot returned by XookAdapter::stats()
+struct AdapterStats {
+    std::array<HistogramSnapshot, ADAPTER_OP_COUNT> latency;
+    MemoryUsage memory;
+    size_t memory_budget_bytes = 0;
+    size_t cache_entries = 0;
+    size_t cache_capacity = 0;
+    uint64_t cache_shrinks = 0;
+    CacheFeedback cache_feedback;
+    SizingStats cache_sizing;
+    ChangeFeedStats changes;
+    uint64_t speculative_backpressure_waits = 0;
+
+    [[nodiscard]] const HistogramSnapshot& latency_of(AdapterOp op) const noexcept {
+        return latency[static_cast<size_t>(op)];
+    }
+
+    /// @brief Prometheus text exposition format (version 0.0.4)
+    [[nodiscard]] std::string to_prometheus() const {
+        static constexpr double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+        std::string out;
+        out.reserve(4096);
+        char line[256];
+
+        out += "# HELP xook_op_latency_seconds XookAdapter operation latency\n";
+        out += "# TYPE xook_op_latency_seconds summary\n";
+        for (size_t i = 0; i < ADAPTER_OP_COUNT; ++i) {
+            const auto& h = latency[i];
+            std::string_view op = adapter_op_name(static_cast<AdapterOp>(i));
+            for (double q : QUANTILES) {
+                std::snprintf(line, sizeof(line), "xook_op_latency_seconds{op=\"%.*s\",quantile=\"%g\"} %.9f\n",
+                              static_cast<int>(op.size()), op.data(), q, h.percentile_ns(q) * 1e-9);
+                out += line;
+            }
+            std::snprintf(line, sizeof(line), "xook_op_latency_seconds_sum{op=\"%.*s\"} %.9f\n",
+                          static_cast<int>(op.size()), op.data(), static_cast<double>(h.sum_ns) * 1e-9);
+            out += line;
+            std::snprintf(line, sizeof(line), "xook_op_latency_seconds_count{op=\"%.*s\"} %llu\n",
+                          static_cast<int>(op.size()), op.data(), static_cast<unsigned long long>(h.count));
+            out += line;
+        }
+
+        out += "# HELP xook_op_latency_max_seconds Worst observed latency since start\n";
+        out += "# TYPE xook_op_latency_max_seconds gauge\n";
+        for (size_t i = 0; i < ADAPTER_OP_COUNT; ++i) {
+            std::string_view op = adapter_op_name(static_cast<AdapterOp>(i));
+            std::snprintf(line, sizeof(line), "xook_op_latency_max_seconds{op=\"%.*s\"} %.9f\n",
+                          static_cast<int>(op.size()), op.data(), static_cast<double>(latency[i].max_ns) * 1e-9);
+            out += line;
+        }
+
+        auto gauge = [&](const char* name, const char* help, unsigned long long value) {
+            std::snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s gauge\n%s %llu\n",
+                          name, help, name, name, value);
+            out += line;
+        };
+        auto counter = [&](const char* name, const char* help, unsigned long long value) {
+            std::snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+                          name, help, name, name, value);
+            out += line;
+        };
+
+        gauge("xook_cache_entries", "Nodes resident in TreeCache", cache_entries);
+        gauge("xook_memory_cache_bytes", "Approximate TreeCache bytes", memory.cache_bytes);
+        gauge("xook_memory_speculative_bytes", "Speculative overlay bytes", memory.speculative_bytes);
+        gauge("xook_memory_pending_bytes", "Pending update bytes", memory.pending_bytes);
+        gauge("xook_memory_budget_bytes", "Configured memory budget", memory_budget_bytes);
+        gauge("xook_cache_capacity", "TreeCache capacity (entries)", cache_capacity);
+        counter("xook_cache_shrinks_total", "Cache shrinks triggered by memory pressure", cache_shrinks);
+        counter("xook_cache_misses_total", "TreeCache lookups served by the TreeReader", cache_feedback.misses);
+        counter("xook_cache_ghost_hits_total", "Misses on recently evicted nodes", cache_feedback.ghost_hits);
+        if (cache_sizing.enabled) {
+            counter("xook_cache_sizing_grows_total", "Adaptive sizing grow decisions", cache_sizing.grows);
+            counter("xook_cache_sizing_shrinks_total", "Adaptive sizing shrink decisions", cache_sizing.shrinks);
+        }
+        counter("xook_speculative_backpressure_waits_total", "Speculative sessions delayed by the budget",
+                speculative_backpressure_waits);
+        gauge("xook_change_subscribers", "Registered changed-key subscribers", changes.subscribers);
+        counter("xook_change_notifications_total", "Changed-key callbacks delivered", changes.notifications);
+        counter("xook_change_callback_errors_total", "Changed-key callbacks that threw", changes.callback_errors);
+        return out;
+    }
+};
+
+} // namespace glofica::xook